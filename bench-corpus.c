@@ -0,0 +1,380 @@
+/*
+ * bench-corpus.c: Generator of the inputs the lexers are benchmarked on (see
+ * `make bench'). The output depends only on the arguments, so results from
+ * different runs, and different machines, scan the same text.
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned long rng_state;
+
+/* A 32-bit xorshift generator; unlike rand(), the same everywhere */
+static unsigned long rnd(void)
+{
+    rng_state ^= (rng_state << 13) & 0xffffffffUL;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= (rng_state << 5) & 0xffffffffUL;
+    return rng_state;
+}
+
+/* Returns a number in [0, n) */
+static int pick(int n)
+{
+    return (int) (rnd() % (unsigned long) n);
+}
+
+static const char *idents[] = {
+    "i", "j", "n", "len", "buf", "state", "next", "count", "result", "node",
+    "tmp", "start_state", "curr_buf_size", "table", "x", "y_offset"
+};
+
+static const char *c_types[] = {
+    "int", "char *", "size_t", "unsigned long", "double", "struct node *"
+};
+
+static const char *c_ops[] = {
+    " + ", " - ", " * ", " / ", " % ", " << ", " >> ", " & ", " | ", " ^ ",
+    " == ", " != ", " < ", " <= ", " && ", " || "
+};
+
+#define N_OF(a) ((int) (sizeof(a) / sizeof((a)[0])))
+
+/* Writes a C expression of about depth levels. (Here and below, what's
+ * written and the numbers picked are kept in sequence, so the output doesn't
+ * depend on the order the compiler evaluates operands in.) */
+static size_t c_expr(FILE *f, int depth)
+{
+    size_t n;
+
+    switch((depth <= 0) ? pick(3) : pick(6)) {
+    case 0:
+        return fprintf(f, "%s", idents[pick(N_OF(idents))]);
+    case 1:
+        return fprintf(f, "%d", pick(100000));
+    case 2:
+        return fprintf(f, "0x%x", pick(65536));
+    case 3:
+        n = fprintf(f, "%s[", idents[pick(N_OF(idents))]);
+        n += c_expr(f, depth - 1);
+        return n + fprintf(f, "]");
+    case 4:
+        n = fprintf(f, "(");
+        n += c_expr(f, depth - 1);
+        n += fprintf(f, "%s", c_ops[pick(N_OF(c_ops))]);
+        n += c_expr(f, depth - 1);
+        return n + fprintf(f, ")");
+    default:
+        n = fprintf(f, "%s(", idents[pick(N_OF(idents))]);
+        n += c_expr(f, depth - 1);
+        return n + fprintf(f, ", \"str %d\\n\")", pick(1000));
+    }
+}
+
+/* C-like source: functions of declarations, loops, comments and strings */
+static size_t gen_c(FILE *f)
+{
+    size_t n;
+    int i, stmts = 3 + pick(12), ret = pick(N_OF(c_types)),
+        arg = pick(N_OF(c_types)), num = pick(10000);
+
+    n = fprintf(f, "/* Function %d: does something to its arguments. */\n"
+                   "static %s fn_%d(%s a, const char *s)\n{\n",
+                num, c_types[ret], num, c_types[arg]);
+
+    for(i = 0; i < stmts; ++i) {
+        switch(pick(5)) {
+        case 0:
+            n += fprintf(f, "    %s ", c_types[pick(N_OF(c_types))]);
+            n += fprintf(f, "%s = ", idents[pick(N_OF(idents))]);
+            break;
+        case 1:
+            n += fprintf(f, "    if(");
+            n += c_expr(f, 2);
+            n += fprintf(f, ")\n  ");
+            /* Fall through to the statement it guards */
+        case 2:
+            n += fprintf(f, "    %s = ", idents[pick(N_OF(idents))]);
+            break;
+        case 3:
+            n += fprintf(f, "    for(i = 0; i < %d; ++i) // loop %d\n  ",
+                         pick(256), i);
+            n += fprintf(f, "    %s += ", idents[pick(N_OF(idents))]);
+            break;
+        default:
+            n += fprintf(f, "    return ");
+            break;
+        }
+        n += c_expr(f, 3);
+        n += fprintf(f, ";\n");
+    }
+
+    return n + fprintf(f, "}\n\n");
+}
+
+static size_t json_value(FILE *f, int depth, int indent);
+
+static size_t json_string(FILE *f)
+{
+    static const char *words[] = {
+        "alpha", "beta", "id", "name", "value", "path/to/file",
+        "\\u00e9t\\u00e9", "line\\nbreak", "quote \\\" here", "x"
+    };
+    int w = pick(N_OF(words));
+
+    return fprintf(f, "\"%s%s\"", words[w],
+                   pick(2) ? "" : words[pick(N_OF(words))]);
+}
+
+static size_t json_value(FILE *f, int depth, int indent)
+{
+    size_t n = 0;
+    int i, len, whole, frac;
+
+    switch((depth <= 0) ? pick(4) : pick(6)) {
+    case 0:
+        return json_string(f);
+    case 1:
+        return fprintf(f, "%d", pick(2000000) - 1000000);
+    case 2:
+        whole = pick(1000);
+        frac = pick(1000);
+        return fprintf(f, "%d.%de%d", whole, frac, pick(20) - 10);
+    case 3:
+        return fprintf(f, "%s", pick(3) == 0 ? "null" :
+                                pick(2) ? "true" : "false");
+    case 4:
+        len = pick(6);
+        n += fprintf(f, "[");
+        for(i = 0; i < len; ++i) {
+            n += fprintf(f, (i > 0) ? ", " : "");
+            n += json_value(f, depth - 1, indent);
+        }
+        return n + fprintf(f, "]");
+    default:
+        len = 1 + pick(5);
+        n += fprintf(f, "{");
+        for(i = 0; i < len; ++i) {
+            n += fprintf(f, "%s\n%*s", (i > 0) ? "," : "", indent + 2, "");
+            n += json_string(f);
+            n += fprintf(f, ": ");
+            n += json_value(f, depth - 1, indent + 2);
+        }
+        return n + fprintf(f, "\n%*s}", indent, "");
+    }
+}
+
+/* JSON documents, one to a line group */
+static size_t gen_json(FILE *f)
+{
+    size_t n = json_value(f, 4, 0);
+
+    return n + fprintf(f, "\n");
+}
+
+/* Web-server access logs, in the combined log format */
+static size_t gen_log(FILE *f)
+{
+    static const char *methods[] = { "GET", "GET", "GET", "POST", "HEAD" };
+    static const char *paths[] = {
+        "/", "/index.html", "/images/logo.png", "/api/v1/items",
+        "/search?q=lexer+generator&page=2", "/static/app.js"
+    };
+    static const char *agents[] = {
+        "Mozilla/5.0 (X11; Linux x86_64)", "curl/7.21.0", "Wget/1.13",
+        "Googlebot/2.1 (+http://www.google.com/bot.html)"
+    };
+    static const int statuses[] = { 200, 200, 200, 304, 404, 500 };
+    int v[12], i;
+
+    for(i = 0; i < 12; ++i)
+        v[i] = pick(100000);
+
+    return fprintf(f, "%d.%d.%d.%d - - [%02d/Mar/2012:%02d:%02d:%02d -0500] "
+                      "\"%s %s HTTP/1.1\" %d %d \"http://example.com/\" "
+                      "\"%s\"\n",
+                   1 + v[0] % 254, v[1] % 256, v[2] % 256, 1 + v[3] % 254,
+                   1 + v[4] % 28, v[5] % 24, v[6] % 60, v[7] % 60,
+                   methods[v[8] % N_OF(methods)], paths[v[9] % N_OF(paths)],
+                   statuses[v[10] % N_OF(statuses)], v[11],
+                   agents[pick(N_OF(agents))]);
+}
+
+/* Hex dumps, as from `hexdump -C' */
+static size_t gen_hex(FILE *f)
+{
+    static unsigned long offset = 0;
+    unsigned char b[16];
+    size_t n;
+    int i;
+
+    for(i = 0; i < 16; ++i)
+        b[i] = (unsigned char) pick(256);
+
+    n = fprintf(f, "%08lx ", offset);
+    for(i = 0; i < 16; ++i)
+        n += fprintf(f, (i == 8) ? "  %02x" : " %02x", b[i]);
+    n += fprintf(f, "  |");
+    for(i = 0; i < 16; ++i)
+        n += fprintf(f, "%c", (b[i] >= 0x20 && b[i] < 0x7f) ? b[i] : '.');
+
+    offset += 16;
+    return n + fprintf(f, "|\n");
+}
+
+/*
+ * Input that makes a longest-match lexer back up: lines that almost, but never
+ * quite, match a long pattern (sample03's a*b?c+d), so that each token is
+ * followed by a scan to the end of the line
+ */
+static size_t gen_adversarial(FILE *f)
+{
+    int i, len = 32 + pick(96);
+
+    for(i = 0; i < len; ++i)
+        fputc("aaaaaabc"[pick(8)], f);
+    fputc('\n', f);
+
+    return len + 1;
+}
+
+/* The worst of it, for sample02, whose .+(...)?.q only gives up at a newline
+ * (which it has no pattern for) or the end: each token is followed by a scan
+ * to the end of the input, so keep this one small */
+static size_t gen_backtrack(FILE *f)
+{
+    fputc("aaabcdi"[pick(7)], f);
+    return 1;
+}
+
+/* Reverse-Polish arithmetic for rpn, leaving its stack as it found it */
+static size_t gen_rpn(FILE *f)
+{
+    static const char ops[] = "+-*/";
+    size_t n = fprintf(f, "%d", 1 + pick(9999));
+    int i, len = 1 + pick(3), num;
+
+    for(i = 0; i < len; ++i) {
+        num = 1 + pick(999);
+        n += fprintf(f, " %d %c", num, ops[pick(4)]);
+    }
+
+    return n + fprintf(f, " p pop\n");
+}
+
+/* A lexer spec, for moonlime's own lexer; only its lexing matters, not
+ * whether moonlime could generate a lexer from it */
+static size_t gen_spec(FILE *f)
+{
+    static const char *atoms[] = {
+        "a", "[abc]", "[^\\n\"]", "(xy|z)", "\\t", "[0123456789]", ".", "q"
+    };
+    static const char *reps[] = { "", "", "*", "+", "?", "{2,5}", "{3}" };
+    static int n_rules = 0;
+    size_t n = 0;
+    int i, len;
+
+    if(n_rules++ == 0)
+        n += fprintf(f, "%%prefix Bench\n\n%%top {\n#include <stdio.h>\n}\n\n"
+                        "%%state S0\n%%state S1\n%%initstate S0\n\n");
+
+    if(pick(4) == 0)
+        n += fprintf(f, "// Rule %d\n", n_rules);
+    if(pick(3) == 0)
+        n += fprintf(f, "<S%d> ", pick(2));
+
+    len = 1 + pick(6);
+    for(i = 0; i < len; ++i) {
+        if(i > 0 && pick(3) == 0)
+            n += fprintf(f, " ");
+        n += fprintf(f, "%s", atoms[pick(N_OF(atoms))]);
+        n += fprintf(f, "%s", reps[pick(N_OF(reps))]);
+    }
+
+    n += fprintf(f, " {\n    printf(\"rule %d: %%.*s\\n\", (int) yylen, "
+                    "yytext);\n", n_rules);
+    if(pick(3) == 0) {
+        len = pick(10);
+        n += fprintf(f, "    if(yylen > %d) { YYSTART(S%d); }\n", len,
+                     pick(2));
+    }
+
+    return n + fprintf(f, "}\n\n");
+}
+
+/* Input for sample04, switching between its start states, and using only
+ * what each start state has a pattern for */
+static size_t gen_states(FILE *f)
+{
+    static char state = 'i';
+    size_t n = 0;
+    int i, len = 1 + pick(12);
+    char c;
+
+    for(i = 0; i < len; ++i) {
+        c = "abcd \t"[pick(6)];
+        if(c == 'd' && state == 'i')
+            c = 'a';
+        n += fprintf(f, "%c", c);
+    }
+
+    state = "ipq"[pick(3)];
+    return n + fprintf(f, "%c\n", state);
+}
+
+static const struct {
+    const char *name;
+    size_t (*gen)(FILE *f);
+} kinds[] = {
+    { "c", gen_c },
+    { "json", gen_json },
+    { "log", gen_log },
+    { "hex", gen_hex },
+    { "adversarial", gen_adversarial },
+    { "backtrack", gen_backtrack },
+    { "rpn", gen_rpn },
+    { "spec", gen_spec },
+    { "states", gen_states }
+};
+
+int main(int argc, char **argv)
+{
+    size_t n = 0, size;
+    int i;
+
+    if(argc < 3 || argc > 4) {
+        fputs("usage: bench-corpus kind bytes [seed]\n", stderr);
+        return 1;
+    }
+
+    size = strtoul(argv[2], NULL, 10);
+    rng_state = (argc > 3) ? strtoul(argv[3], NULL, 10) & 0xffffffffUL : 1;
+    if(rng_state == 0)
+        rng_state = 1;
+
+    for(i = 0; i < N_OF(kinds); ++i)
+        if(!strcmp(argv[1], kinds[i].name))
+            break;
+
+    if(i == N_OF(kinds)) {
+        fprintf(stderr, "Unknown corpus kind '%s'; kinds are:", argv[1]);
+        for(i = 0; i < N_OF(kinds); ++i)
+            fprintf(stderr, " %s", kinds[i].name);
+        fputc('\n', stderr);
+        return 1;
+    }
+
+    /* Whole units only, so every corpus lexes cleanly to its end */
+    while(n < size)
+        n += kinds[i].gen(stdout);
+
+    if(fflush(stdout) != 0 || ferror(stdout)) {
+        fputs("An error occurred during writing!\n", stderr);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,375 @@
+/*
+ * bench-runner.c: Driver measuring how fast a lexer scans (see `make bench').
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+/*
+ * Usage: bench-NAME [-p] name corpus [chunk...]
+ *
+ * The file corpus is read into memory and scanned in full, handed to the
+ * lexer in pieces of chunk bytes (0 meaning all at once; by default, each of
+ * 1, 16, 256, 4096 and 65536). Each pass starts a new lexer, and passes are
+ * repeated until enough time has gone by to trust the fastest one, which is
+ * reported on standard output as a line of JSON. Whatever the lexer's own
+ * actions print is thrown away.
+ *
+ * With -p, the CPU's cycles, instructions, branch misses and L1 data and
+ * last-level cache misses are counted (with Linux's perf_event_open, in user
+ * mode only, so no special privileges are needed) over each pass after the
+ * first, and their averages reported per pass, per byte and per token. A
+ * counter the kernel or CPU doesn't provide is reported as null.
+ *
+ * The lexer is compiled with -include bench.h, so its tokens can be counted;
+ * its prefix is BENCH_PREFIX (Sample by default), or, if BENCH_SPEC is
+ * defined, it is moonlime's own lexer.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#ifdef BENCH_SPEC
+#include "mllexgen.h"
+#endif
+
+/* The least time, and number of passes, to spend on each chunk size */
+#define MIN_SECONDS 0.25
+#define MIN_PASSES 3
+#define MAX_PASSES 10000
+
+unsigned long bench_tokens = 0;
+
+#define N_COUNTERS 5
+
+static const char *counter_names[N_COUNTERS] = {
+    "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses"
+};
+
+/* The hardware counters' file descriptors (-1 where not available), and
+ * their totals over the passes counted */
+static int counter_fds[N_COUNTERS];
+static double counter_sums[N_COUNTERS];
+
+#ifdef BENCH_SPEC
+/* The spec being read piles up in here; a new one is started each pass */
+static lexer_lexer_state spec;
+
+static void * lexer_init(void)
+{
+    init_lexer_lexer_state(&spec);
+    return MoonlimeInit(malloc, free);
+}
+
+static int lexer_read(void *lexer, char *input, size_t len)
+{
+    return MoonlimeRead(lexer, input, len, &spec);
+}
+
+static void lexer_destroy(void *lexer)
+{
+    MoonlimeDestroy(lexer);
+    free_lexer_lexer_state(&spec);
+}
+#else
+#ifndef BENCH_PREFIX
+#define BENCH_PREFIX Sample
+#endif
+
+#define BENCH_CAT(a, b) a ## b
+#define BENCH_FN(prefix, f) BENCH_CAT(prefix, f)
+
+extern void * BENCH_FN(BENCH_PREFIX, Init)( void * (*alloc)(size_t),
+                                            void (*unalloc)(void *) );
+extern void BENCH_FN(BENCH_PREFIX, Destroy)( void *lexer );
+extern int BENCH_FN(BENCH_PREFIX, Read)( void *lexer, char *input,
+                                         size_t len );
+
+static void * lexer_init(void)
+{
+    return BENCH_FN(BENCH_PREFIX, Init)(malloc, free);
+}
+
+static int lexer_read(void *lexer, char *input, size_t len)
+{
+    return BENCH_FN(BENCH_PREFIX, Read)(lexer, input, len);
+}
+
+static void lexer_destroy(void *lexer)
+{
+    BENCH_FN(BENCH_PREFIX, Destroy)(lexer);
+}
+#endif
+
+/* Opens the hardware counters, returning how many could be */
+static int counters_open(void)
+{
+    int i, n = 0;
+#ifdef __linux__
+    static const struct {
+        unsigned type;
+        unsigned long long config;
+    } events[N_COUNTERS] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) }
+    };
+    struct perf_event_attr attr;
+
+    for(i = 0; i < N_COUNTERS; ++i) {
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events[i].type;
+        attr.config = events[i].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        /* If there are more counters than the CPU has registers for, the
+         * kernel takes turns with them; these say how to scale up */
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        counter_fds[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        if(counter_fds[i] >= 0)
+            ++n;
+    }
+#else
+    for(i = 0; i < N_COUNTERS; ++i)
+        counter_fds[i] = -1;
+#endif
+
+    return n;
+}
+
+static void counters_start(void)
+{
+#ifdef __linux__
+    int i;
+
+    for(i = 0; i < N_COUNTERS; ++i) {
+        if(counter_fds[i] < 0)
+            continue;
+        ioctl(counter_fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+/* Stops the counters, and adds what they counted to counter_sums */
+static void counters_stop(void)
+{
+#ifdef __linux__
+    unsigned long long v[3]; /* Count, time enabled, time running */
+    int i;
+
+    for(i = 0; i < N_COUNTERS; ++i) {
+        if(counter_fds[i] < 0)
+            continue;
+        ioctl(counter_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+        if(read(counter_fds[i], v, sizeof(v)) != sizeof(v) || v[2] == 0) {
+            /* Never got a turn on the CPU; give up on it */
+            close(counter_fds[i]);
+            counter_fds[i] = -1;
+            continue;
+        }
+        counter_sums[i] += (double) v[0] * v[1] / v[2];
+    }
+#endif
+}
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Reads all of the file name into *buf, returning its length */
+static size_t read_corpus(const char *name, char **buf)
+{
+    FILE *f;
+    size_t len = 0, size = 65536, n;
+
+    if((f = fopen(name, "rb")) == NULL) {
+        fprintf(stderr, "Couldn\'t open file \'%s\'\n", name);
+        exit(1);
+    }
+
+    if((*buf = malloc(size)) == NULL) {
+        fputs("Out of memory!\n", stderr);
+        exit(1);
+    }
+
+    while((n = fread(*buf + len, 1, size - len, f)) > 0) {
+        len += n;
+        if(len == size && (*buf = realloc(*buf, size *= 2)) == NULL) {
+            fputs("Out of memory!\n", stderr);
+            exit(1);
+        }
+    }
+
+    if(ferror(f)) {
+        fputs("An error occurred during reading!\n", stderr);
+        exit(1);
+    }
+
+    fclose(f);
+    return len;
+}
+
+/* Scans all len bytes of buf, chunk at a time, counting the hardware events
+ * if count; returns the time it took */
+static double run_pass(char *buf, size_t len, size_t chunk, int count)
+{
+    double start;
+    void *lexer;
+    size_t i, n;
+
+    if(count)
+        counters_start();
+
+    start = now();
+    lexer = lexer_init();
+
+    if(lexer == NULL) {
+        fputs("Unable to initialize lexer!\n", stderr);
+        exit(1);
+    }
+
+    for(i = 0; i < len; i += n) {
+        n = (chunk == 0 || len - i < chunk) ? len - i : chunk;
+        if(!lexer_read(lexer, buf + i, n)) {
+            fprintf(stderr, "An error occurred during lexing, near byte %lu!\n",
+                    (unsigned long) i);
+            exit(1);
+        }
+    }
+
+    if(!lexer_read(lexer, NULL, 0)) {
+        fputs("An error occurred during lexing near EOF!\n", stderr);
+        exit(1);
+    }
+
+    lexer_destroy(lexer);
+    start = now() - start;
+
+    if(count)
+        counters_stop();
+
+    return start;
+}
+
+int main(int argc, char **argv)
+{
+    static const char *default_chunks[] = {
+        "1", "16", "256", "4096", "65536"
+    };
+    const char **chunks = default_chunks;
+    int n_chunks = 5, i, j, passes, perf = 0;
+    double t, best, total;
+    unsigned long tokens;
+    size_t len, chunk;
+    char *buf;
+    FILE *out;
+
+    if(argc > 1 && !strcmp(argv[1], "-p")) {
+        perf = 1;
+        ++argv;
+        --argc;
+    }
+
+    if(argc < 3) {
+        fputs("usage: bench-runner [-p] name corpus [chunk...]\n", stderr);
+        return 1;
+    }
+
+    if(argc > 3) {
+        chunks = (const char **) argv + 3;
+        n_chunks = argc - 3;
+    }
+
+    len = read_corpus(argv[2], &buf);
+
+    if(perf && counters_open() == 0)
+        fputs("No hardware counters could be opened (see "
+              "/proc/sys/kernel/perf_event_paranoid); they'll be null\n",
+              stderr);
+
+    /* The results go where standard output went; the actions' output, to
+     * /dev/null */
+    fflush(stdout);
+    if((out = fdopen(dup(1), "w")) == NULL ||
+       freopen("/dev/null", "w", stdout) == NULL) {
+        fputs("Couldn\'t redirect standard output\n", stderr);
+        return 1;
+    }
+
+    for(i = 0; i < n_chunks; ++i) {
+        chunk = strtoul(chunks[i], NULL, 10);
+
+        /* One pass to warm up, and to count the tokens */
+        bench_tokens = 0;
+        best = run_pass(buf, len, chunk, 0);
+        tokens = bench_tokens;
+
+        for(j = 0; j < N_COUNTERS; ++j)
+            counter_sums[j] = 0;
+
+        for(passes = 1, total = best; passes < MAX_PASSES &&
+            (passes < MIN_PASSES || total < MIN_SECONDS); ++passes) {
+            total += (t = run_pass(buf, len, chunk, perf));
+            if(t < best)
+                best = t;
+        }
+
+        if(best <= 0)
+            best = 1e-9;
+
+        fprintf(out, "{\"lexer\": \"%s\", \"corpus\": \"%s\", \"bytes\": %lu, "
+                     "\"chunk\": %lu, \"passes\": %d, \"seconds\": %.6f, "
+                     "\"tokens\": %lu, \"mb_per_s\": %.2f, "
+                     "\"tokens_per_s\": %.0f, \"ns_per_token\": %.2f",
+                argv[1], argv[2], (unsigned long) len, (unsigned long) chunk,
+                passes, best, tokens, len / best / 1e6, tokens / best,
+                (tokens > 0) ? best * 1e9 / tokens : 0.0);
+
+        if(perf) {
+            fputs(", \"perf\": {", out);
+            for(j = 0; j < N_COUNTERS; ++j) {
+                fprintf(out, "%s\"%s\": ", (j > 0) ? ", " : "",
+                        counter_names[j]);
+                if(counter_fds[j] < 0) {
+                    fputs("null", out);
+                    continue;
+                }
+                t = counter_sums[j] / (passes - 1);
+                fprintf(out, "{\"per_pass\": %.0f, \"per_byte\": %.4f, "
+                             "\"per_token\": %.4f}", t, t / len,
+                        (tokens > 0) ? t / tokens : 0.0);
+            }
+            fputc('}', out);
+        }
+
+        fputs("}\n", out);
+        fflush(out);
+    }
+
+    free(buf);
+    return 0;
+}
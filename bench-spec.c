@@ -0,0 +1,199 @@
+/*
+ * bench-spec.c: Generator of the lexer specs moonlime itself is timed on (see
+ * `make bench-gen'). Each spec grows along one dimension with n, so that
+ * timing moonlime across a range of n shows how it scales.
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned long rng_state;
+
+/* A 32-bit xorshift generator, as in bench-corpus.c */
+static unsigned long rnd(void)
+{
+    rng_state ^= (rng_state << 13) & 0xffffffffUL;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= (rng_state << 5) & 0xffffffffUL;
+    return rng_state;
+}
+
+/* Returns a number in [0, n) */
+static int pick(int n)
+{
+    return (int) (rnd() % (unsigned long) n);
+}
+
+#define N_OF(a) ((int) (sizeof(a) / sizeof((a)[0])))
+
+#define IDENT_START "abcdefghijklmnopqrstuvwxyz_"
+#define IDENT_REST IDENT_START "0123456789"
+
+/* Writes the i'th of a set of distinct words: a few random letters, then i
+ * in base 26 */
+static void word(FILE *f, int i)
+{
+    int len = 2 + pick(6);
+
+    while(len-- > 0)
+        fputc('a' + pick(26), f);
+
+    do {
+        fputc('a' + i % 26, f);
+        i /= 26;
+    } while(i > 0);
+}
+
+/* One identifier pattern with n keywords, looked up in a perfect hash */
+static void gen_keywords(FILE *f, int n)
+{
+    int i;
+
+    fputs("%keywords {\n", f);
+    for(i = 0; i < n; ++i) {
+        fputs("    ", f);
+        word(f, i);
+        fprintf(f, " { kw = %d; }\n", i);
+    }
+    fputs("}\n[" IDENT_START "][" IDENT_REST "]* { kw = -1; }\n\n", f);
+}
+
+/* n literal words, each a pattern of its own, and an identifier pattern
+ * behind them: what %keywords saves the DFA from */
+static void gen_literals(FILE *f, int n)
+{
+    int i;
+
+    for(i = 0; i < n; ++i) {
+        word(f, i);
+        fprintf(f, " { kw = %d; }\n", i);
+    }
+    fputs("[" IDENT_START "][" IDENT_REST "]* { kw = -1; }\n\n", f);
+}
+
+/* n start states, each with patterns of its own and some of the others' */
+static void gen_states(FILE *f, int n)
+{
+    int i, j, len;
+
+    for(i = 0; i < n; ++i)
+        fprintf(f, "%%state S%d\n", i);
+    fputs("%initstate S0\n\n", f);
+
+    for(i = 0; i < n; ++i) {
+        fprintf(f, "<S%d> ", i);
+        word(f, i);
+        fprintf(f, "[abc]+ { YYSTART(S%d); }\n", (i + 1) % n);
+
+        /* A pattern active in a handful of states */
+        len = 1 + pick(4);
+        fprintf(f, "<S%d", i);
+        for(j = 1; j < len; ++j)
+            fprintf(f, ",S%d", pick(n));
+        fputs("> ", f);
+        word(f, n + i);
+        fputs("[0123456789]* { ; }\n", f);
+    }
+    fputs("[ \\t\\n]+ { ; }\n\n", f);
+}
+
+/* Counted repetitions bounded by n, which are written out as copies of what
+ * they repeat */
+static void gen_repeat(FILE *f, int n)
+{
+    fprintf(f, "[0123456789abcdef]{%d} { ; }\n", n);
+    fprintf(f, "x{1,%d} { ; }\n", n);
+    fprintf(f, "(ab|c){%d,%d} { ; }\n", (n + 1) / 2, n);
+    fprintf(f, "q[xyz]{%d,}q { ; }\n\n", n / 4);
+}
+
+/* n patterns starting with a pair of character classes of random bytes, each
+ * holding about half the printable characters, so that the classes overlap
+ * in many ways, and the DFA's transitions split the bytes into many classes.
+ * (Repeating them with + instead makes the DFA grow exponentially in n.) */
+static void gen_classes(FILE *f, int n)
+{
+    int i, j, c;
+
+    for(i = 0; i < n; ++i) {
+        for(j = 0; j < 2; ++j) {
+            fputs("[", f);
+            for(c = 0x20; c < 0x7f; ++c)
+                if(pick(2))
+                    fprintf(f, "\\x%02x", c);
+            fputs("]", f);
+        }
+        word(f, i);
+        fputs(" { ; }\n", f);
+    }
+    fputs(".|\\n { ; }\n\n", f);
+}
+
+/* n patterns of the form start.*end, each of which, once started, stays live
+ * to the end of the input, alongside whatever else is matching */
+static void gen_dotstar(FILE *f, int n)
+{
+    int i;
+
+    for(i = 0; i < n; ++i) {
+        word(f, i);
+        fputs(".*", f);
+        word(f, n + i);
+        fputs(" { ; }\n", f);
+    }
+    fputs(".|\\n { ; }\n\n", f);
+}
+
+static const struct {
+    const char *name;
+    void (*gen)(FILE *f, int n);
+} dims[] = {
+    { "keywords", gen_keywords },
+    { "literals", gen_literals },
+    { "states", gen_states },
+    { "repeat", gen_repeat },
+    { "classes", gen_classes },
+    { "dotstar", gen_dotstar }
+};
+
+int main(int argc, char **argv)
+{
+    int i, n;
+
+    if(argc < 3 || argc > 4) {
+        fputs("usage: bench-spec dimension n [seed]\n", stderr);
+        return 1;
+    }
+
+    n = atoi(argv[2]);
+    rng_state = (argc > 3) ? strtoul(argv[3], NULL, 10) & 0xffffffffUL : 1;
+    if(rng_state == 0)
+        rng_state = 1;
+
+    for(i = 0; i < N_OF(dims); ++i)
+        if(!strcmp(argv[1], dims[i].name))
+            break;
+
+    if(i == N_OF(dims) || n < 1) {
+        fprintf(stderr, "usage: bench-spec dimension n [seed], with n > 0 "
+                        "and dimension one of:");
+        for(i = 0; i < N_OF(dims); ++i)
+            fprintf(stderr, " %s", dims[i].name);
+        fputc('\n', stderr);
+        return 1;
+    }
+
+    printf("// A %s spec for timing moonlime, with n = %d\n\n"
+           "%%prefix Gen\n\n%%top {\nstatic int kw;\n}\n\n", argv[1], n);
+    dims[i].gen(stdout, n);
+
+    if(fflush(stdout) != 0 || ferror(stdout)) {
+        fputs("An error occurred during writing!\n", stderr);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,15 @@
+/*
+ * bench.h: Included (with -include) in the lexers built for benchmarking, to
+ * count the tokens they match (see bench-runner.c).
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#ifndef ML_BENCH_H
+#define ML_BENCH_H
+
+extern unsigned long bench_tokens;
+
+#define YY_ON_ACTION(done_num) (++bench_tokens)
+
+#endif
@@ -0,0 +1,883 @@
+/*
+ * deriv.c: Building DFAs directly from regexes with Brzozowski derivatives.
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#include "deriv.h"
+
+#ifndef ML_STDLIB_H
+#define ML_STDLIB_H
+#include <stdlib.h>
+#endif
+
+#ifndef ML_STRING_H
+#define ML_STRING_H
+#include <string.h>
+#endif
+
+#ifndef ML_UTILS_H
+#include "utils.h"
+#endif
+
+#ifndef ML_REGEX_H
+#include "regex.h"
+#endif
+
+/*
+ * The derivative of a regex r with respect to a character c is a regex
+ * matching { s | cs is matched by r }. Starting from the patterns' regexes and
+ * repeatedly taking derivatives gives the states of a DFA; to keep the number
+ * of distinct derivatives finite (and small), terms are built only through
+ * "smart constructors" that normalize them (e.g. alternations are flattened,
+ * sorted, and deduplicated, and {} and the empty string are simplified away),
+ * and are hash-consed, so two terms are equal exactly when their ids are.
+ * Counted repetitions are kept as terms of their own, so r{n,m} is never
+ * unrolled into n or m copies of r.
+ */
+
+typedef enum {
+    DT_EMPTY, /* Matches nothing */
+    DT_EPS,   /* Matches only the empty string */
+    DT_SET,   /* Matches any single character in a set */
+    DT_CAT,   /* Matches a followed by b */
+    DT_ALT,   /* Matches any of the kids */
+    DT_STAR,  /* Matches zero or more of a */
+    DT_REP    /* Matches between min and max (-1: no limit) repetitions of a */
+} dterm_kind;
+
+typedef struct {
+    dterm_kind kind;
+    int nullable;   /* Does this term match the empty string? */
+    unsigned int hash;
+
+    unsigned int set[CLASS_SZ]; /* DT_SET */
+    int a, b;       /* Sub-terms (DT_CAT, DT_STAR, DT_REP) */
+    int min, max;   /* DT_REP */
+    int n_kids;     /* DT_ALT */
+    int *kids;      /* DT_ALT; sorted by id, no duplicates */
+} dterm_t;
+
+/* A table of hash-consed terms, along with the derivative cache */
+typedef struct {
+    dterm_t **terms;  /* Indexed by term id */
+    int n_terms;
+    int terms_sz;
+
+    int *hash;        /* Open-addressed table of term ids (-1 = free) */
+    int hash_sz;      /* A power of two */
+
+    int *dcache_key;  /* Open-addressed derivative cache: a (term, class) */
+    int *dcache_val;  /* pair maps to the term id of the derivative */
+    int dcache_sz;    /* A power of two */
+    int dcache_n;
+
+    int cls[256];     /* The equivalence class of each character */
+    int cls_rep[256]; /* A representative character for each class */
+    int n_cls;
+} dctx_t;
+
+/* Term ids of the two constant terms */
+#define T_EMPTY 0
+#define T_EPS 1
+
+static unsigned int mix(unsigned int h, unsigned int x)
+{
+    h ^= x + 0x9e3779b9u + (h << 6) + (h >> 2);
+    return h;
+}
+
+static unsigned int term_hash(const dterm_t *t)
+{
+    unsigned int h = mix(0, t->kind);
+    int i;
+
+    switch(t->kind) {
+      case DT_SET:
+        for(i = 0; i < CLASS_SZ; ++i)
+            h = mix(h, t->set[i]);
+        break;
+
+      case DT_ALT:
+        for(i = 0; i < t->n_kids; ++i)
+            h = mix(h, t->kids[i]);
+        break;
+
+      default:
+        h = mix(mix(mix(mix(h, t->a), t->b), t->min), t->max);
+    }
+
+    return h;
+}
+
+static int term_eq(const dterm_t *x, const dterm_t *y)
+{
+    if(x->kind != y->kind || x->hash != y->hash)
+        return 0;
+
+    switch(x->kind) {
+      case DT_SET:
+        return !memcmp(x->set, y->set, sizeof(x->set));
+
+      case DT_ALT:
+        return x->n_kids == y->n_kids &&
+               !memcmp(x->kids, y->kids, x->n_kids * sizeof(int));
+
+      default:
+        return x->a == y->a && x->b == y->b && x->min == y->min &&
+               x->max == y->max;
+    }
+}
+
+static void grow_term_hash(dctx_t *ctx)
+{
+    int i, j, mask;
+
+    free(ctx->hash);
+    ctx->hash_sz *= 2;
+    ctx->hash = malloc_or_die(ctx->hash_sz, int);
+    mask = ctx->hash_sz - 1;
+
+    for(i = 0; i < ctx->hash_sz; ++i)
+        ctx->hash[i] = -1;
+
+    for(i = 0; i < ctx->n_terms; ++i) {
+        for(j = ctx->terms[i]->hash & mask; ctx->hash[j] != -1;
+            j = (j + 1) & mask)
+            ;
+        ctx->hash[j] = i;
+    }
+}
+
+/* Returns the id of the term equal to *t, adding a copy of *t (which takes
+ * over t->kids) to the table if there isn't one already. */
+static int intern(dctx_t *ctx, dterm_t *t)
+{
+    int i, mask;
+    dterm_t *nt;
+
+    t->hash = term_hash(t);
+
+    switch(t->kind) {
+      case DT_EMPTY:
+      case DT_SET:
+        t->nullable = 0;
+        break;
+      case DT_EPS:
+      case DT_STAR:
+        t->nullable = 1;
+        break;
+      case DT_CAT:
+        t->nullable = ctx->terms[t->a]->nullable &&
+                      ctx->terms[t->b]->nullable;
+        break;
+      case DT_ALT:
+        t->nullable = 0;
+        for(i = 0; i < t->n_kids; ++i)
+            t->nullable |= ctx->terms[t->kids[i]]->nullable;
+        break;
+      case DT_REP:
+        t->nullable = t->min == 0 || ctx->terms[t->a]->nullable;
+        break;
+    }
+
+    mask = ctx->hash_sz - 1;
+    for(i = t->hash & mask; ctx->hash[i] != -1; i = (i + 1) & mask) {
+        if(term_eq(ctx->terms[ctx->hash[i]], t)) {
+            free(t->kids);
+            return ctx->hash[i];
+        }
+    }
+
+    if(ctx->n_terms >= ctx->terms_sz) {
+        dterm_t **new_terms;
+
+        ctx->terms_sz *= 2;
+        new_terms = malloc_or_die(ctx->terms_sz, dterm_t *);
+        memcpy(new_terms, ctx->terms, ctx->n_terms * sizeof(dterm_t *));
+        free(ctx->terms);
+        ctx->terms = new_terms;
+    }
+
+    nt = malloc_or_die(1, dterm_t);
+    *nt = *t;
+    ctx->terms[ctx->n_terms] = nt;
+    ctx->hash[i] = ctx->n_terms;
+
+    if(++ctx->n_terms * 2 > ctx->hash_sz)
+        grow_term_hash(ctx);
+
+    return ctx->n_terms - 1;
+}
+
+static void blank_term(dterm_t *t, dterm_kind kind)
+{
+    memset(t, 0, sizeof(*t));
+    t->kind = kind;
+    t->kids = NULL;
+}
+
+/* The smart constructors: */
+
+static int mk_set(dctx_t *ctx, const unsigned int *set)
+{
+    dterm_t t;
+    int i, nonempty = 0;
+
+    for(i = 0; i < CLASS_SZ; ++i)
+        nonempty |= set[i] != 0;
+    if(!nonempty)
+        return T_EMPTY;
+
+    blank_term(&t, DT_SET);
+    memcpy(t.set, set, sizeof(t.set));
+    return intern(ctx, &t);
+}
+
+static int mk_cat(dctx_t *ctx, int a, int b)
+{
+    dterm_t t;
+    const dterm_t *ta = ctx->terms[a];
+
+    if(a == T_EMPTY || b == T_EMPTY)
+        return T_EMPTY;
+    if(a == T_EPS)
+        return b;
+    if(b == T_EPS)
+        return a;
+
+    /* Keep concatenations right-associated: (xy)b = x(yb) */
+    if(ta->kind == DT_CAT)
+        return mk_cat(ctx, ta->a, mk_cat(ctx, ta->b, b));
+
+    blank_term(&t, DT_CAT);
+    t.a = a;
+    t.b = b;
+    return intern(ctx, &t);
+}
+
+static int int_cmp(const void *a, const void *b)
+{
+    int x = *((const int *) a), y = *((const int *) b);
+
+    return (x > y) - (x < y);
+}
+
+/* A growable list of term ids */
+typedef struct {
+    int *ids;
+    int n;
+    int array_sz;
+} id_list_t;
+
+static void id_add(id_list_t *l, int id)
+{
+    int *new_ids;
+
+    if(l->n >= l->array_sz) {
+        l->array_sz = l->array_sz * 2 + 8;
+        new_ids = malloc_or_die(l->array_sz, int);
+        if(l->n > 0)
+            memcpy(new_ids, l->ids, l->n * sizeof(int));
+        free(l->ids);
+        l->ids = new_ids;
+    }
+
+    l->ids[l->n++] = id;
+}
+
+/* Adds the term id to the alternation being built in l, flattening nested
+ * alternations and merging single-character sets into *set */
+static void alt_collect(dctx_t *ctx, id_list_t *l, unsigned int *set, int id)
+{
+    const dterm_t *t = ctx->terms[id];
+    int i;
+
+    switch(t->kind) {
+      case DT_EMPTY:
+        break;
+
+      case DT_ALT:
+        for(i = 0; i < t->n_kids; ++i)
+            alt_collect(ctx, l, set, t->kids[i]);
+        break;
+
+      case DT_SET:
+        for(i = 0; i < CLASS_SZ; ++i)
+            set[i] |= t->set[i];
+        break;
+
+      default:
+        id_add(l, id);
+    }
+}
+
+/* Builds the alternation of the n terms in ids */
+static int mk_alt(dctx_t *ctx, const int *ids, int n)
+{
+    id_list_t l = { NULL, 0, 0 };
+    unsigned int set[CLASS_SZ];
+    dterm_t t;
+    int i, j, s;
+
+    memset(set, 0, sizeof(set));
+    for(i = 0; i < n; ++i)
+        alt_collect(ctx, &l, set, ids[i]);
+
+    if((s = mk_set(ctx, set)) != T_EMPTY)
+        id_add(&l, s);
+
+    if(l.n == 0) {
+        free(l.ids);
+        return T_EMPTY;
+    }
+
+    qsort(l.ids, l.n, sizeof(int), int_cmp);
+    for(i = j = 1; i < l.n; ++i)
+        if(l.ids[i] != l.ids[j-1])
+            l.ids[j++] = l.ids[i];
+    l.n = j;
+
+    if(l.n == 1) {
+        i = l.ids[0];
+        free(l.ids);
+        return i;
+    }
+
+    /* (eps | x) where x is nullable is just x */
+    if(l.n == 2 && l.ids[0] == T_EPS && ctx->terms[l.ids[1]]->nullable) {
+        i = l.ids[1];
+        free(l.ids);
+        return i;
+    }
+
+    blank_term(&t, DT_ALT);
+    t.n_kids = l.n;
+    t.kids = l.ids;
+    return intern(ctx, &t);
+}
+
+static int mk_alt2(dctx_t *ctx, int a, int b)
+{
+    int ids[2];
+
+    ids[0] = a;
+    ids[1] = b;
+    return mk_alt(ctx, ids, 2);
+}
+
+static int mk_star(dctx_t *ctx, int a)
+{
+    dterm_t t;
+
+    if(a == T_EMPTY || a == T_EPS)
+        return T_EPS;
+    if(ctx->terms[a]->kind == DT_STAR)
+        return a;
+
+    blank_term(&t, DT_STAR);
+    t.a = a;
+    return intern(ctx, &t);
+}
+
+/* min >= 0; max == -1 means no upper bound */
+static int mk_rep(dctx_t *ctx, int a, int min, int max)
+{
+    dterm_t t;
+
+    if(max == 0 || a == T_EPS)
+        return T_EPS;
+    if(a == T_EMPTY)
+        return (min == 0) ? T_EPS : T_EMPTY;
+    if(min == 0 && max == -1)
+        return mk_star(ctx, a);
+    if(min == 1 && max == 1)
+        return a;
+
+    blank_term(&t, DT_REP);
+    t.a = a;
+    t.min = min;
+    t.max = max;
+    return intern(ctx, &t);
+}
+
+/* Converts a regex tree into a term */
+static int regex_to_term(dctx_t *ctx, const regex_t *rx)
+{
+    unsigned int set[CLASS_SZ];
+    int i, id, *ids;
+
+    switch(rx->type) {
+      case R_CHAR:
+      case R_CLASS:
+      case R_ANY:
+        regex_leaf_set(rx, set);
+        return mk_set(ctx, set);
+
+      case R_OPTION:
+        if(rx->data.list.n_enc == 0)
+            return T_EMPTY;
+        ids = malloc_or_die(rx->data.list.n_enc, int);
+        for(i = 0; i < rx->data.list.n_enc; ++i)
+            ids[i] = regex_to_term(ctx, rx->data.list.enc[i]);
+        id = mk_alt(ctx, ids, rx->data.list.n_enc);
+        free(ids);
+        return id;
+
+      case R_CONCAT:
+        id = T_EPS;
+        for(i = rx->data.list.n_enc - 1; i >= 0; --i)
+            id = mk_cat(ctx, regex_to_term(ctx, rx->data.list.enc[i]), id);
+        return id;
+
+      case R_MAYBE:
+        return mk_alt2(ctx, T_EPS, regex_to_term(ctx, rx->data.enc));
+
+      case R_STAR:
+        return mk_star(ctx, regex_to_term(ctx, rx->data.enc));
+
+      case R_PLUS:
+        return mk_rep(ctx, regex_to_term(ctx, rx->data.enc), 1, -1);
+
+      case R_NUM:
+        return mk_rep(ctx, regex_to_term(ctx, rx->data.num.enc),
+                      (rx->data.num.min == -1) ? 0 : rx->data.num.min,
+                      rx->data.num.max);
+
+      case R_ZERO:
+        return T_EPS;
+
+      case R_PAREN:
+        break;
+    }
+
+    fprintf(stderr, __FILE__ ":%d: R_PAREN shouldn\'t be in a regex!\n",
+            __LINE__);
+    exit(1);
+}
+
+/* Splits the character classes so that every set in every term either
+ * contains or is disjoint from each class */
+static void refine_classes(dctx_t *ctx)
+{
+    int i, c, new_cls[256], map[512];
+    const dterm_t *t;
+
+    for(c = 0; c < 256; ++c)
+        ctx->cls[c] = 0;
+    ctx->n_cls = 1;
+
+    for(i = 0; i < ctx->n_terms; ++i) {
+        t = ctx->terms[i];
+        if(t->kind != DT_SET)
+            continue;
+
+        for(c = 0; c < 2 * ctx->n_cls; ++c)
+            map[c] = -1;
+
+        ctx->n_cls = 0;
+        for(c = 0; c < 256; ++c) {
+            int in = (t->set[c / ML_UINT_BIT] >> (c % ML_UINT_BIT)) & 1;
+            int k = ctx->cls[c] * 2 + in;
+
+            if(map[k] == -1)
+                map[k] = ctx->n_cls++;
+            new_cls[c] = map[k];
+        }
+
+        memcpy(ctx->cls, new_cls, sizeof(new_cls));
+    }
+
+    for(c = 255; c >= 0; --c)
+        ctx->cls_rep[ctx->cls[c]] = c;
+}
+
+/* Returns the derivative of term id with respect to the characters of class
+ * cls (all of which give the same derivative) */
+static int derive(dctx_t *ctx, int id, int cls)
+{
+    const dterm_t *t = ctx->terms[id];
+    int c = ctx->cls_rep[cls];
+    int i, mask, key, d, *ids;
+
+    switch(t->kind) {
+      case DT_EMPTY:
+      case DT_EPS:
+        return T_EMPTY;
+
+      case DT_SET:
+        return ((t->set[c / ML_UINT_BIT] >> (c % ML_UINT_BIT)) & 1) ? T_EPS
+                                                                  : T_EMPTY;
+      default:
+        ;
+    }
+
+    key = id * ctx->n_cls + cls;
+    mask = ctx->dcache_sz - 1;
+    for(i = ((unsigned int) key * 2654435761u) & mask;
+        ctx->dcache_key[i] != -1; i = (i + 1) & mask)
+        if(ctx->dcache_key[i] == key)
+            return ctx->dcache_val[i];
+
+    switch(t->kind) {
+      case DT_CAT:
+        d = mk_cat(ctx, derive(ctx, t->a, cls), t->b);
+        if(ctx->terms[t->a]->nullable)
+            d = mk_alt2(ctx, d, derive(ctx, t->b, cls));
+        break;
+
+      case DT_ALT:
+        ids = malloc_or_die(t->n_kids, int);
+        for(i = 0; i < t->n_kids; ++i)
+            ids[i] = derive(ctx, t->kids[i], cls);
+        d = mk_alt(ctx, ids, t->n_kids);
+        free(ids);
+        break;
+
+      case DT_STAR:
+        d = mk_cat(ctx, derive(ctx, t->a, cls), id);
+        break;
+
+      case DT_REP:
+        /* r{m,n} = r r{m-1,n-1}; if r is nullable, the derivative of the
+         * second factor is subsumed by that of the first */
+        d = mk_cat(ctx, derive(ctx, t->a, cls),
+                   mk_rep(ctx, t->a, (t->min > 0) ? t->min - 1 : 0,
+                          (t->max == -1) ? -1 : t->max - 1));
+        break;
+
+      default:
+        d = T_EMPTY;
+    }
+
+    /* Insert into the cache (the recursive calls may have grown it) */
+    if((ctx->dcache_n + 1) * 2 > ctx->dcache_sz) {
+        int *old_key = ctx->dcache_key, *old_val = ctx->dcache_val;
+        int old_sz = ctx->dcache_sz, j;
+
+        ctx->dcache_sz *= 2;
+        ctx->dcache_key = malloc_or_die(ctx->dcache_sz, int);
+        ctx->dcache_val = malloc_or_die(ctx->dcache_sz, int);
+        for(i = 0; i < ctx->dcache_sz; ++i)
+            ctx->dcache_key[i] = -1;
+
+        mask = ctx->dcache_sz - 1;
+        for(j = 0; j < old_sz; ++j) {
+            if(old_key[j] == -1)
+                continue;
+            for(i = ((unsigned int) old_key[j] * 2654435761u) & mask;
+                ctx->dcache_key[i] != -1; i = (i + 1) & mask)
+                ;
+            ctx->dcache_key[i] = old_key[j];
+            ctx->dcache_val[i] = old_val[j];
+        }
+
+        free(old_key);
+        free(old_val);
+    }
+
+    mask = ctx->dcache_sz - 1;
+    for(i = ((unsigned int) key * 2654435761u) & mask;
+        ctx->dcache_key[i] != -1; i = (i + 1) & mask)
+        ;
+    ctx->dcache_key[i] = key;
+    ctx->dcache_val[i] = d;
+    ++ctx->dcache_n;
+
+    return d;
+}
+
+static void init_ctx(dctx_t *ctx)
+{
+    dterm_t t;
+    int i;
+
+    ctx->terms_sz = 64;
+    ctx->terms = malloc_or_die(ctx->terms_sz, dterm_t *);
+    ctx->n_terms = 0;
+
+    ctx->hash_sz = 128;
+    ctx->hash = malloc_or_die(ctx->hash_sz, int);
+    for(i = 0; i < ctx->hash_sz; ++i)
+        ctx->hash[i] = -1;
+
+    ctx->dcache_sz = 1024;
+    ctx->dcache_n = 0;
+    ctx->dcache_key = malloc_or_die(ctx->dcache_sz, int);
+    ctx->dcache_val = malloc_or_die(ctx->dcache_sz, int);
+    for(i = 0; i < ctx->dcache_sz; ++i)
+        ctx->dcache_key[i] = -1;
+
+    blank_term(&t, DT_EMPTY);
+    intern(ctx, &t); /* T_EMPTY */
+    blank_term(&t, DT_EPS);
+    intern(ctx, &t); /* T_EPS */
+}
+
+static void free_ctx(dctx_t *ctx)
+{
+    int i;
+
+    for(i = 0; i < ctx->n_terms; ++i) {
+        free(ctx->terms[i]->kids);
+        free(ctx->terms[i]);
+    }
+
+    free(ctx->terms);
+    free(ctx->hash);
+    free(ctx->dcache_key);
+    free(ctx->dcache_val);
+}
+
+/* The DFA states built so far, each a vector of n_rx term ids */
+typedef struct {
+    int n_rx;
+    int *vecs;         /* n_states * n_rx term ids */
+    state_t **states;  /* The DFA state for each vector */
+    int *origin;       /* The start state (by position in the list) each
+                        * DFA state was first reached from */
+    int n_states;
+    int array_sz;
+
+    int *hash;         /* Open-addressed table of vector indices */
+    int hash_sz;
+} dstates_t;
+
+static unsigned int vec_hash(const int *v, int n)
+{
+    unsigned int h = 0;
+    int i;
+
+    for(i = 0; i < n; ++i)
+        h = mix(h, v[i]);
+
+    return h;
+}
+
+static void grow_dstate_hash(dstates_t *ds)
+{
+    int i, j, mask;
+
+    free(ds->hash);
+    ds->hash_sz *= 2;
+    ds->hash = malloc_or_die(ds->hash_sz, int);
+    mask = ds->hash_sz - 1;
+
+    for(i = 0; i < ds->hash_sz; ++i)
+        ds->hash[i] = -1;
+
+    for(i = 0; i < ds->n_states; ++i) {
+        for(j = vec_hash(ds->vecs + i * ds->n_rx, ds->n_rx) & mask;
+            ds->hash[j] != -1; j = (j + 1) & mask)
+            ;
+        ds->hash[j] = i;
+    }
+}
+
+/* Returns the index of the DFA state for the term vector v, making it (with
+ * the accepting pattern given by the first nullable term) if needed. */
+static int get_dstate(dctx_t *ctx, dstates_t *ds, fa_t *dfa, const int *v,
+                      int origin)
+{
+    int i, mask = ds->hash_sz - 1, n = ds->n_rx, idx;
+    state_t *st;
+
+    for(i = vec_hash(v, n) & mask; ds->hash[i] != -1; i = (i + 1) & mask)
+        if(!memcmp(ds->vecs + ds->hash[i] * n, v, n * sizeof(int)))
+            return ds->hash[i];
+
+    if(ds->n_states >= ds->array_sz) {
+        int *new_vecs, *new_origin;
+        state_t **new_states;
+
+        ds->array_sz = ds->array_sz * 2 + 16;
+        new_vecs = malloc_or_die(ds->array_sz * n, int);
+        new_states = malloc_or_die(ds->array_sz, state_t *);
+        new_origin = malloc_or_die(ds->array_sz, int);
+        if(ds->n_states > 0) {
+            memcpy(new_vecs, ds->vecs, ds->n_states * n * sizeof(int));
+            memcpy(new_states, ds->states,
+                   ds->n_states * sizeof(state_t *));
+            memcpy(new_origin, ds->origin, ds->n_states * sizeof(int));
+        }
+        free(ds->vecs);
+        free(ds->states);
+        free(ds->origin);
+        ds->vecs = new_vecs;
+        ds->states = new_states;
+        ds->origin = new_origin;
+    }
+
+    idx = ds->n_states++;
+    memcpy(ds->vecs + idx * n, v, n * sizeof(int));
+    ds->states[idx] = st = mkstate(dfa);
+    ds->origin[idx] = origin;
+    ds->hash[i] = idx;
+
+    for(i = 0; i < n; ++i) {
+        if(ctx->terms[v[i]]->nullable) {
+            st->done_num = i + 1;
+            break;
+        }
+    }
+
+    if(ds->n_states * 2 > ds->hash_sz)
+        grow_dstate_hash(ds);
+
+    return idx;
+}
+
+/* The memory used by ds and ctx */
+static size_t dstates_size(const dstates_t *ds, const dctx_t *ctx)
+{
+    return ds->array_sz * (ds->n_rx * sizeof(int) + sizeof(state_t *) +
+                           sizeof(int)) + ds->hash_sz * sizeof(int) +
+           ctx->n_terms * sizeof(dterm_t);
+}
+
+/* Reports which patterns and start states account for the most states of
+ * ds, which has outgrown budget */
+static void report_blowup(const dstates_t *ds, size_t bytes,
+                          fa_list_t *rx_list, fa_list_t *dfa_list,
+                          const fa_budget_t *budget)
+{
+    fa_list_t *l;
+    int n_starts = 0, i, k;
+    int *pat_counts = malloc_or_die(ds->n_rx + 1, int);
+    int *start_counts;
+
+    for(l = dfa_list; l != NULL; l = l->next)
+        ++n_starts;
+    start_counts = malloc_or_die(n_starts + 1, int);
+
+    for(i = 0; i < ds->n_rx; ++i)
+        pat_counts[i] = 0;
+    for(i = 0; i < n_starts; ++i)
+        start_counts[i] = 0;
+
+    /* A pattern is in a state if its derivative there isn't empty */
+    for(k = 0; k < ds->n_states; ++k) {
+        ++start_counts[ds->origin[k]];
+        for(i = 0; i < ds->n_rx; ++i)
+            if(ds->vecs[k * ds->n_rx + i] != T_EMPTY)
+                ++pat_counts[i];
+    }
+
+    print_dfa_blowup(stderr, budget, ds->n_states, bytes, rx_list,
+                     pat_counts, dfa_list, start_counts);
+
+    free(pat_counts);
+    free(start_counts);
+}
+
+fa_t * regexes_to_dfa(fa_list_t *rx_list, fa_list_t *dfa_list,
+                      const fa_budget_t *budget, FILE *verb)
+{
+    dctx_t ctx;
+    dstates_t ds;
+    fa_t *dfa = mkfa();
+    fa_list_t *l, *pd;
+    int *init, *v, n_rx = 0, n_start = 0, i, j, c, k, next, *cls_dest;
+    size_t bytes;
+    unsigned int cond[CLASS_SZ];
+
+    init_ctx(&ctx);
+
+    for(l = rx_list; l != NULL; l = l->next)
+        ++n_rx;
+
+    init = malloc_or_die(n_rx + 1, int);
+    v = malloc_or_die(n_rx + 1, int);
+    for(l = rx_list, i = 0; l != NULL; l = l->next, ++i) {
+        init[i] = regex_to_term(&ctx, (regex_t *) l->data1);
+        l->done_num = i + 1;
+        l->state = NULL;
+    }
+
+    refine_classes(&ctx);
+    cls_dest = malloc_or_die(ctx.n_cls, int);
+
+    ds.n_rx = n_rx;
+    ds.vecs = NULL;
+    ds.states = NULL;
+    ds.origin = NULL;
+    ds.n_states = ds.array_sz = 0;
+    ds.hash_sz = 64;
+    ds.hash = malloc_or_die(ds.hash_sz, int);
+    for(i = 0; i < ds.hash_sz; ++i)
+        ds.hash[i] = -1;
+
+    for(pd = dfa_list; pd != NULL; pd = pd->next) {
+        for(l = rx_list, i = 0; l != NULL; l = l->next, ++i) {
+            if(l->data2 != NULL &&
+               !lstr_in_list((len_string *) pd->data1,
+                             (lstr_list_t *) l->data2))
+                v[i] = T_EMPTY;
+            else
+                v[i] = init[i];
+        }
+
+        k = get_dstate(&ctx, &ds, dfa, v, n_start++);
+        pd->state = ds.states[k];
+    }
+
+    /* The DFA states are expanded in order of creation; ds.n_states grows as
+     * new ones are found. */
+    for(k = 0; k < ds.n_states; ++k) {
+        bytes = fa_size(dfa) + dstates_size(&ds, &ctx);
+        if(over_budget(budget, ds.n_states, bytes)) {
+            report_blowup(&ds, bytes, rx_list, dfa_list, budget);
+            destroy_fa(dfa);
+            dfa = NULL;
+            break;
+        }
+
+        for(c = 0; c < ctx.n_cls; ++c) {
+            int is_empty = 1;
+
+            for(i = 0; i < n_rx; ++i) {
+                v[i] = derive(&ctx, ds.vecs[k * n_rx + i], c);
+                if(v[i] != T_EMPTY)
+                    is_empty = 0;
+            }
+
+            cls_dest[c] = is_empty ? -1 : get_dstate(&ctx, &ds, dfa, v,
+                                                     ds.origin[k]);
+        }
+
+        /* One transition per destination state, covering all the
+         * characters of all the classes leading there */
+        for(c = 0; c < ctx.n_cls; ++c) {
+            if((next = cls_dest[c]) == -1)
+                continue;
+
+            memset(cond, 0, sizeof(cond));
+            for(j = c; j < ctx.n_cls; ++j) {
+                if(cls_dest[j] != next)
+                    continue;
+                cls_dest[j] = -1;
+                for(i = 0; i < 256; ++i)
+                    if(ctx.cls[i] == j)
+                        cond[i / ML_UINT_BIT] |= 1 << (i % ML_UINT_BIT);
+            }
+            mktrans(dfa, ds.states[k], ds.states[next],
+                    intern_class(dfa, cond));
+        }
+    }
+
+    if(verb != NULL && dfa != NULL)
+        fprintf(verb, "--- derivatives: %d patterns, %d character classes, "
+                "%d terms, %d cached derivatives, %d DFA states\n", n_rx,
+                ctx.n_cls, ctx.n_terms, ctx.dcache_n, dfa->n_states);
+
+    free(init);
+    free(v);
+    free(cls_dest);
+    free(ds.vecs);
+    free(ds.states);
+    free(ds.origin);
+    free(ds.hash);
+    free_ctx(&ctx);
+
+    return dfa;
+}
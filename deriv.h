@@ -0,0 +1,34 @@
+/*
+ * deriv.h: Building DFAs directly from regexes with Brzozowski derivatives.
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#ifndef ML_DERIV_H
+#define ML_DERIV_H
+
+#ifndef ML_FA_H
+#include "fa.h"
+#endif
+
+#ifndef ML_STDIO_H
+#define ML_STDIO_H
+#include <stdio.h>
+#endif
+
+/*
+ * Builds a DFA for the regexes in rx_list without constructing an NFA: each
+ * DFA state is a vector of (normalized, hash-consed) derivatives of the
+ * patterns' regexes, one per pattern. The lists are interpreted as by
+ * multi_regex_compile and nfas_to_dfas: rx_list->data1 is a regex_t * and
+ * rx_list->data2 a lstr_list_t * of start states, and dfa_list->data1 is a
+ * len_string * start-state name. rx_list->done_num is set to the pattern
+ * number, and dfa_list->state to the initial DFA state for that start state.
+ * If verb is non-NULL, statistics about the construction are written to it.
+ * If the DFA outgrows budget (which may be NULL), the reasons are reported
+ * to stderr and NULL is returned.
+ */
+fa_t * regexes_to_dfa(fa_list_t *rx_list, fa_list_t *dfa_list,
+                      const fa_budget_t *budget, FILE *verb);
+
+#endif
@@ -0,0 +1,373 @@
+/*
+ * dfacache.c: Keeping built DFAs on disk between runs of Moonlime.
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#include "dfacache.h"
+
+#ifndef ML_STDLIB_H
+#define ML_STDLIB_H
+#include <stdlib.h>
+#endif
+
+#ifndef ML_STRING_H
+#define ML_STRING_H
+#include <string.h>
+#endif
+
+#ifndef ML_ERRNO_H
+#define ML_ERRNO_H
+#include <errno.h>
+#endif
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/* The first line of a cache file; bump the number when the format, or the
+ * way DFAs are built, changes */
+#define CACHE_MAGIC "moonlime-dfa 2"
+
+/* A buffer that the key is built up in */
+typedef struct {
+    char *s;
+    size_t len;
+    size_t sz;
+} key_buf_t;
+
+static void key_add(key_buf_t *k, const char *s, size_t len)
+{
+    char *new_s;
+
+    if(k->len + len > k->sz) {
+        k->sz = 2 * (k->len + len);
+        new_s = malloc_or_die(k->sz, char);
+        if(k->s != NULL) {
+            memcpy(new_s, k->s, k->len);
+            free(k->s);
+        }
+        k->s = new_s;
+    }
+
+    memcpy(k->s + k->len, s, len);
+    k->len += len;
+}
+
+static void key_add_int(key_buf_t *k, char tag, long n)
+{
+    char buf[32];
+
+    sprintf(buf, "%c%ld;", tag, n);
+    key_add(k, buf, strlen(buf));
+}
+
+static void key_add_lstr(key_buf_t *k, const len_string *s)
+{
+    key_add_int(k, 's', (long) s->len);
+    key_add(k, s->s, s->len);
+}
+
+/* Adds an unambiguous rendering of rx to the key */
+static void key_add_regex(key_buf_t *k, const regex_t *rx)
+{
+    unsigned int set[CLASS_SZ];
+    char buf[9];
+    size_t i;
+    int j;
+
+    switch(rx->type) {
+      case R_CHAR:
+      case R_CLASS:
+      case R_ANY:
+        regex_leaf_set(rx, set);
+        key_add(k, "L", 1);
+        for(i = 0; i < CLASS_SZ; ++i) {
+            for(j = 0; j < (int) sizeof(unsigned int); ++j)
+                buf[j] = (char) ((set[i] >> (8 * j)) & 0xff);
+            key_add(k, buf, sizeof(unsigned int));
+        }
+        break;
+
+      case R_OPTION:
+      case R_CONCAT:
+        key_add_int(k, (rx->type == R_OPTION) ? '|' : '.',
+                    (long) rx->data.list.n_enc);
+        for(i = 0; i < rx->data.list.n_enc; ++i)
+            key_add_regex(k, rx->data.list.enc[i]);
+        break;
+
+      case R_MAYBE:
+      case R_STAR:
+      case R_PLUS:
+        key_add(k, (rx->type == R_MAYBE) ? "?" :
+                   (rx->type == R_STAR) ? "*" : "+", 1);
+        key_add_regex(k, rx->data.enc);
+        break;
+
+      case R_NUM:
+        key_add_int(k, '{', rx->data.num.min);
+        key_add_int(k, ',', rx->data.num.max);
+        key_add_regex(k, rx->data.num.enc);
+        break;
+
+      case R_ZERO:
+        key_add(k, "0", 1);
+        break;
+
+      case R_PAREN:
+        fprintf(stderr, __FILE__ ":%d: R_PAREN shouldn\'t be in a regex!\n",
+                __LINE__);
+        exit(1);
+    }
+}
+
+len_string * dfa_cache_key(fa_list_t *rx_list, const fa_list_t *start,
+                           fa_engine engine)
+{
+    key_buf_t k;
+    fa_list_t *l;
+    len_string *key, *name = (len_string *) start->data1;
+    long i;
+
+    k.s = NULL;
+    k.len = k.sz = 0;
+
+    key_add(&k, CACHE_MAGIC "\n", strlen(CACHE_MAGIC) + 1);
+    key_add_int(&k, 'e', (long) engine);
+    key_add_lstr(&k, name);
+
+    /* Patterns are numbered by their place in the whole list, so that
+     * number goes in along with each pattern that applies */
+    for(l = rx_list, i = 1; l != NULL; l = l->next, ++i) {
+        if(l->data2 != NULL && !lstr_in_list(name, (lstr_list_t *) l->data2))
+            continue;
+        key_add_int(&k, '\n', i);
+        key_add_regex(&k, (regex_t *) l->data1);
+    }
+
+    key = lstring_dupbuf(k.len, k.s);
+    free(k.s);
+
+    return key;
+}
+
+/* Returns the name of the file the DFA for key is cached in */
+static char * cache_file_name(const char *dir, const len_string *key)
+{
+    unsigned long h1 = 2166136261UL, h2 = 0x811c9dc5UL ^ 0x5bd1e995UL;
+    size_t i;
+    char *name = malloc_or_die(strlen(dir) + 32, char);
+
+    /* Two 32-bit FNV-1a hashes make a 64-bit name; the key itself is stored
+     * in the file too, so a collision only costs a rebuild */
+    for(i = 0; i < key->len; ++i) {
+        h1 = ((h1 ^ (0xff & (unsigned long) key->s[i])) * 16777619UL) &
+             0xffffffffUL;
+        h2 = ((h2 ^ (0xff & (unsigned long) key->s[i])) * 16777619UL) &
+             0xffffffffUL;
+    }
+
+    sprintf(name, "%s/%08lx%08lx.dfa", dir, h1, h2);
+    return name;
+}
+
+/* Reads the rest of a cache file after the key; returns NULL if it's
+ * malformed */
+static fa_t * read_dfa(FILE *f, fa_list_t *start)
+{
+    fa_t *dfa;
+    state_t **states, *s;
+    unsigned int set[CLASS_SZ];
+    int n_states, n_classes, n_trans, i, j, *cls, *dest, ok = 1;
+    char word[4];
+
+    if(fscanf(f, " fa %d %d", &n_states, &n_classes) != 2 ||
+       n_states < 1 || n_classes < 0)
+        return NULL;
+
+    dfa = mkfa();
+
+    for(i = 0; i < n_classes && ok; ++i) {
+        for(j = 0; j < CLASS_SZ; ++j)
+            if(fscanf(f, "%x", &set[j]) != 1)
+                ok = 0;
+        if(ok && intern_class(dfa, set) != i)
+            ok = 0;
+    }
+
+    states = malloc_or_die(n_states, state_t *);
+    for(i = 0; i < n_states; ++i)
+        states[i] = mkstate(dfa);
+
+    for(i = 0; i < n_states && ok; ++i) {
+        if(fscanf(f, "%d %d", &states[i]->done_num, &n_trans) != 2 ||
+           n_trans < 0) {
+            ok = 0;
+            break;
+        }
+
+        cls = malloc_or_die(n_trans + 1, int);
+        dest = malloc_or_die(n_trans + 1, int);
+        for(j = 0; j < n_trans && ok; ++j) {
+            if(fscanf(f, "%d %d", &cls[j], &dest[j]) != 2 ||
+               cls[j] < 0 || cls[j] >= n_classes ||
+               dest[j] < 0 || dest[j] >= n_states)
+                ok = 0;
+        }
+
+        /* mktrans prepends, so this keeps the transitions in their order */
+        for(j = n_trans - 1; j >= 0 && ok; --j)
+            mktrans(dfa, states[i], states[dest[j]], cls[j]);
+
+        free(cls);
+        free(dest);
+    }
+
+    if(ok && (fscanf(f, "%d", &i) != 1 || i < 0 || i >= n_states))
+        ok = 0;
+    else if(ok)
+        start->state = states[i];
+
+    if(ok && (fscanf(f, "%3s", word) != 1 || strcmp(word, "end")))
+        ok = 0;
+
+    for(s = dfa->first, i = 0; s != NULL && ok; s = s->next, ++i)
+        if(s->id != i)
+            ok = 0;
+
+    free(states);
+
+    if(!ok) {
+        destroy_fa(dfa);
+        return NULL;
+    }
+
+    return dfa;
+}
+
+fa_t * dfa_cache_load(const char *dir, const len_string *key,
+                      fa_list_t *start, FILE *verb)
+{
+    char *name = cache_file_name(dir, key);
+    FILE *f;
+    len_string *stored;
+    unsigned long len;
+    fa_t *dfa = NULL;
+    char magic[sizeof(CACHE_MAGIC)];
+
+    if((f = fopen(name, "rb")) == NULL) {
+        if(verb != NULL)
+            fprintf(verb, "--- DFA cache: %.*s: no entry %s\n",
+                    (int) ((len_string *) start->data1)->len,
+                    ((len_string *) start->data1)->s, name);
+        free(name);
+        return NULL;
+    }
+
+    if(fread(magic, 1, sizeof(magic), f) == sizeof(magic) &&
+       !memcmp(magic, CACHE_MAGIC "\n", sizeof(magic)) &&
+       fscanf(f, "key %lu", &len) == 1 && fgetc(f) == '\n' &&
+       len == key->len) {
+        stored = mk_blank_lstring(len);
+        if(fread(stored->s, 1, len, f) == len && lstr_eq(stored, key))
+            dfa = read_dfa(f, start);
+        free(stored);
+    }
+
+    fclose(f);
+
+    if(verb != NULL)
+        fprintf(verb, "--- DFA cache: %.*s: %s %s\n",
+                (int) ((len_string *) start->data1)->len,
+                ((len_string *) start->data1)->s,
+                (dfa != NULL) ? "reusing" : "ignoring stale entry", name);
+
+    free(name);
+    return dfa;
+}
+
+static void write_dfa(FILE *f, const fa_t *dfa, const fa_list_t *start)
+{
+    const state_t *s;
+    const trans_t *t;
+    int i, j, n;
+
+    fprintf(f, "\nfa %d %d\n", dfa->n_states, dfa->n_classes);
+
+    for(i = 0; i < dfa->n_classes; ++i)
+        for(j = 0; j < CLASS_SZ; ++j)
+            fprintf(f, "%x%s", dfa->classes[i * CLASS_SZ + j],
+                    (j < CLASS_SZ - 1) ? " " : "\n");
+
+    for(s = dfa->first; s != NULL; s = s->next) {
+        for(n = 0, t = s->trans; t != NULL; t = t->next)
+            ++n;
+        fprintf(f, "%d %d", s->done_num, n);
+        for(t = s->trans; t != NULL; t = t->next)
+            fprintf(f, " %d %d", t->cls, t->dest->id);
+        fputc('\n', f);
+    }
+
+    fprintf(f, "%d\nend\n", start->state->id);
+}
+
+/* Numbers the temporary files this process writes, so that threads storing
+ * the same DFA at once (see --batch) don't write over each other's */
+static pthread_mutex_t tmp_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned long tmp_count = 0;
+
+int dfa_cache_store(const char *dir, const len_string *key, const fa_t *dfa,
+                    const fa_list_t *start, FILE *verb)
+{
+    char *name = cache_file_name(dir, key);
+    char *tmp_name = malloc_or_die(strlen(name) + 48, char);
+    unsigned long n;
+    FILE *f;
+    int ok;
+
+    if(mkdir(dir, 0777) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Warning: can\'t create DFA cache directory %s\n",
+                dir);
+        free(name);
+        free(tmp_name);
+        return 0;
+    }
+
+    /* Written under a temporary name, then renamed, so that lexers being
+     * generated at the same time never see half a file */
+    pthread_mutex_lock(&tmp_lock);
+    n = tmp_count++;
+    pthread_mutex_unlock(&tmp_lock);
+    sprintf(tmp_name, "%s.%ld.%lu.tmp", name, (long) getpid(), n);
+
+    if((f = fopen(tmp_name, "wb")) == NULL) {
+        fprintf(stderr, "Warning: can\'t write DFA cache file %s\n",
+                tmp_name);
+        free(name);
+        free(tmp_name);
+        return 0;
+    }
+
+    fprintf(f, "%s\nkey %lu\n", CACHE_MAGIC, (unsigned long) key->len);
+    fwrite(key->s, 1, key->len, f);
+    write_dfa(f, dfa, start);
+
+    ok = !ferror(f);
+    if(fclose(f) != 0)
+        ok = 0;
+
+    if(!ok || rename(tmp_name, name) != 0) {
+        fprintf(stderr, "Warning: can\'t write DFA cache file %s\n", name);
+        remove(tmp_name);
+        ok = 0;
+    } else if(verb != NULL)
+        fprintf(verb, "--- DFA cache: %.*s: stored %s\n",
+                (int) ((len_string *) start->data1)->len,
+                ((len_string *) start->data1)->s, name);
+
+    free(name);
+    free(tmp_name);
+    return ok;
+}
@@ -0,0 +1,49 @@
+/*
+ * dfacache.h: Keeping built DFAs on disk between runs of Moonlime.
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#ifndef ML_DFACACHE_H
+#define ML_DFACACHE_H
+
+#ifndef ML_FA_H
+#include "fa.h"
+#endif
+
+#ifndef ML_STDIO_H
+#define ML_STDIO_H
+#include <stdio.h>
+#endif
+
+/*
+ * The cache holds one DFA per start state, so that changing the patterns of
+ * one start state leaves the others' DFAs usable.
+ *
+ * Returns the key (a fingerprint of the start state) that the DFA built by
+ * engine from the patterns in rx_list (data1 a regex_t *, data2 a
+ * lstr_list_t * of start states) for the one start state start (data1 a
+ * len_string * name) is cached under. It covers only the patterns that apply
+ * in that start state, and only their regexes and numbers, so changing their
+ * code, or anything else in the spec, leaves it the same.
+ */
+len_string * dfa_cache_key(fa_list_t *rx_list, const fa_list_t *start,
+                           fa_engine engine);
+
+/*
+ * Looks for a DFA cached under key in the directory dir. If there is one, it
+ * is returned, with start->state set to its initial state; otherwise, NULL is
+ * returned. If verb is non-NULL, what was found is noted there.
+ */
+fa_t * dfa_cache_load(const char *dir, const len_string *key,
+                      fa_list_t *start, FILE *verb);
+
+/*
+ * Stores dfa, whose initial state is start->state, under key in the directory
+ * dir, creating dir if need be. A cache that can't be written to only earns a
+ * warning on stderr; returns 1 on success.
+ */
+int dfa_cache_store(const char *dir, const len_string *key, const fa_t *dfa,
+                    const fa_list_t *start, FILE *verb);
+
+#endif
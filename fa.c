@@ -26,6 +26,11 @@
 #include <limits.h>
 #endif
 
+#ifndef ML_PTHREAD_H
+#define ML_PTHREAD_H
+#include <pthread.h>
+#endif
+
 #ifndef ML_UTILS_H
 #include "utils.h"
 #endif
@@ -34,12 +39,31 @@
 #include "regex.h"
 #endif
 
+#ifndef ML_STATS_H
+#include "stats.h"
+#endif
+
+/* Size of the chunks of memory states and transitions are allocated from */
+#define FA_ARENA_CHUNK 65536
+
 /* Creates and sets up an FA object */
-static fa_t * mkfa()
+fa_t * mkfa(void)
 {
     fa_t *fa = malloc_or_die(1, fa_t);
+    int i;
+
     fa->n_states = 0;
+    fa->n_trans = 0;
     fa->first = fa->last = NULL;
+    fa->arena = mk_arena(FA_ARENA_CHUNK);
+
+    fa->n_classes = 0;
+    fa->classes_sz = 16;
+    fa->classes = malloc_or_die(fa->classes_sz * CLASS_SZ, unsigned int);
+    fa->cls_hash_sz = 32;
+    fa->cls_hash = malloc_or_die(fa->cls_hash_sz, int);
+    for(i = 0; i < fa->cls_hash_sz; ++i)
+        fa->cls_hash[i] = -1;
 
     return fa;
 }
@@ -47,26 +71,24 @@ static fa_t * mkfa()
 /* Frees an FA object and all its subsidiary state and transition objects */
 void destroy_fa(fa_t *fa)
 {
-    state_t *st, *nst;
-    trans_t *tr, *ntr;
-
-    for(st = fa->first; st != NULL; st = nst) {
-        for(tr = st->trans; tr != NULL; tr = ntr) {
-            ntr = tr->next;
-            free(tr);
-        }
-
-        nst = st->next;
-        free(st);
-    }
-
+    destroy_arena(fa->arena);
+    free(fa->classes);
+    free(fa->cls_hash);
     free(fa);
 }
 
+/* Returns the number of bytes of memory used by fa */
+size_t fa_size(const fa_t *fa)
+{
+    return sizeof(*fa) + fa->arena->total +
+           fa->classes_sz * CLASS_SZ * sizeof(unsigned int) +
+           fa->cls_hash_sz * sizeof(int);
+}
+
 /* Makes a state in a particular finite automaton fa */
-static state_t * mkstate(fa_t *fa)
+state_t * mkstate(fa_t *fa)
 {
-    state_t *st = malloc_or_die(1, state_t);
+    state_t *st = arena_alloc(fa->arena, 1, state_t);
 
     st->id = fa->n_states++;
     st->done_num = 0;
@@ -83,195 +105,329 @@ static state_t * mkstate(fa_t *fa)
     return st;
 }
 
-/* Makes a transition from a state s1 to a state s2; returns the transition
- * object for further modification. */
-static trans_t * mktrans(state_t *s1, state_t *s2)
+static unsigned int class_hash(const unsigned int *cond)
 {
-    size_t i;
-    trans_t *tr = malloc_or_die(1, trans_t);
-
-    tr->is_nil = 0;
+    unsigned int h = 2166136261u;
+    int i;
 
     for(i = 0; i < CLASS_SZ; ++i)
-        tr->cond[i] = 0;
+        h = (h ^ cond[i]) * 16777619u;
+
+    return h;
+}
+
+/* Returns the index of the character set cond in fa's class table, adding it
+ * if it isn't there already */
+int intern_class(fa_t *fa, const unsigned int *cond)
+{
+    int i, j, mask = fa->cls_hash_sz - 1;
+    unsigned int *new_classes;
+
+    for(i = class_hash(cond) & mask; fa->cls_hash[i] != -1;
+        i = (i + 1) & mask) {
+        if(!memcmp(fa->classes + fa->cls_hash[i] * CLASS_SZ, cond,
+                   CLASS_SZ * sizeof(unsigned int)))
+            return fa->cls_hash[i];
+    }
+
+    if(fa->n_classes >= fa->classes_sz) {
+        fa->classes_sz *= 2;
+        new_classes = malloc_or_die(fa->classes_sz * CLASS_SZ, unsigned int);
+        memcpy(new_classes, fa->classes,
+               fa->n_classes * CLASS_SZ * sizeof(unsigned int));
+        free(fa->classes);
+        fa->classes = new_classes;
+    }
+
+    memcpy(fa->classes + fa->n_classes * CLASS_SZ, cond,
+           CLASS_SZ * sizeof(unsigned int));
+    fa->cls_hash[i] = fa->n_classes;
+
+    if(++fa->n_classes * 2 > fa->cls_hash_sz) {
+        free(fa->cls_hash);
+        fa->cls_hash_sz *= 2;
+        fa->cls_hash = malloc_or_die(fa->cls_hash_sz, int);
+        mask = fa->cls_hash_sz - 1;
+        for(i = 0; i < fa->cls_hash_sz; ++i)
+            fa->cls_hash[i] = -1;
+        for(j = 0; j < fa->n_classes; ++j) {
+            for(i = class_hash(fa->classes + j * CLASS_SZ) & mask;
+                fa->cls_hash[i] != -1; i = (i + 1) & mask)
+                ;
+            fa->cls_hash[i] = j;
+        }
+    }
+
+    return fa->n_classes - 1;
+}
+
+/* Makes a transition in fa from a state s1 to a state s2 on the characters
+ * of class cls (as returned by intern_class), or a nil-transition if cls is
+ * CLS_NIL; returns the transition object for further modification. */
+trans_t * mktrans(fa_t *fa, state_t *s1, state_t *s2, int cls)
+{
+    trans_t *tr = arena_alloc(fa->arena, 1, trans_t);
 
+    tr->cls = cls;
     tr->dest = s2;
-    tr->next_fin = NULL;
     tr->next = s1->trans;
     s1->trans = tr;
+    ++fa->n_trans;
 
     return tr;
 }
 
-/* Converts the regex tree rx into an NFA fragment inside the NFA fa; returns
- * the fragment object */
-static fa_frag_t * regex_to_nfa_frag(regex_t *rx, fa_t *fa)
+/* A list of the transitions out of an NFA fragment, whose destinations are
+ * filled in once the following fragment is known */
+typedef struct fin_list {
+    trans_t *t;
+    struct fin_list *next;
+} fin_t;
+
+/* A fragment of an NFA corresponding to part of a regular expression */
+typedef struct {
+    state_t *init; /* The initial state of this fragment */
+    fin_t *final;  /* The list of transitions out of this fragment */
+} fa_frag_t;
+
+/* Scratch data used while building fragments */
+typedef struct {
+    fa_t *fa;
+    arena_t *scratch; /* Where fin_t objects live */
+} frag_ctx_t;
+
+/* Makes a transition out of init_st (to a state not yet known) and adds it
+ * to frag's list of final transitions */
+static trans_t * mkfinal(frag_ctx_t *ctx, fa_frag_t *frag, state_t *init_st,
+                         int cls)
+{
+    fin_t *f = arena_alloc(ctx->scratch, 1, fin_t);
+
+    f->t = mktrans(ctx->fa, init_st, NULL, cls);
+    f->next = frag->final;
+    frag->final = f;
+
+    return f->t;
+}
+
+/* Points all the final transitions in the list f at dest */
+static void patch_final(fin_t *f, state_t *dest)
+{
+    for(; f != NULL; f = f->next)
+        f->t->dest = dest;
+}
+
+static void regex_to_nfa_frag(frag_ctx_t *ctx, const regex_t *rx,
+                              fa_frag_t *frag);
+
+/* Makes in *copy a copy of the fragment tmpl, whose states are the n states
+ * starting with first; map is scratch space for n state pointers. Copying
+ * the states and transitions is much cheaper than building the fragment
+ * again from its regex. */
+static void clone_frag(frag_ctx_t *ctx, const fa_frag_t *tmpl,
+                       state_t *first, int n, state_t **map,
+                       fa_frag_t *copy)
+{
+    const state_t *s;
+    const trans_t *t;
+    int i, base = first->id;
+
+    for(i = 0; i < n; ++i)
+        map[i] = mkstate(ctx->fa);
+
+    copy->init = map[tmpl->init->id - base];
+    copy->final = NULL;
+
+    for(i = 0, s = first; i < n; ++i, s = s->next) {
+        for(t = s->trans; t != NULL; t = t->next) {
+            if(t->dest == NULL)
+                mkfinal(ctx, copy, map[i], t->cls);
+            else
+                mktrans(ctx->fa, map[i], map[t->dest->id - base], t->cls);
+        }
+    }
+}
+
+/* Converts the counted repetition rx into an NFA fragment starting at init_st.
+ * A single-character body becomes a plain chain of states; any other body is
+ * built once and then cloned for each further repetition. */
+static void num_to_nfa_frag(frag_ctx_t *ctx, const regex_t *rx,
+                            state_t *init_st, fa_frag_t *frag)
+{
+    fa_t *fa = ctx->fa;
+    const regex_t *enc = rx->data.num.enc;
+    int min = (rx->data.num.min != -1) ? rx->data.num.min : 0;
+    int max = rx->data.num.max;
+    unsigned int cond[CLASS_SZ];
+    state_t *cur, *next, *first, **map;
+    fa_frag_t *parts, exits;
+    fin_t *fin, *p;
+    int i, n, cls, copies;
+
+    if(enc->type == R_CHAR || enc->type == R_CLASS || enc->type == R_ANY) {
+        regex_leaf_set(enc, cond);
+        cls = intern_class(fa, cond);
+
+        cur = init_st;
+        for(i = 0; i < min; ++i) {
+            next = mkstate(fa);
+            mktrans(fa, cur, next, cls);
+            cur = next;
+        }
+
+        if(max == -1)
+            mktrans(fa, cur, cur, cls);
+
+        for(; i < max; ++i) {
+            mkfinal(ctx, frag, cur, CLS_NIL);
+            next = mkstate(fa);
+            mktrans(fa, cur, next, cls);
+            cur = next;
+        }
+
+        mkfinal(ctx, frag, cur, CLS_NIL);
+        return;
+    }
+
+    mkfinal(ctx, frag, init_st, CLS_NIL);
+
+    copies = min + ((max == -1) ? 1 : (max > min) ? max - min : 0);
+    if(copies == 0)
+        return;
+
+    /* Build the body once, then clone it before any of it gets linked up */
+    n = fa->n_states;
+    cur = fa->last;
+    parts = arena_alloc(ctx->scratch, copies, fa_frag_t);
+    regex_to_nfa_frag(ctx, enc, &parts[0]);
+    first = cur->next;
+    n = fa->n_states - n;
+
+    map = arena_alloc(ctx->scratch, n, state_t *);
+    for(i = 1; i < copies; ++i)
+        clone_frag(ctx, &parts[0], first, n, map, &parts[i]);
+
+    fin = frag->final;
+    exits.final = NULL;
+
+    for(i = 0; i < min; ++i) {
+        patch_final(fin, parts[i].init);
+        fin = parts[i].final;
+    }
+
+    /* Each optional repetition starts at a state with a way out */
+    for(; i < copies; ++i) {
+        cur = mkstate(fa);
+        patch_final(fin, cur);
+        mktrans(fa, cur, parts[i].init, CLS_NIL);
+        mkfinal(ctx, &exits, cur, CLS_NIL);
+
+        if(max == -1) {
+            patch_final(parts[i].final, cur);
+            fin = NULL;
+        } else
+            fin = parts[i].final;
+    }
+
+    if(fin == NULL) {
+        fin = exits.final;
+    } else {
+        for(p = fin; p->next != NULL; p = p->next)
+            ;
+        p->next = exits.final;
+    }
+
+    frag->final = fin;
+}
+
+/* Converts the regex tree rx into an NFA fragment inside the NFA ctx->fa,
+ * stored in *frag */
+static void regex_to_nfa_frag(frag_ctx_t *ctx, const regex_t *rx,
+                              fa_frag_t *frag)
 {
-    fa_frag_t *frag = malloc_or_die(1, fa_frag_t);
-    fa_frag_t *subfrag;
+    fa_t *fa = ctx->fa;
+    fa_frag_t subfrag;
     state_t *init_st = mkstate(fa);
-    trans_t *tr = NULL;
-    trans_t *p;
+    unsigned int cond[CLASS_SZ];
+    fin_t *p;
     int i;
-    regex_t dummy;
 
-    frag->fa = fa;
     frag->init = init_st;
     frag->final = NULL;
 
     switch(rx->type) {
       case R_CHAR:
-        i = rx->data.c;
-        tr = mktrans(init_st, NULL);
-        tr->cond[i / ML_UINT_BIT] = 1 << (i % ML_UINT_BIT);
-        frag->final = tr;
-        break;
-
       case R_CLASS:
-        tr = mktrans(init_st, NULL);
-        if(!rx->data.cls.is_inverted) {
-            for(i = 0; i < CLASS_SZ; ++i)
-                tr->cond[i] = rx->data.cls.set[i];
-        } else {
-            for(i = 0; i < CLASS_SZ; ++i)
-                tr->cond[i] = ~rx->data.cls.set[i];
-        }
-        frag->final = tr;
-        break;
-
       case R_ANY:
-        tr = mktrans(init_st, NULL);
-        for(i = 0; i < CLASS_SZ; ++i)
-            tr->cond[i] = ~0;
-        frag->final = tr;
+        regex_leaf_set(rx, cond);
+        mkfinal(ctx, frag, init_st, intern_class(fa, cond));
         break;
 
       case R_OPTION:
         for(i = 0; i < rx->data.list.n_enc; ++i) {
-            subfrag = regex_to_nfa_frag(rx->data.list.enc[i], fa);
-            tr = mktrans(init_st, subfrag->init);
-            tr->is_nil = 1;
+            regex_to_nfa_frag(ctx, rx->data.list.enc[i], &subfrag);
+            mktrans(fa, init_st, subfrag.init, CLS_NIL);
             /* Prepend subfrag's outward-transition list to frag's */
-            p = subfrag->final;
-            while(p != NULL && p->next_fin != NULL)
-                p = p->next_fin;
+            p = subfrag.final;
+            while(p != NULL && p->next != NULL)
+                p = p->next;
             if(p != NULL) {
-                p->next_fin = frag->final;
-                frag->final = subfrag->final;
+                p->next = frag->final;
+                frag->final = subfrag.final;
             }
-            free(subfrag);
         }
         break;
 
       case R_CONCAT:
-        tr = mktrans(init_st, NULL);
-        tr->is_nil = 1;
-        frag->final = tr;
+        mkfinal(ctx, frag, init_st, CLS_NIL);
 
         for(i = 0; i < rx->data.list.n_enc; ++i) {
-            subfrag = regex_to_nfa_frag(rx->data.list.enc[i], fa);
+            regex_to_nfa_frag(ctx, rx->data.list.enc[i], &subfrag);
             /* Take frag's current outward-transition list and point them to
              * subfrag's initial state */
-            for(p = frag->final; p != NULL; p = p->next_fin)
-                p->dest = subfrag->init;
+            patch_final(frag->final, subfrag.init);
             /* Make subfrag's outward-transition list frag's new
              * outward-transition list */
-            frag->final = subfrag->final;
-            free(subfrag);
+            frag->final = subfrag.final;
         }
         break;
 
       case R_MAYBE:
-        subfrag = regex_to_nfa_frag(rx->data.enc, fa);
-        tr = mktrans(init_st, subfrag->init);
-        tr->is_nil = 1;
+        regex_to_nfa_frag(ctx, rx->data.enc, &subfrag);
+        mktrans(fa, init_st, subfrag.init, CLS_NIL);
 
-        tr = mktrans(init_st, NULL);
-        tr->is_nil = 1;
-        tr->next_fin = subfrag->final;
-        frag->final = tr;
-
-        free(subfrag);
+        frag->final = subfrag.final;
+        mkfinal(ctx, frag, init_st, CLS_NIL);
         break;
 
       case R_STAR:
-        subfrag = regex_to_nfa_frag(rx->data.enc, fa);
-        tr = mktrans(init_st, subfrag->init);
-        tr->is_nil = 1;
-
-        for(p = subfrag->final; p != NULL; p = p->next_fin)
-            p->dest = init_st;
+        regex_to_nfa_frag(ctx, rx->data.enc, &subfrag);
+        mktrans(fa, init_st, subfrag.init, CLS_NIL);
 
-        tr = mktrans(init_st, NULL);
-        tr->is_nil = 1;
-        frag->final = tr;
+        patch_final(subfrag.final, init_st);
 
-        free(subfrag);
+        mkfinal(ctx, frag, init_st, CLS_NIL);
         break;
 
       case R_PLUS:
-        subfrag = regex_to_nfa_frag(rx->data.enc, fa);
+        regex_to_nfa_frag(ctx, rx->data.enc, &subfrag);
 
         /* "init_st" is a bit of a misnomer in this case... */
-        frag->init = subfrag->init;
+        frag->init = subfrag.init;
 
-        for(p = subfrag->final; p != NULL; p = p->next_fin)
-            p->dest = init_st;
+        patch_final(subfrag.final, init_st);
 
-        tr = mktrans(init_st, subfrag->init);
-        tr->is_nil = 1;
+        mktrans(fa, init_st, subfrag.init, CLS_NIL);
 
-        tr = mktrans(init_st, NULL);
-        tr->is_nil = 1;
-        frag->final = tr;
-
-        free(subfrag);
+        mkfinal(ctx, frag, init_st, CLS_NIL);
         break;
 
       case R_NUM:
-        i = 0;
-
-        tr = mktrans(init_st, NULL);
-        tr->is_nil = 1;
-        frag->final = tr;
-
-        if(rx->data.num.min != -1) {
-            while(i < rx->data.num.min) {
-                subfrag = regex_to_nfa_frag(rx->data.num.enc, fa);
-                for(p = frag->final; p != NULL; p = p->next_fin)
-                    p->dest = subfrag->init;
-                frag->final = subfrag->final;
-                free(subfrag);
-                ++i;
-            }
-        }
-
-        if(rx->data.num.max != -1) {
-            dummy.type = R_MAYBE;
-            dummy.data.enc = rx->data.num.enc;
-            while(i < rx->data.num.max) {
-                subfrag = regex_to_nfa_frag(&dummy, fa);
-                for(p = frag->final; p != NULL; p = p->next_fin)
-                    p->dest = subfrag->init;
-                frag->final = subfrag->final;
-                free(subfrag);
-                ++i;
-            }
-        } else {
-            dummy.type = R_STAR;
-            dummy.data.enc = rx->data.num.enc;
-            subfrag = regex_to_nfa_frag(&dummy, fa);
-            for(p = frag->final; p != NULL; p = p->next_fin)
-                p->dest = subfrag->init;
-            frag->final = subfrag->final;
-            free(subfrag);
-        }
+        num_to_nfa_frag(ctx, rx, init_st, frag);
         break;
 
       case R_ZERO:
-        tr = mktrans(init_st, NULL);
-        tr->is_nil = 1;
-        frag->final = tr;
+        mkfinal(ctx, frag, init_st, CLS_NIL);
         break;
 
       case R_PAREN:
@@ -279,272 +435,1902 @@ static fa_frag_t * regex_to_nfa_frag(regex_t *rx, fa_t *fa)
                 __LINE__);
         exit(1);
     }
-
-    return frag;
 }
 
 fa_t * single_regex_compile(regex_t *rx, state_t **initstate)
 {
-    fa_t *fa = mkfa();
-    fa_frag_t *frag;
+    frag_ctx_t ctx;
+    fa_frag_t frag;
     state_t *endstate;
-    trans_t *p;
 
-    frag = regex_to_nfa_frag(rx, fa);
+    ctx.fa = mkfa();
+    ctx.scratch = mk_arena(FA_ARENA_CHUNK);
+
+    regex_to_nfa_frag(&ctx, rx, &frag);
 
-    endstate = mkstate(fa);
+    endstate = mkstate(ctx.fa);
     endstate->done_num = 1;
 
-    for(p = frag->final; p != NULL; p = p->next_fin)
-        p->dest = endstate;
+    patch_final(frag.final, endstate);
 
     if(initstate != NULL)
-        *initstate = frag->init;
+        *initstate = frag.init;
 
-    free(frag);
+    destroy_arena(ctx.scratch);
 
-    return fa;
+    return ctx.fa;
+}
+
+/* A node of a trie of the literal prefixes of patterns, one per NFA state */
+typedef struct trie_node {
+    int c;                    /* The character leading here from the parent */
+    state_t *st;
+    struct trie_node *child;  /* First child */
+    struct trie_node *next;   /* Next sibling */
+} trie_node_t;
+
+/* The root of the prefix trie for the patterns with a particular list of
+ * start states */
+typedef struct trie_root {
+    lstr_list_t *states;      /* As in fa_list_t.data2 */
+    trie_node_t node;
+    struct trie_root *next;
+} trie_root_t;
+
+/* Do the start-state lists a and b (NULL meaning all states) name the same
+ * states? */
+static int same_states(const lstr_list_t *a, const lstr_list_t *b)
+{
+    const lstr_list_t *p;
+
+    if(a == NULL || b == NULL)
+        return a == b;
+
+    for(p = a; p != NULL; p = p->next)
+        if(!lstr_in_list(p->s, b))
+            return 0;
+    for(p = b; p != NULL; p = p->next)
+        if(!lstr_in_list(p->s, a))
+            return 0;
+
+    return 1;
+}
+
+/* The number of R_CHAR regexes rx begins with */
+static size_t literal_prefix_len(const regex_t *rx)
+{
+    size_t i;
+
+    if(rx->type == R_CHAR)
+        return 1;
+    if(rx->type != R_CONCAT)
+        return 0;
+
+    for(i = 0; i < rx->data.list.n_enc; ++i)
+        if(rx->data.list.enc[i]->type != R_CHAR)
+            break;
+
+    return i;
+}
+
+/* Returns the child of node reached on c, making it if need be */
+static trie_node_t * trie_child(frag_ctx_t *ctx, trie_node_t *node, int c)
+{
+    trie_node_t *t;
+    unsigned int cond[CLASS_SZ];
+
+    for(t = node->child; t != NULL; t = t->next)
+        if(t->c == c)
+            return t;
+
+    t = arena_alloc(ctx->scratch, 1, trie_node_t);
+    t->c = c;
+    t->st = mkstate(ctx->fa);
+    t->child = NULL;
+    t->next = node->child;
+    node->child = t;
+
+    memset(cond, 0, sizeof(cond));
+    cond[c / ML_UINT_BIT] = 1 << (c % ML_UINT_BIT);
+    mktrans(ctx->fa, node->st, t->st, intern_class(ctx->fa, cond));
+
+    return t;
 }
 
-/* Here, fa_list_t.data1 is interpreted as a regex_t * */
+/* Here, fa_list_t.data1 is interpreted as a regex_t * and data2 as a
+ * lstr_list_t * of start states. Patterns that begin with literal characters
+ * and have the same start states share a trie of NFA states for those
+ * characters (and so the same initial state). */
 fa_t * multi_regex_compile(fa_list_t *l)
 {
-    fa_t *fa = mkfa();
-    fa_frag_t *frag;
+    frag_ctx_t ctx;
+    fa_frag_t frag;
     state_t *endstate;
-    trans_t *t;
     int n = 0;
+    size_t i, k;
+    regex_t *rx, rest;
+    trie_root_t *roots = NULL, *r;
+    trie_node_t *node;
+
+    ctx.fa = mkfa();
+    ctx.scratch = mk_arena(FA_ARENA_CHUNK);
 
     while(l != NULL) {
-        frag = regex_to_nfa_frag((regex_t *) l->data1, fa);
+        rx = (regex_t *) l->data1;
+
+        if((k = literal_prefix_len(rx)) == 0) {
+            regex_to_nfa_frag(&ctx, rx, &frag);
 
-        endstate = mkstate(fa);
-        l->done_num = endstate->done_num = ++n;
-        for(t = frag->final; t != NULL; t = t->next_fin)
-            t->dest = endstate;
+            endstate = mkstate(ctx.fa);
+            l->done_num = endstate->done_num = ++n;
+            patch_final(frag.final, endstate);
+
+            l->state = frag.init;
+        } else {
+            for(r = roots; r != NULL; r = r->next)
+                if(same_states(r->states, (lstr_list_t *) l->data2))
+                    break;
+
+            if(r == NULL) {
+                r = arena_alloc(ctx.scratch, 1, trie_root_t);
+                r->states = (lstr_list_t *) l->data2;
+                r->node.st = mkstate(ctx.fa);
+                r->node.child = NULL;
+                r->next = roots;
+                roots = r;
+            }
+
+            node = &r->node;
+            for(i = 0; i < k; ++i)
+                node = trie_child(&ctx, node, (rx->type == R_CHAR) ? rx->data.c
+                                     : rx->data.list.enc[i]->data.c);
+
+            endstate = mkstate(ctx.fa);
+            l->done_num = endstate->done_num = ++n;
+
+            if(rx->type == R_CHAR || k == rx->data.list.n_enc)
+                mktrans(ctx.fa, node->st, endstate, CLS_NIL);
+            else {
+                /* The rest of the pattern hangs off the trie */
+                rest.type = R_CONCAT;
+                rest.data.list.enc = rx->data.list.enc + k;
+                rest.data.list.n_enc = rx->data.list.n_enc - k;
+                regex_to_nfa_frag(&ctx, &rest, &frag);
+                mktrans(ctx.fa, node->st, frag.init, CLS_NIL);
+                patch_final(frag.final, endstate);
+            }
 
-        l->state = frag->init;
+            l->state = r->node.st;
+        }
 
-        free(frag);
         l = l->next;
     }
 
-    return fa;
+    destroy_arena(ctx.scratch);
+
+    return ctx.fa;
 }
 
-static void calc_nil_closure(state_t *s, char *bitset)
+/*
+ * The position (Glushkov) automaton construction: every character position
+ * (R_CHAR, R_CLASS, or R_ANY leaf) in a regex becomes an NFA state, and the
+ * automaton for a regex with n positions has n+1 states and no nil
+ * transitions. The transitions into a position's state are all labelled with
+ * that position's set of characters.
+ */
+
+/* A set of positions (NFA states) */
+typedef struct {
+    state_t **s;
+    size_t n;
+    size_t array_sz;
+} pos_set_t;
+
+/* The first/last positions and nullability of a sub-regex */
+typedef struct {
+    pos_set_t first;
+    pos_set_t last;
+    int nullable;
+} gl_frag_t;
+
+/* Per-regex-set data for the construction */
+typedef struct {
+    fa_t *fa;
+    int *cls;       /* Class (as in intern_class) of the characters of each
+                     * position, indexed by state id */
+    size_t cls_sz;  /* Number of states cls has room for */
+} gl_ctx_t;
+
+static void pos_add(pos_set_t *set, state_t *st)
 {
-    trans_t *t;
-    int id = s->id;
+    state_t **new_s;
+
+    if(set->n >= set->array_sz) {
+        set->array_sz = set->array_sz * 2 + 4;
+        new_s = malloc_or_die(set->array_sz, state_t *);
+        if(set->n > 0)
+            memcpy(new_s, set->s, set->n * sizeof(state_t *));
+        free(set->s);
+        set->s = new_s;
+    }
 
-    bitset[id / CHAR_BIT] |= (1 << (id % CHAR_BIT));
+    set->s[set->n++] = st;
+}
 
-    for(t = s->trans; t != NULL; t = t->next) {
-        if(!t->is_nil)
-            continue;
-        id = t->dest->id;
-        if((bitset[id / CHAR_BIT] & (1 << (id % CHAR_BIT))) == 0)
-            calc_nil_closure(t->dest, bitset);
-    }
+/* Appends the contents of b to a (positions are never shared between
+ * sibling sub-regexes, so no duplicates arise) and empties b */
+static void pos_merge(pos_set_t *a, pos_set_t *b)
+{
+    size_t i;
+
+    for(i = 0; i < b->n; ++i)
+        pos_add(a, b->s[i]);
+
+    free(b->s);
+    b->s = NULL;
+    b->n = b->array_sz = 0;
 }
 
-static state_t * get_state(fa_list_t **state_map, len_string *state_set,
-                           state_t **nfa, fa_t *dfa, int *is_new)
+static void pos_copy(pos_set_t *dst, const pos_set_t *src)
 {
-    fa_list_t *l;
-    state_t *st;
-    size_t i, k;
-    int j, done_num = INT_MAX;
+    size_t i;
 
-    if(is_new != NULL)
-        *is_new = 0;
+    for(i = 0; i < src->n; ++i)
+        pos_add(dst, src->s[i]);
+}
 
-    for(l = *state_map; l != NULL; l = l->next)
-        if(lstr_eq((len_string *) l->data1, state_set))
-            return l->state;
+static void gl_frag_clear(gl_frag_t *g)
+{
+    free(g->first.s);
+    free(g->last.s);
+    g->first.s = g->last.s = NULL;
+    g->first.n = g->first.array_sz = g->last.n = g->last.array_sz = 0;
+    g->nullable = 1;
+}
 
-    /* If we get here, the state isn't already in the list, so we make it: */
-    if(is_new != NULL)
-        *is_new = 1;
-    st = mkstate(dfa);
+/* Adds a transition from st into the position dest, unless there already is
+ * one */
+static void gl_follow(gl_ctx_t *ctx, state_t *st, state_t *dest)
+{
+    trans_t *t;
 
-    for(i = 0; i < state_set->len; ++i) {
-        if(state_set->s[i] == 0)
-            continue;
+    for(t = st->trans; t != NULL; t = t->next)
+        if(t->dest == dest)
+            return;
 
-        for(j = 0; j < CHAR_BIT; ++j)
-            if(state_set->s[i] & (1 << j)) {
-                k = i * CHAR_BIT + j;
-                if(nfa[k]->done_num != 0 && nfa[k]->done_num < done_num)
-                    done_num = nfa[k]->done_num;
-            }
-    }
-    if(done_num != INT_MAX)
-        st->done_num = done_num;
+    mktrans(ctx->fa, st, dest, ctx->cls[dest->id]);
+}
 
-    l = malloc_or_die(1, fa_list_t);
-    l->state = st;
-    l->data1 = lstrcat(state_set, NULL);
-    l->next = *state_map;
-    *state_map = l;
+/* Adds transitions from every position in from to every position in to */
+static void gl_follow_all(gl_ctx_t *ctx, const pos_set_t *from,
+                          const pos_set_t *to)
+{
+    size_t i, j;
 
-    return st;
+    for(i = 0; i < from->n; ++i)
+        for(j = 0; j < to->n; ++j)
+            gl_follow(ctx, from->s[i], to->s[j]);
 }
 
-static void set_or(char *a, const char *b, size_t str_size)
+/* The concatenation g = g followed by h; h is emptied */
+static void gl_concat(gl_ctx_t *ctx, gl_frag_t *g, gl_frag_t *h)
 {
-    size_t i;
+    gl_follow_all(ctx, &g->last, &h->first);
+
+    if(g->nullable)
+        pos_copy(&g->first, &h->first);
+
+    if(h->nullable)
+        pos_merge(&h->last, &g->last);
+    else {
+        free(g->last.s);
+        g->last.n = g->last.array_sz = 0;
+        g->last.s = NULL;
+    }
+    g->last = h->last;
+    h->last.s = NULL;
+
+    g->nullable = g->nullable && h->nullable;
+    gl_frag_clear(h);
+}
 
-    for(i = 0; i < str_size; ++i)
-        a[i] |= b[i];
+/* The alternation g = g | h; h is emptied */
+static void gl_option(gl_frag_t *g, gl_frag_t *h)
+{
+    pos_merge(&g->first, &h->first);
+    pos_merge(&g->last, &h->last);
+    g->nullable = g->nullable || h->nullable;
 }
 
-static state_t * nfa_to_dfa(len_string *state_set, fa_t *dfa,
-                            fa_list_t **state_map, size_t str_size,
-                            const char *nil_closures, state_t **nfa,
-int depth)
+static void regex_to_gl_frag(gl_ctx_t *ctx, const regex_t *rx, gl_frag_t *g)
 {
-    int is_new, i, k, is_nonempty_set;
-    size_t j, n_unpacked = 0;
-    state_t *dfa_init;
-    len_string *set = mk_blank_lstring(str_size);
-    state_t **unpacked = malloc_or_die(str_size * CHAR_BIT, state_t *);
+    gl_frag_t sub;
     state_t *st;
-    trans_t *t;
+    regex_t dummy;
+    unsigned int cond[CLASS_SZ];
+    int i;
 
-    dfa_init = get_state(state_map, state_set, nfa, dfa, &is_new);
+    g->first.s = g->last.s = NULL;
+    g->first.n = g->first.array_sz = g->last.n = g->last.array_sz = 0;
+    g->nullable = 1;
 
-/*printf("%d ", depth);
-for(j = 0; j < str_size; ++j)
-printf("%02x", state_set->s[j] & 0xff);
-printf("\n");
-if(!is_new) printf("<-\n");*/
+    switch(rx->type) {
+      case R_CHAR:
+      case R_CLASS:
+      case R_ANY:
+        st = mkstate(ctx->fa);
+        if((size_t) st->id >= ctx->cls_sz) {
+            int *new_cls;
+
+            ctx->cls_sz = ctx->cls_sz * 2 + 64;
+            new_cls = malloc_or_die(ctx->cls_sz, int);
+            if(ctx->cls != NULL)
+                memcpy(new_cls, ctx->cls, st->id * sizeof(int));
+            free(ctx->cls);
+            ctx->cls = new_cls;
+        }
+        regex_leaf_set(rx, cond);
+        ctx->cls[st->id] = intern_class(ctx->fa, cond);
 
-    if(is_new) {
-        set = mk_blank_lstring(str_size);
-        unpacked = malloc_or_die(str_size * CHAR_BIT, state_t *);
+        pos_add(&g->first, st);
+        pos_add(&g->last, st);
+        g->nullable = 0;
+        break;
 
-        for(j = 0; j < str_size; ++j) {
-            if(!state_set->s[j])
-                continue;
-            for(k = 0; k < CHAR_BIT; ++k)
-                if(state_set->s[j] & (1 << k))
-                    unpacked[n_unpacked++] = nfa[j * CHAR_BIT + k];
+      case R_OPTION:
+        g->nullable = 0;
+        for(i = 0; i < rx->data.list.n_enc; ++i) {
+            regex_to_gl_frag(ctx, rx->data.list.enc[i], &sub);
+            gl_option(g, &sub);
         }
-/*printf("u %zu\n", n_unpacked);*/
+        break;
 
-        for(i = 0; i < 256; ++i) {
-/*printf("c %d\n", i);*/
-            memset(set->s, 0, str_size);
-            is_nonempty_set = 0;
-
-            for(j = 0; j < n_unpacked; ++j) {
-                for(t = unpacked[j]->trans; t != NULL; t = t->next)
-                    if(!t->is_nil &&
-                       (t->cond[i / ML_UINT_BIT] & (1 << (i % ML_UINT_BIT)))
-                        != 0) {
-/*printf("x %d %zu\n", i, j);*/
-                        k = t->dest->id;
-                        set_or(set->s, nil_closures + (k * str_size), str_size);
-                        is_nonempty_set = 1;
-                    }
-            }
+      case R_CONCAT:
+        for(i = 0; i < rx->data.list.n_enc; ++i) {
+            regex_to_gl_frag(ctx, rx->data.list.enc[i], &sub);
+            gl_concat(ctx, g, &sub);
+        }
+        break;
 
-            if(is_nonempty_set) {
-                st = nfa_to_dfa(set, dfa, state_map, str_size, nil_closures,
-                                nfa,
-depth+1);
+      case R_MAYBE:
+      case R_STAR:
+      case R_PLUS:
+        regex_to_gl_frag(ctx, rx->data.enc, g);
+        if(rx->type != R_MAYBE)
+            gl_follow_all(ctx, &g->last, &g->first);
+        if(rx->type != R_PLUS)
+            g->nullable = 1;
+        break;
 
-                for(t = dfa_init->trans; t != NULL; t = t->next) {
-                    if(t->dest == st) {
-                        t->cond[i / ML_UINT_BIT] |= 1 << (i % ML_UINT_BIT);
-                        break;
-                    }
-                }
+      case R_NUM:
+        /* Each repetition gets its own copy of the enclosed positions */
+        i = 0;
 
-                if(t == NULL) { /* No pre-existing transitions to st */
-                    t = mktrans(dfa_init, st);
-                    t->cond[i / ML_UINT_BIT] |= 1 << (i % ML_UINT_BIT);
-                }
+        if(rx->data.num.min != -1) {
+            for(; i < rx->data.num.min; ++i) {
+                regex_to_gl_frag(ctx, rx->data.num.enc, &sub);
+                gl_concat(ctx, g, &sub);
             }
         }
 
-        free(set);
-        free(unpacked);
-    }
+        dummy.type = (rx->data.num.max != -1) ? R_MAYBE : R_STAR;
+        dummy.data.enc = rx->data.num.enc;
+
+        if(rx->data.num.max != -1) {
+            for(; i < rx->data.num.max; ++i) {
+                regex_to_gl_frag(ctx, &dummy, &sub);
+                gl_concat(ctx, g, &sub);
+            }
+        } else {
+            regex_to_gl_frag(ctx, &dummy, &sub);
+            gl_concat(ctx, g, &sub);
+        }
+        break;
+
+      case R_ZERO:
+        break;
 
-    return dfa_init;
+      case R_PAREN:
+        fprintf(stderr, __FILE__ ":%d: R_PAREN shouldn\'t be in a regex!\n",
+                __LINE__);
+        exit(1);
+    }
 }
 
-/* nfa_list->data2 is interpreted as a lstr_list_t * of start states, and
- * dfa_list->data1 is interpreted as a len_string * start-state name. */
-fa_t * nfas_to_dfas(fa_t *nfa, fa_list_t *nfa_list, fa_list_t *dfa_list)
+/* Like multi_regex_compile, but builds the position automaton for each
+ * regex, so the resulting NFA contains no nil-transitions. Each regex's
+ * positions are the states marked with its done_num, along with its initial
+ * state if the regex matches the empty string. */
+fa_t * multi_regex_glushkov(fa_list_t *l)
 {
-    fa_list_t *pn, *pd;
-    state_t *initstate, *st;
-    trans_t *t;
-    fa_t *dfa = mkfa();
-    state_t **nfa_arr;
-    char *nil_closures;
-    fa_list_t *state_map = NULL;
-    fa_list_t *ptr, *next;
-    size_t set_size;
-    len_string *str;
+    gl_ctx_t ctx;
+    gl_frag_t g;
+    state_t *init;
+    size_t i;
+    int n = 0;
 
-    for(pd = dfa_list; pd != NULL; pd = pd->next) {
-/*fwrite( ((len_string *) (pd->data1))->s, 1, ((len_string *) (pd->data1))->len, stdout);
-fputs("\n", stdout);*/
-        pd->state = initstate = mkstate(nfa);
+    ctx.fa = mkfa();
+    ctx.cls = NULL;
+    ctx.cls_sz = 0;
 
-        for(pn = nfa_list; pn != NULL; pn = pn->next) {
-            if(pn->data2 != NULL &&
-               !lstr_in_list((len_string *) pd->data1,
-                             (lstr_list_t *) pn->data2))
-                continue;
+    while(l != NULL) {
+        init = mkstate(ctx.fa);
+        regex_to_gl_frag(&ctx, (regex_t *) l->data1, &g);
 
-            t = mktrans(initstate, pn->state);
-            t->is_nil = 1;
-        }
+        l->done_num = ++n;
+        l->state = init;
+
+        for(i = 0; i < g.first.n; ++i)
+            gl_follow(&ctx, init, g.first.s[i]);
+
+        for(i = 0; i < g.last.n; ++i)
+            g.last.s[i]->done_num = n;
+        if(g.nullable)
+            init->done_num = n;
+
+        gl_frag_clear(&g);
+        l = l->next;
     }
 
-    set_size = (nfa->n_states + CHAR_BIT - 1) / CHAR_BIT;
-    nil_closures = malloc_or_die(set_size * nfa->n_states, char);
-    memset(nil_closures, 0, set_size * nfa->n_states);
+    free(ctx.cls);
 
-    for(st = nfa->first; st != NULL; st = st->next)
-        calc_nil_closure(st, nil_closures + (st->id * set_size));
+    return ctx.fa;
+}
 
-    nfa_arr = malloc_or_die(nfa->n_states, state_t *);
-    for(st = nfa->first; st != NULL; st = st->next)
-        nfa_arr[st->id] = st;
+/* The nil-closures of all the states in an NFA. Rather than a dense
+ * n_states x n_states bit matrix, closures are computed once per strongly
+ * connected component of the nil-transition graph (every state in a component
+ * has the same closure) and stored as sorted lists of state ids shared by all
+ * the states of the component. */
+typedef struct {
+    int n_states;    /* Number of states in the NFA */
+    int n_comps;     /* Number of strongly connected components */
+    int *comp;       /* Component of each state, indexed by state id */
+    int **closure;   /* Sorted list of state ids in each component's closure */
+    int *closure_len; /* Length of each list in closure */
+    size_t n_entries; /* Total length of all the lists */
+} nil_closures_t;
+
+static int int_cmp(const void *a, const void *b)
+{
+    int x = *((const int *) a), y = *((const int *) b);
+
+    return (x > y) - (x < y);
+}
+
+/* Finishes off the component comp_id, whose member states are members[0]
+ * through members[n_members-1]: its closure is its members plus the closures
+ * of all components reachable by a single nil-transition, all of which have
+ * already been finished (Tarjan's algorithm yields components in reverse
+ * topological order). mark is scratch space, one int per state. */
+static void finish_component(nil_closures_t *nc, int comp_id,
+                             const int *members, int n_members,
+                             state_t **nfa, int *mark, int *scratch)
+{
+    int i, j, n = 0, other;
+    trans_t *t;
+    const int *cl;
 
-    for(pd = dfa_list; pd != NULL; pd = pd->next) {
-/*fputs("*", stdout);
-fwrite( ((len_string *) (pd->data1))->s, 1, ((len_string *) (pd->data1))->len, stdout);
-fputs("\n", stdout);*/
-        str = lstring_dupbuf(set_size,
-                             nil_closures + (pd->state->id * set_size));
-        pd->state = nfa_to_dfa(str, dfa, &state_map, set_size,
-                               nil_closures, nfa_arr,
-0);
-        free(str);
+    for(i = 0; i < n_members; ++i) {
+        mark[members[i]] = comp_id;
+        scratch[n++] = members[i];
     }
 
-    free(nil_closures);
-    free(nfa_arr);
-    for(ptr = state_map; ptr != NULL; ptr = next) {
-        free(ptr->data1);
-        next = ptr->next;
-        free(ptr);
+    for(i = 0; i < n_members; ++i) {
+        for(t = nfa[members[i]]->trans; t != NULL; t = t->next) {
+            if(!is_nil_trans(t))
+                continue;
+            other = nc->comp[t->dest->id];
+            if(other == comp_id)
+                continue;
+            cl = nc->closure[other];
+            for(j = 0; j < nc->closure_len[other]; ++j) {
+                if(mark[cl[j]] != comp_id) {
+                    mark[cl[j]] = comp_id;
+                    scratch[n++] = cl[j];
+                }
+            }
+        }
     }
 
-    return dfa;
+    qsort(scratch, n, sizeof(int), int_cmp);
+
+    nc->closure[comp_id] = malloc_or_die(n, int);
+    memcpy(nc->closure[comp_id], scratch, n * sizeof(int));
+    nc->closure_len[comp_id] = n;
+    nc->n_entries += n;
+}
+
+/* Returns 1 if any state in fa has a nil-transition, 0 otherwise */
+static int has_nil_trans(const fa_t *fa)
+{
+    const state_t *st;
+    const trans_t *t;
+
+    for(st = fa->first; st != NULL; st = st->next)
+        for(t = st->trans; t != NULL; t = t->next)
+            if(is_nil_trans(t))
+                return 1;
+
+    return 0;
+}
+
+/* Computes the nil-closures of all the states of nfa, using an iterative
+ * version of Tarjan's strongly-connected-components algorithm. nfa_arr maps
+ * state ids to states. Returns NULL if nfa has no nil-transitions (as with a
+ * position automaton), in which case every state's closure is itself. */
+static nil_closures_t * calc_nil_closures(fa_t *nfa, state_t **nfa_arr)
+{
+    nil_closures_t *nc;
+    int n = nfa->n_states;
+    int *index, *lowlink, *tstack, *cstack, *mark, *scratch;
+    trans_t **cnext;
+    int i, v, w, tsp = 0, csp, next_index = 0;
+    trans_t *t;
+
+    if(!has_nil_trans(nfa))
+        return NULL;
+
+    nc = malloc_or_die(1, nil_closures_t);
+    index = malloc_or_die(n, int);
+    lowlink = malloc_or_die(n, int);
+    tstack = malloc_or_die(n, int);          /* Tarjan's stack of states */
+    cstack = malloc_or_die(n, int);          /* DFS call stack of states */
+    cnext = malloc_or_die(n, trans_t *);     /* Per-frame iterator */
+    mark = malloc_or_die(n, int);
+    scratch = malloc_or_die(n, int);
+
+    nc->n_states = n;
+    nc->n_comps = 0;
+    nc->n_entries = 0;
+    nc->comp = malloc_or_die(n, int);
+    nc->closure = malloc_or_die(n, int *);
+    nc->closure_len = malloc_or_die(n, int);
+
+    for(i = 0; i < n; ++i) {
+        index[i] = -1;
+        mark[i] = -1;
+        nc->comp[i] = -1;
+    }
+
+    for(i = 0; i < n; ++i) {
+        if(index[i] != -1)
+            continue;
+
+        csp = 0;
+        cstack[csp] = i;
+        cnext[csp++] = nfa_arr[i]->trans;
+        index[i] = lowlink[i] = next_index++;
+        tstack[tsp++] = i;
+
+        while(csp > 0) {
+            v = cstack[csp - 1];
+
+            /* Advance to v's next unexplored nil-transition */
+            for(t = cnext[csp - 1]; t != NULL && !is_nil_trans(t); t = t->next)
+                ;
+
+            if(t != NULL) {
+                cnext[csp - 1] = t->next;
+                w = t->dest->id;
+
+                if(index[w] == -1) {
+                    index[w] = lowlink[w] = next_index++;
+                    tstack[tsp++] = w;
+                    cstack[csp] = w;
+                    cnext[csp++] = nfa_arr[w]->trans;
+                } else if(nc->comp[w] == -1 && index[w] < lowlink[v])
+                    lowlink[v] = index[w];
+                continue;
+            }
+
+            /* All of v's transitions have been explored */
+            if(lowlink[v] == index[v]) {
+                int start = tsp;
+
+                do {
+                    w = tstack[--start];
+                    nc->comp[w] = nc->n_comps;
+                } while(w != v);
+
+                finish_component(nc, nc->n_comps, tstack + start, tsp - start,
+                                 nfa_arr, mark, scratch);
+                ++nc->n_comps;
+                tsp = start;
+            }
+
+            if(--csp > 0) {
+                w = cstack[csp - 1];
+                if(lowlink[v] < lowlink[w])
+                    lowlink[w] = lowlink[v];
+            }
+        }
+    }
+
+    free(index);
+    free(lowlink);
+    free(tstack);
+    free(cstack);
+    free(cnext);
+    free(mark);
+    free(scratch);
+
+    return nc;
+}
+
+/* Returns the number of bytes used to store the closures in nc */
+static size_t nil_closures_size(const nil_closures_t *nc)
+{
+    if(nc == NULL)
+        return 0;
+
+    return sizeof(*nc) + nc->n_states * sizeof(int) +
+           nc->n_comps * (sizeof(int *) + sizeof(int)) +
+           nc->n_entries * sizeof(int);
+}
+
+static void destroy_nil_closures(nil_closures_t *nc)
+{
+    int i;
+
+    if(nc == NULL)
+        return;
+
+    for(i = 0; i < nc->n_comps; ++i)
+        free(nc->closure[i]);
+
+    free(nc->comp);
+    free(nc->closure);
+    free(nc->closure_len);
+    free(nc);
+}
+
+/* Sets the bits for the nil-closure of state id in the bitset set */
+static void add_nil_closure(char *set, const nil_closures_t *nc, int id)
+{
+    int c, i, k;
+    const int *cl;
+
+    if(nc == NULL) {
+        set[id / CHAR_BIT] |= (1 << (id % CHAR_BIT));
+        return;
+    }
+
+    c = nc->comp[id];
+    cl = nc->closure[c];
+
+    for(i = 0; i < nc->closure_len[c]; ++i) {
+        k = cl[i];
+        set[k / CHAR_BIT] |= (1 << (k % CHAR_BIT));
+    }
+}
+
+/* The DFA states built so far during subset construction, indexed by the set
+ * of NFA states each stands for */
+typedef struct {
+    size_t set_size;  /* Bytes in each set */
+    char *sets;       /* The set of each DFA state, by id */
+    state_t **states; /* Each DFA state, by id */
+    int *origin;      /* The start state (by position in the list) each DFA
+                       * state was first reached from */
+    int n;            /* Number of DFA states */
+    int array_sz;     /* Number of states the arrays have room for */
+    int *hash;        /* Open-addressed table of ids (-1 = free) */
+    int hash_sz;      /* A power of two */
+} state_map_t;
+
+static unsigned int set_hash(const char *set, size_t n)
+{
+    unsigned int h = 2166136261U;
+    size_t i;
+
+    for(i = 0; i < n; ++i)
+        h = (h ^ (unsigned char) set[i]) * 16777619U;
+
+    return h;
+}
+
+static size_t state_map_size(const state_map_t *m)
+{
+    return m->array_sz * (m->set_size + sizeof(state_t *) + sizeof(int)) +
+           m->hash_sz * sizeof(int);
+}
+
+static void grow_state_map_hash(state_map_t *m)
+{
+    int i, j, mask;
+
+    free(m->hash);
+    m->hash_sz *= 2;
+    m->hash = malloc_or_die(m->hash_sz, int);
+    mask = m->hash_sz - 1;
+
+    for(i = 0; i < m->hash_sz; ++i)
+        m->hash[i] = -1;
+
+    for(i = 0; i < m->n; ++i) {
+        for(j = set_hash(m->sets + i * m->set_size, m->set_size) & mask;
+            m->hash[j] != -1; j = (j + 1) & mask)
+            ;
+        m->hash[j] = i;
+    }
+}
+
+/* Returns the id of the DFA state for the set of NFA states state_set,
+ * making it (as first reached from the start state origin) if need be */
+static int get_state(state_map_t *m, const char *state_set, state_t **nfa,
+                     fa_t *dfa, int origin)
+{
+    state_t *st;
+    size_t i, k, set_size = m->set_size;
+    int h, j, mask = m->hash_sz - 1, done_num = INT_MAX;
+
+    for(h = set_hash(state_set, set_size) & mask; m->hash[h] != -1;
+        h = (h + 1) & mask)
+        if(!memcmp(m->sets + m->hash[h] * set_size, state_set, set_size))
+            return m->hash[h];
+
+    /* If we get here, the state isn't already in the map, so we make it: */
+    if(m->n >= m->array_sz) {
+        char *new_sets;
+        state_t **new_states;
+        int *new_origin;
+
+        m->array_sz = m->array_sz * 2 + 16;
+        new_sets = malloc_or_die(m->array_sz * set_size, char);
+        new_states = malloc_or_die(m->array_sz, state_t *);
+        new_origin = malloc_or_die(m->array_sz, int);
+        if(m->n > 0) {
+            memcpy(new_sets, m->sets, m->n * set_size);
+            memcpy(new_states, m->states, m->n * sizeof(state_t *));
+            memcpy(new_origin, m->origin, m->n * sizeof(int));
+        }
+        free(m->sets);
+        free(m->states);
+        free(m->origin);
+        m->sets = new_sets;
+        m->states = new_states;
+        m->origin = new_origin;
+    }
+
+    st = mkstate(dfa);
+
+    for(i = 0; i < set_size; ++i) {
+        if(state_set[i] == 0)
+            continue;
+
+        for(j = 0; j < CHAR_BIT; ++j)
+            if(state_set[i] & (1 << j)) {
+                k = i * CHAR_BIT + j;
+                if(nfa[k]->done_num != 0 && nfa[k]->done_num < done_num)
+                    done_num = nfa[k]->done_num;
+            }
+    }
+    if(done_num != INT_MAX)
+        st->done_num = done_num;
+
+    memcpy(m->sets + m->n * set_size, state_set, set_size);
+    m->states[m->n] = st;
+    m->origin[m->n] = origin;
+    m->hash[h] = m->n;
+
+    if(++m->n * 2 > m->hash_sz)
+        grow_state_map_hash(m);
+
+    return m->n - 1;
+}
+
+/* Adds the transitions out of DFA state k of m, making the DFA states they
+ * lead to */
+static void expand_state(state_map_t *m, int k, fa_t *dfa,
+                         const nil_closures_t *nil_closures,
+                         const fa_t *nfa_fa, state_t **nfa,
+                         state_t **unpacked, char *set)
+{
+    int i, j, c, n_unpacked = 0, is_nonempty_set;
+    size_t w, set_size = m->set_size;
+    const char *from_set = m->sets + k * set_size;
+    int char_dest[256]; /* The destination for each character, or -1 */
+    unsigned int cond[CLASS_SZ];
+    trans_t *t;
+
+    /* (from_set may move as states are added, so it's unpacked first) */
+    for(w = 0; w < set_size; ++w) {
+        if(!from_set[w])
+            continue;
+        for(j = 0; j < CHAR_BIT; ++j)
+            if(from_set[w] & (1 << j))
+                unpacked[n_unpacked++] = nfa[w * CHAR_BIT + j];
+    }
+
+    for(c = 0; c < 256; ++c) {
+        memset(set, 0, set_size);
+        is_nonempty_set = 0;
+        char_dest[c] = -1;
+
+        for(i = 0; i < n_unpacked; ++i) {
+            for(t = unpacked[i]->trans; t != NULL; t = t->next)
+                if(!is_nil_trans(t) &&
+                   (fa_cond(nfa_fa, t)[c / ML_UINT_BIT] &
+                    (1 << (c % ML_UINT_BIT))) != 0) {
+                    add_nil_closure(set, nil_closures, t->dest->id);
+                    is_nonempty_set = 1;
+                }
+        }
+
+        if(is_nonempty_set)
+            char_dest[c] = get_state(m, set, nfa, dfa, m->origin[k]);
+    }
+
+    /* One transition per destination, in order of first appearance */
+    for(c = 0; c < 256; ++c) {
+        if((j = char_dest[c]) == -1)
+            continue;
+
+        memset(cond, 0, sizeof(cond));
+        for(i = c; i < 256; ++i) {
+            if(char_dest[i] == j) {
+                cond[i / ML_UINT_BIT] |= 1 << (i % ML_UINT_BIT);
+                char_dest[i] = -1;
+            }
+        }
+
+        mktrans(dfa, m->states[k], m->states[j], intern_class(dfa, cond));
+    }
+}
+
+/* Counts, for each pattern of nfa_list, how many DFA states in m contain
+ * NFA states of that pattern, and for each start state how many DFA states
+ * were first reached from it, then reports the worst offenders */
+static void report_subset_blowup(const state_map_t *m, const fa_t *nfa,
+                                 fa_list_t *nfa_list, fa_list_t *dfa_list,
+                                 const fa_budget_t *budget, size_t bytes)
+{
+    int *owner = malloc_or_die(nfa->n_states, int);
+    int *stack = malloc_or_die(nfa->n_states, int);
+    int n_pats = 0, n_starts = 0, n_stack, i, j, k, id;
+    int *pat_counts, *seen, *start_counts, *pred, *pred_start, *mark;
+    int *acc, *acc_start, *acc_end;
+    fa_list_t *l;
+    state_t *st;
+    trans_t *t;
+    const char *set;
+
+    for(i = 0; i < nfa->n_states; ++i)
+        owner[i] = -1;
+
+    /* A pattern's NFA states are those from which only its accepting states
+     * (those with its done_num) can be reached; states shared by several
+     * patterns (such as those of a prefix trie) belong to none */
+    for(l = nfa_list; l != NULL; l = l->next)
+        ++n_pats;
+
+    pred_start = malloc_or_die(nfa->n_states + 1, int);
+    mark = malloc_or_die(nfa->n_states, int);
+
+    for(i = 0; i <= nfa->n_states; ++i)
+        pred_start[i] = 0;
+    for(st = nfa->first; st != NULL; st = st->next)
+        for(t = st->trans; t != NULL; t = t->next)
+            ++pred_start[t->dest->id + 1];
+    for(i = 0; i < nfa->n_states; ++i)
+        pred_start[i + 1] += pred_start[i];
+    pred = malloc_or_die(pred_start[nfa->n_states] + 1, int);
+    for(i = 0; i < nfa->n_states; ++i)
+        mark[i] = pred_start[i];
+    for(st = nfa->first; st != NULL; st = st->next)
+        for(t = st->trans; t != NULL; t = t->next)
+            pred[mark[t->dest->id]++] = st->id;
+
+    /* The accepting states, by pattern, laid out like pred */
+    acc = malloc_or_die(nfa->n_states + 1, int);
+    acc_start = malloc_or_die(n_pats + 1, int);
+    acc_end = malloc_or_die(n_pats + 1, int);
+
+    for(j = 0; j <= n_pats; ++j)
+        acc_start[j] = 0;
+    for(st = nfa->first; st != NULL; st = st->next)
+        if(st->done_num > 0 && st->done_num <= n_pats)
+            ++acc_start[st->done_num];
+    for(j = 0; j < n_pats; ++j)
+        acc_start[j + 1] += acc_start[j];
+    for(j = 0; j < n_pats; ++j)
+        acc_end[j] = acc_start[j];
+    for(st = nfa->first; st != NULL; st = st->next)
+        if(st->done_num > 0 && st->done_num <= n_pats)
+            acc[acc_end[st->done_num - 1]++] = st->id;
+
+    for(i = 0; i < nfa->n_states; ++i)
+        mark[i] = -1;
+
+    for(j = 0; j < n_pats; ++j) {
+        n_stack = 0;
+        for(k = acc_start[j]; k < acc_end[j]; ++k) {
+            mark[acc[k]] = j;
+            stack[n_stack++] = acc[k];
+        }
+
+        while(n_stack > 0) {
+            id = stack[--n_stack];
+            owner[id] = (owner[id] == -1 || owner[id] == j) ? j : -2;
+
+            for(k = pred_start[id]; k < pred_start[id + 1]; ++k) {
+                if(mark[pred[k]] != j) {
+                    mark[pred[k]] = j;
+                    stack[n_stack++] = pred[k];
+                }
+            }
+        }
+    }
+
+    free(pred);
+    free(pred_start);
+    free(mark);
+    free(acc);
+    free(acc_start);
+    free(acc_end);
+
+    for(l = dfa_list; l != NULL; l = l->next)
+        ++n_starts;
+
+    pat_counts = malloc_or_die(n_pats + 1, int);
+    seen = malloc_or_die(n_pats + 1, int);
+    start_counts = malloc_or_die(n_starts + 1, int);
+
+    for(i = 0; i < n_pats; ++i)
+        pat_counts[i] = 0, seen[i] = -1;
+    for(i = 0; i < n_starts; ++i)
+        start_counts[i] = 0;
+
+    for(k = 0; k < m->n; ++k) {
+        ++start_counts[m->origin[k]];
+        set = m->sets + k * m->set_size;
+
+        for(i = 0; i < nfa->n_states; ++i) {
+            if(!(set[i / CHAR_BIT] & (1 << (i % CHAR_BIT))) ||
+               (j = owner[i]) < 0 || seen[j] == k)
+                continue;
+            seen[j] = k;
+            ++pat_counts[j];
+        }
+    }
+
+    print_dfa_blowup(stderr, budget, m->n, bytes, nfa_list, pat_counts,
+                     dfa_list, start_counts);
+
+    free(owner);
+    free(stack);
+    free(pat_counts);
+    free(seen);
+    free(start_counts);
+}
+
+int over_budget(const fa_budget_t *budget, int n_states, size_t bytes)
+{
+    return budget != NULL &&
+           ((budget->max_states > 0 && n_states > budget->max_states) ||
+            (budget->max_bytes > 0 && bytes > budget->max_bytes));
+}
+
+/* Prints (up to) the n largest of counts[0..len-1] as lines of a report,
+ * with the corresponding entries of l */
+static void print_top_counts(FILE *f, fa_list_t *l, const int *counts,
+                             int len, int n, int is_pattern)
+{
+    char *done = malloc_or_die(len + 1, char);
+    fa_list_t *p;
+    len_string *name;
+    int i, best;
+
+    memset(done, 0, len + 1);
+
+    while(n-- > 0) {
+        best = -1;
+        for(i = 0; i < len; ++i)
+            if(!done[i] && counts[i] > 0 &&
+               (best == -1 || counts[i] > counts[best]))
+                best = i;
+
+        if(best == -1)
+            break;
+        done[best] = 1;
+
+        for(p = l, i = 0; i < best; ++i)
+            p = p->next;
+
+        if(is_pattern) {
+            fprintf(f, "  pattern %d (in %d states): ", best + 1,
+                    counts[best]);
+            print_regex(f, (regex_t *) p->data1);
+            fputc('\n', f);
+        } else {
+            name = (len_string *) p->data1;
+            fprintf(f, "  %.*s (%d states)\n", (int) name->len, name->s,
+                    counts[best]);
+        }
+    }
+
+    free(done);
+}
+
+void print_dfa_blowup(FILE *f, const fa_budget_t *budget, int n_states,
+                      size_t bytes, fa_list_t *patterns,
+                      const int *pat_counts, fa_list_t *start_states,
+                      const int *start_counts)
+{
+    fa_list_t *l;
+    int n_pats = 0, n_starts = 0;
+
+    for(l = patterns; l != NULL; l = l->next)
+        ++n_pats;
+    for(l = start_states; l != NULL; l = l->next)
+        ++n_starts;
+
+    if(budget->max_states > 0 && n_states > budget->max_states)
+        fprintf(f, "The DFA has more than the limit of %d states; "
+                "giving up.\n", budget->max_states);
+    else
+        fprintf(f, "The DFA (%d states so far) takes %lu bytes to build, "
+                "more than the limit of %lu; giving up.\n", n_states,
+                (unsigned long) bytes, (unsigned long) budget->max_bytes);
+
+    fputs("Patterns found in the most DFA states:\n", f);
+    print_top_counts(f, patterns, pat_counts, n_pats, 5, 1);
+    fputs("Start states the most DFA states are reached from:\n", f);
+    print_top_counts(f, start_states, start_counts, n_starts, 5, 0);
+}
+
+/* Runs the subset construction for the start states of dfa_list, given
+ * nfa's state array nfa_arr and nil-closures nil_closures. Those, and nfa,
+ * are only read, so several of these may run at once on the same NFA. */
+static fa_t * subset_construction(fa_t *nfa, state_t **nfa_arr,
+                                  nil_closures_t *nil_closures,
+                                  fa_list_t *nfa_list, fa_list_t *dfa_list,
+                                  const fa_budget_t *budget, FILE *verb)
+{
+    fa_list_t *pn, *pd;
+    fa_t *dfa = mkfa();
+    state_t **unpacked;
+    state_map_t m;
+    size_t set_size;
+    char *set;
+    int i, k;
+
+    set_size = (nfa->n_states + CHAR_BIT - 1) / CHAR_BIT;
+
+    m.set_size = set_size;
+    m.sets = NULL;
+    m.states = NULL;
+    m.origin = NULL;
+    m.n = m.array_sz = 0;
+    m.hash_sz = 64;
+    m.hash = malloc_or_die(m.hash_sz, int);
+    for(i = 0; i < m.hash_sz; ++i)
+        m.hash[i] = -1;
+
+    set = malloc_or_die(set_size + 1, char);
+    unpacked = malloc_or_die(nfa->n_states, state_t *);
+
+    for(pd = dfa_list, i = 0; pd != NULL; pd = pd->next, ++i) {
+        /* The initial DFA state for a start state is the union of the
+         * closures of the initial states of all the patterns active in it */
+        memset(set, 0, set_size);
+
+        for(pn = nfa_list; pn != NULL; pn = pn->next) {
+            if(pn->data2 != NULL &&
+               !lstr_in_list((len_string *) pd->data1,
+                             (lstr_list_t *) pn->data2))
+                continue;
+
+            add_nil_closure(set, nil_closures, pn->state->id);
+        }
+
+        k = get_state(&m, set, nfa_arr, dfa, i);
+        pd->state = m.states[k];
+    }
+
+    /* The DFA states are expanded in order of creation; m.n grows as new
+     * ones are found. */
+    for(k = 0; k < m.n; ++k) {
+        if(over_budget(budget, m.n, fa_size(dfa) + state_map_size(&m))) {
+            report_subset_blowup(&m, nfa, nfa_list, dfa_list, budget,
+                                 fa_size(dfa) + state_map_size(&m));
+            destroy_fa(dfa);
+            dfa = NULL;
+            break;
+        }
+
+        expand_state(&m, k, dfa, nil_closures, nfa, nfa_arr, unpacked, set);
+    }
+
+    if(verb != NULL && dfa != NULL)
+        fprintf(verb, "--- subset construction: %d DFA states, %lu bytes "
+                "of state sets\n", m.n, (unsigned long) state_map_size(&m));
+
+    free(unpacked);
+    free(set);
+    free(m.sets);
+    free(m.states);
+    free(m.origin);
+    free(m.hash);
+
+    return dfa;
+}
+
+/* Returns nfa's array of states by id, and sets *nil_closures */
+static state_t ** prepare_nfa(fa_t *nfa, nil_closures_t **nil_closures,
+                              FILE *verb)
+{
+    state_t **nfa_arr = malloc_or_die(nfa->n_states, state_t *);
+    state_t *st;
+    nil_closures_t *nc;
+
+    for(st = nfa->first; st != NULL; st = st->next)
+        nfa_arr[st->id] = st;
+
+    phase_start(PHASE_CLOSURE);
+    *nil_closures = nc = calc_nil_closures(nfa, nfa_arr);
+    phase_end(PHASE_CLOSURE);
+
+    if(verb != NULL) {
+        if(nc == NULL)
+            fprintf(verb, "--- nil-closures: %d NFA states, no "
+                    "nil-transitions\n", nfa->n_states);
+        else
+            fprintf(verb, "--- nil-closures: %d NFA states, %d components, "
+                    "%zu entries, %zu bytes\n", nfa->n_states,
+                    nc->n_comps, nc->n_entries, nil_closures_size(nc));
+    }
+
+    return nfa_arr;
+}
+
+/* nfa_list->data2 is interpreted as a lstr_list_t * of start states, and
+ * dfa_list->data1 is interpreted as a len_string * start-state name. If verb
+ * is non-NULL, statistics about the conversion are written to it. If the DFA
+ * outgrows budget (which may be NULL), the reasons are reported to stderr and
+ * NULL is returned. */
+fa_t * nfas_to_dfas(fa_t *nfa, fa_list_t *nfa_list, fa_list_t *dfa_list,
+                    const fa_budget_t *budget, FILE *verb)
+{
+    state_t **nfa_arr;
+    nil_closures_t *nil_closures;
+    fa_t *dfa;
+
+    nfa_arr = prepare_nfa(nfa, &nil_closures, verb);
+    dfa = subset_construction(nfa, nfa_arr, nil_closures, nfa_list, dfa_list,
+                              budget, verb);
+
+    destroy_nil_closures(nil_closures);
+    free(nfa_arr);
+
+    return dfa;
+}
+
+/* What the workers of nfas_to_dfa_parts share */
+typedef struct {
+    fa_t *nfa;
+    state_t **nfa_arr;
+    nil_closures_t *nil_closures;
+    fa_list_t *nfa_list;
+    fa_list_t **starts;  /* The start states, each a list of its own */
+    int n_starts;
+    const fa_budget_t *budget;
+    fa_t **parts;
+    pthread_mutex_t lock; /* Guards next and failed */
+    int next;             /* The next start state to be taken */
+    int failed;           /* Some DFA outgrew the budget */
+} parts_work_t;
+
+static void * parts_worker(void *arg)
+{
+    parts_work_t *w = arg;
+    int i;
+
+    for(;;) {
+        pthread_mutex_lock(&w->lock);
+        i = w->failed ? w->n_starts : w->next++;
+        pthread_mutex_unlock(&w->lock);
+
+        if(i >= w->n_starts)
+            break;
+
+        w->parts[i] = subset_construction(w->nfa, w->nfa_arr,
+                                          w->nil_closures, w->nfa_list,
+                                          w->starts[i], w->budget, NULL);
+
+        if(w->parts[i] == NULL) {
+            pthread_mutex_lock(&w->lock);
+            w->failed = 1;
+            pthread_mutex_unlock(&w->lock);
+        }
+    }
+
+    return NULL;
+}
+
+int nfas_to_dfa_parts(fa_t *nfa, fa_list_t *nfa_list, fa_list_t *dfa_list,
+                      const fa_budget_t *budget, int n_threads,
+                      fa_t **parts, FILE *verb)
+{
+    parts_work_t w;
+    pthread_t *threads;
+    fa_list_t *l, *one;
+    int i, n_started;
+
+    w.nfa = nfa;
+    w.nfa_list = nfa_list;
+    w.budget = budget;
+    w.parts = parts;
+    w.next = w.failed = 0;
+    w.nfa_arr = prepare_nfa(nfa, &w.nil_closures, verb);
+
+    for(w.n_starts = 0, l = dfa_list; l != NULL; l = l->next)
+        ++w.n_starts;
+
+    one = malloc_or_die(w.n_starts, fa_list_t);
+    w.starts = malloc_or_die(w.n_starts, fa_list_t *);
+    for(i = 0, l = dfa_list; l != NULL; l = l->next, ++i) {
+        one[i] = *l;
+        one[i].next = NULL;
+        w.starts[i] = &one[i];
+        parts[i] = NULL;
+    }
+
+    if(n_threads > w.n_starts)
+        n_threads = w.n_starts;
+
+    pthread_mutex_init(&w.lock, NULL);
+    threads = malloc_or_die(n_threads + 1, pthread_t);
+
+    /* The calling thread works too; if a thread can't be started, the
+     * others just take on more of the start states */
+    for(n_started = 0; n_started < n_threads - 1; ++n_started)
+        if(pthread_create(&threads[n_started], NULL, parts_worker, &w) != 0)
+            break;
+
+    parts_worker(&w);
+
+    for(i = 0; i < n_started; ++i)
+        pthread_join(threads[i], NULL);
+
+    pthread_mutex_destroy(&w.lock);
+
+    if(verb != NULL)
+        fprintf(verb, "--- subset construction: %d start states on %d "
+                "threads\n", w.n_starts, n_started + 1);
+
+    for(i = 0, l = dfa_list; l != NULL; l = l->next, ++i) {
+        l->state = one[i].state;
+        if(w.failed && parts[i] != NULL) {
+            destroy_fa(parts[i]);
+            parts[i] = NULL;
+        }
+    }
+
+    destroy_nil_closures(w.nil_closures);
+    free(w.nfa_arr);
+    free(w.starts);
+    free(one);
+    free(threads);
+
+    return !w.failed;
+}
+
+/* The parts' states are copied over in order, and their character classes
+ * interned afresh in the joined DFA */
+fa_t * merge_dfas(fa_t **parts, fa_list_t *dfa_list)
+{
+    fa_t *dfa = mkfa(), *p;
+    fa_list_t *l;
+    state_t **map, *s;
+    trans_t *t, **trans = NULL;
+    int *cls_map, i, j, n, trans_sz = 0;
+
+    for(l = dfa_list, i = 0; l != NULL; l = l->next, ++i) {
+        p = parts[i];
+
+        cls_map = malloc_or_die(p->n_classes + 1, int);
+        for(j = 0; j < p->n_classes; ++j)
+            cls_map[j] = intern_class(dfa, p->classes + j * CLASS_SZ);
+
+        map = malloc_or_die(p->n_states, state_t *);
+        for(s = p->first; s != NULL; s = s->next) {
+            map[s->id] = mkstate(dfa);
+            map[s->id]->done_num = s->done_num;
+        }
+
+        for(s = p->first; s != NULL; s = s->next) {
+            for(n = 0, t = s->trans; t != NULL; t = t->next)
+                ++n;
+            if(n > trans_sz) {
+                trans_sz = 2 * n;
+                free(trans);
+                trans = malloc_or_die(trans_sz, trans_t *);
+            }
+            for(n = 0, t = s->trans; t != NULL; t = t->next)
+                trans[n++] = t;
+
+            /* mktrans prepends, so this keeps the transitions in order */
+            for(j = n - 1; j >= 0; --j)
+                mktrans(dfa, map[s->id], map[trans[j]->dest->id],
+                        cls_map[trans[j]->cls]);
+        }
+
+        l->state = map[l->state->id];
+
+        free(map);
+        free(cls_map);
+        destroy_fa(p);
+    }
+
+    free(trans);
+    return dfa;
+}
+
+/* Numbers the n signatures (each len ints, in sigs) by first appearance,
+ * giving equal ones the same number, into block; returns how many numbers
+ * were used */
+static int number_signatures(const int *sigs, int n, int len, int *block)
+{
+    int *hash, hash_sz = 64, n_blocks = 0, i, j, h, *first;
+    unsigned int x;
+
+    while(hash_sz < 2 * n)
+        hash_sz *= 2;
+
+    hash = malloc_or_die(hash_sz, int);
+    first = malloc_or_die(n + 1, int); /* The first state of each block */
+    for(i = 0; i < hash_sz; ++i)
+        hash[i] = -1;
+
+    for(i = 0; i < n; ++i) {
+        x = 2166136261u;
+        for(j = 0; j < len; ++j)
+            x = (x ^ (unsigned int) sigs[i * len + j]) * 16777619u;
+
+        for(h = x & (hash_sz - 1); hash[h] != -1; h = (h + 1) & (hash_sz - 1))
+            if(!memcmp(sigs + i * len, sigs + first[hash[h]] * len,
+                       len * sizeof(int)))
+                break;
+
+        if(hash[h] == -1) {
+            first[n_blocks] = i;
+            hash[h] = n_blocks++;
+        }
+        block[i] = hash[h];
+    }
+
+    free(hash);
+    free(first);
+    return n_blocks;
+}
+
+/* Moore's algorithm: states start out told apart only by done_num, and are
+ * split up by the blocks their transitions lead to, on each class of bytes,
+ * until no more splits happen. Blocks are numbered in order of their first
+ * states, so the result doesn't depend on how the parts were built. */
+fa_t * minimize_dfa(fa_t *dfa, fa_list_t *dfa_list)
+{
+    int n = dfa->n_states, byte_map[256], rep[256], n_bytes, n_blocks, prev;
+    int *delta, *block, *sigs, *seen, *order, i, b, c, d, k, len;
+    state_t **arr, **new_st, *st;
+    const trans_t *t;
+    unsigned int *conds;
+    fa_t *min;
+    fa_list_t *l;
+
+    n_bytes = fa_byte_classes(dfa, byte_map);
+    for(c = 255; c >= 0; --c)
+        rep[byte_map[c]] = c;
+
+    arr = malloc_or_die(n, state_t *);
+    delta = malloc_or_die(n * n_bytes + 1, int);
+    block = malloc_or_die(n, int);
+    len = n_bytes + 1;
+    sigs = malloc_or_die(n * len, int);
+
+    for(st = dfa->first; st != NULL; st = st->next) {
+        arr[st->id] = st;
+        for(c = 0; c < n_bytes; ++c)
+            delta[st->id * n_bytes + c] = -1;
+        for(t = st->trans; t != NULL; t = t->next)
+            for(c = 0; c < n_bytes; ++c)
+                if(fa_cond(dfa, t)[rep[c] / ML_UINT_BIT] &
+                   (1u << (rep[c] % ML_UINT_BIT)))
+                    delta[st->id * n_bytes + c] = t->dest->id;
+    }
+
+    for(i = 0; i < n; ++i)
+        sigs[i] = arr[i]->done_num;
+    n_blocks = number_signatures(sigs, n, 1, block);
+
+    do {
+        prev = n_blocks;
+        for(i = 0; i < n; ++i) {
+            sigs[i * len] = block[i];
+            for(c = 0; c < n_bytes; ++c)
+                sigs[i * len + 1 + c] = (delta[i * n_bytes + c] == -1) ? -1 :
+                                        block[delta[i * n_bytes + c]];
+        }
+        n_blocks = number_signatures(sigs, n, len, block);
+    } while(n_blocks != prev);
+
+    /* Build the new DFA from the first state of each block */
+    min = mkfa();
+    new_st = malloc_or_die(n_blocks, state_t *);
+    seen = malloc_or_die(n_blocks, int);
+    order = malloc_or_die(n_blocks, int);
+    conds = malloc_or_die(n_blocks * CLASS_SZ, unsigned int);
+
+    for(i = 0, b = 0; i < n; ++i) {
+        if(block[i] == b) {
+            new_st[b] = mkstate(min);
+            new_st[b]->done_num = arr[i]->done_num;
+            seen[b++] = -1;
+        }
+    }
+
+    for(i = 0, b = 0; i < n; ++i) {
+        if(block[i] != b)
+            continue;
+
+        /* Transitions to the same block are joined into one, in the place
+         * of the first of them */
+        for(k = 0, t = arr[i]->trans; t != NULL; t = t->next) {
+            d = block[t->dest->id];
+            if(seen[d] != b) {
+                seen[d] = b;
+                order[k++] = d;
+                memset(conds + d * CLASS_SZ, 0,
+                       CLASS_SZ * sizeof(unsigned int));
+            }
+            for(c = 0; c < CLASS_SZ; ++c)
+                conds[d * CLASS_SZ + c] |= fa_cond(dfa, t)[c];
+        }
+
+        /* mktrans prepends, so this keeps the transitions in order */
+        while(--k >= 0)
+            mktrans(min, new_st[b], new_st[order[k]],
+                    intern_class(min, conds + order[k] * CLASS_SZ));
+        ++b;
+    }
+
+    for(l = dfa_list; l != NULL; l = l->next)
+        l->state = new_st[block[l->state->id]];
+
+    free(arr);
+    free(delta);
+    free(block);
+    free(sigs);
+    free(new_st);
+    free(seen);
+    free(order);
+    free(conds);
+    destroy_fa(dfa);
+
+    return min;
+}
+
+/* Returns the state of lnfa standing for the nil-closure of the state id of
+ * the original NFA, making it (and pushing id onto the work stack) if need
+ * be */
+static state_t * lazy_state(fa_t *lnfa, state_t **map, int id, int *work,
+                            int *n_work)
+{
+    if(map[id] == NULL) {
+        map[id] = mkstate(lnfa);
+        work[(*n_work)++] = id;
+    }
+
+    return map[id];
+}
+
+fa_t * nfa_remove_nils(fa_t *nfa, fa_list_t *nfa_list)
+{
+    fa_t *lnfa = mkfa();
+    state_t **nfa_arr, **map, *st, *dest;
+    nil_closures_t *nc;
+    fa_list_t *pn;
+    trans_t *t;
+    const int *cl;
+    const unsigned int *cond;
+    int *work, *slot, *dests, n_work = 0, n_dests, one, cl_len;
+    int i, j, k, id, done_num;
+    unsigned int *conds;
+
+    nfa_arr = malloc_or_die(nfa->n_states, state_t *);
+    for(st = nfa->first; st != NULL; st = st->next)
+        nfa_arr[st->id] = st;
+
+    nc = calc_nil_closures(nfa, nfa_arr);
+
+    map = malloc_or_die(nfa->n_states, state_t *);
+    work = malloc_or_die(nfa->n_states, int);
+    slot = malloc_or_die(nfa->n_states, int);
+    dests = malloc_or_die(nfa->n_states, int);
+    conds = malloc_or_die(nfa->n_states * CLASS_SZ, unsigned int);
+
+    for(i = 0; i < nfa->n_states; ++i) {
+        map[i] = NULL;
+        slot[i] = -1;
+    }
+
+    for(pn = nfa_list; pn != NULL; pn = pn->next)
+        pn->state = lazy_state(lnfa, map, pn->state->id, work, &n_work);
+
+    /* Patterns' states come first, in order; the rest are numbered as found */
+    for(i = 0; i < n_work / 2; ++i) {
+        k = work[i];
+        work[i] = work[n_work - 1 - i];
+        work[n_work - 1 - i] = k;
+    }
+
+    while(n_work > 0) {
+        id = work[--n_work];
+
+        if(nc == NULL) {
+            one = id;
+            cl = &one;
+            cl_len = 1;
+        } else {
+            cl = nc->closure[nc->comp[id]];
+            cl_len = nc->closure_len[nc->comp[id]];
+        }
+
+        done_num = INT_MAX;
+        n_dests = 0;
+
+        for(i = 0; i < cl_len; ++i) {
+            st = nfa_arr[cl[i]];
+
+            if(st->done_num != 0 && st->done_num < done_num)
+                done_num = st->done_num;
+
+            for(t = st->trans; t != NULL; t = t->next) {
+                if(is_nil_trans(t))
+                    continue;
+
+                k = t->dest->id;
+                if(slot[k] < 0) {
+                    slot[k] = n_dests;
+                    dests[n_dests] = k;
+                    memset(conds + n_dests * CLASS_SZ, 0,
+                           CLASS_SZ * sizeof(unsigned int));
+                    ++n_dests;
+                }
+
+                cond = fa_cond(nfa, t);
+                for(j = 0; j < CLASS_SZ; ++j)
+                    conds[slot[k] * CLASS_SZ + j] |= cond[j];
+            }
+        }
+
+        if(done_num != INT_MAX)
+            map[id]->done_num = done_num;
+
+        for(i = 0; i < n_dests; ++i) {
+            dest = lazy_state(lnfa, map, dests[i], work, &n_work);
+            mktrans(lnfa, map[id], dest,
+                    intern_class(lnfa, conds + i * CLASS_SZ));
+            slot[dests[i]] = -1;
+        }
+    }
+
+    destroy_nil_closures(nc);
+    free(nfa_arr);
+    free(map);
+    free(work);
+    free(slot);
+    free(dests);
+    free(conds);
+
+    return lnfa;
+}
+
+int fa_byte_classes(const fa_t *fa, int *map)
+{
+    int next[256 * 2];
+    int i, k, n = 1, new_n;
+    const unsigned int *cond;
+
+    for(i = 0; i < 256; ++i)
+        map[i] = 0;
+
+    /* Split each class of bytes in two by each of the FA's sets in turn */
+    for(k = 0; k < fa->n_classes; ++k) {
+        cond = fa->classes + k * CLASS_SZ;
+        new_n = 0;
+
+        for(i = 0; i < 2 * n; ++i)
+            next[i] = -1;
+
+        for(i = 0; i < 256; ++i) {
+            int in = (cond[i / ML_UINT_BIT] & (1 << (i % ML_UINT_BIT))) != 0;
+            int *c = &next[map[i] * 2 + in];
+
+            if(*c < 0)
+                *c = new_n++;
+            map[i] = *c;
+        }
+
+        n = new_n;
+    }
+
+    return n;
+}
+
+void fa_dense_trans(const fa_t *fa, const int *map, int n_classes, int *next)
+{
+    const state_t *s;
+    const trans_t *t;
+    int i, c;
+
+    for(i = 0; i < fa->n_states * n_classes; ++i)
+        next[i] = -1;
+
+    for(s = fa->first; s != NULL; s = s->next)
+        for(t = s->trans; t != NULL; t = t->next)
+            for(c = 0; c < 256; ++c)
+                if(fa_cond(fa, t)[c / ML_UINT_BIT] &
+                   (1u << (c % ML_UINT_BIT)))
+                    next[s->id * n_classes + map[c]] = t->dest->id;
+}
+
+int fa_reachable(const fa_t *fa, const state_t *from)
+{
+    char *seen = malloc_or_die(fa->n_states, char);
+    const state_t **stack = malloc_or_die(fa->n_states, const state_t *);
+    const state_t *s;
+    const trans_t *t;
+    int n = 0, sp = 0;
+
+    memset(seen, 0, fa->n_states);
+    seen[from->id] = 1;
+    stack[sp++] = from;
+
+    while(sp > 0) {
+        s = stack[--sp];
+        ++n;
+        for(t = s->trans; t != NULL; t = t->next) {
+            if(!seen[t->dest->id]) {
+                seen[t->dest->id] = 1;
+                stack[sp++] = t->dest;
+            }
+        }
+    }
+
+    free(seen);
+    free(stack);
+    return n;
+}
+
+int fa_backup_states(const fa_t *fa, char *backs_up)
+{
+    const state_t **stack = malloc_or_die(fa->n_states, const state_t *);
+    char *seen = malloc_or_die(fa->n_states, char);
+    const state_t *s;
+    const trans_t *t;
+    int n = 0, sp = 0;
+
+    memset(seen, 0, fa->n_states);
+    memset(backs_up, 0, fa->n_states);
+
+    /* Everything reachable from a state with a match */
+    for(s = fa->first; s != NULL; s = s->next) {
+        if(s->done_num) {
+            seen[s->id] = 1;
+            stack[sp++] = s;
+        }
+    }
+
+    while(sp > 0) {
+        s = stack[--sp];
+        for(t = s->trans; t != NULL; t = t->next) {
+            if(!seen[t->dest->id]) {
+                seen[t->dest->id] = 1;
+                stack[sp++] = t->dest;
+            }
+            if(!t->dest->done_num && !backs_up[t->dest->id]) {
+                backs_up[t->dest->id] = 1;
+                ++n;
+            }
+        }
+    }
+
+    free(seen);
+    free(stack);
+    return n;
+}
+
+/* Writes the bytes of an example input, in double quotes */
+static void print_example(FILE *f, const unsigned char *s, int len)
+{
+    int i;
+
+    fputc('"', f);
+    for(i = 0; i < len; ++i) {
+        if(s[i] == '"' || s[i] == '\\')
+            fprintf(f, "\\%c", s[i]);
+        else if(s[i] >= 0x20 && s[i] < 0x7f)
+            fputc(s[i], f);
+        else
+            fprintf(f, "\\x%02x", s[i]);
+    }
+    fputc('"', f);
+}
+
+/* Writes pattern done_num of patterns, as its number and regex */
+static void print_pattern(FILE *f, const fa_list_t *patterns, int done_num)
+{
+    const fa_list_t *p;
+
+    for(p = patterns; p != NULL && p->done_num != done_num; p = p->next)
+        ;
+    fprintf(f, "%d (", done_num);
+    if(p != NULL)
+        print_regex(f, (regex_t *) p->data1);
+    fputc(')', f);
+}
+
+int print_backup_report(FILE *f, const fa_t *fa, const fa_list_t *patterns,
+                        const fa_list_t *start_states)
+{
+    char *backs_up = malloc_or_die(fa->n_states, char);
+    char *seen = malloc_or_die(2 * fa->n_states, char);
+    char *live = malloc_or_die(fa->n_states, char);
+    const state_t **states = malloc_or_die(fa->n_states, const state_t *);
+    const state_t **stack = malloc_or_die(fa->n_states, const state_t *);
+    char *can_match;
+    /* The breadth-first search for example inputs is over (state, whether a
+     * match has been passed) pairs, numbered 2 * id + passed */
+    int *queue = malloc_or_die(2 * fa->n_states, int);
+    int *from = malloc_or_die(2 * fa->n_states, int);
+    int *origin = malloc_or_die(2 * fa->n_states, int);
+    unsigned char *by = malloc_or_die(2 * fa->n_states, unsigned char);
+    unsigned char *path = malloc_or_die(2 * fa->n_states, unsigned char);
+    const fa_list_t *l;
+    const len_string *name;
+    const state_t *s;
+    const trans_t *t;
+    int n, head = 0, tail = 0, node, next, c, i, len, matched, done_num, sp;
+    int n_patterns = 0;
+
+    n = fa_backup_states(fa, backs_up);
+
+    /* Which patterns are matched in the states reachable from one that backs
+     * up, indexed by done_num */
+    for(l = patterns; l != NULL; l = l->next)
+        if(l->done_num > n_patterns)
+            n_patterns = l->done_num;
+    can_match = malloc_or_die(n_patterns + 1, char);
+
+    for(s = fa->first; s != NULL; s = s->next)
+        states[s->id] = s;
+
+    memset(seen, 0, 2 * fa->n_states);
+    for(l = start_states, i = 0; l != NULL; l = l->next, ++i) {
+        node = 2 * l->state->id + (l->state->done_num != 0);
+        if(!seen[node]) {
+            seen[node] = 1;
+            from[node] = -1;
+            origin[node] = i;
+            queue[tail++] = node;
+        }
+    }
+
+    while(head < tail) {
+        node = queue[head++];
+        for(t = states[node / 2]->trans; t != NULL; t = t->next) {
+            next = 2 * t->dest->id + ((node & 1) || t->dest->done_num);
+            if(seen[next])
+                continue;
+
+            for(c = 0; !(fa_cond(fa, t)[c / ML_UINT_BIT] &
+                         (1 << (c % ML_UINT_BIT))); ++c)
+                ;
+            seen[next] = 1;
+            from[next] = node;
+            origin[next] = origin[node];
+            by[next] = (unsigned char) c;
+            queue[tail++] = next;
+        }
+    }
+
+    for(s = fa->first; s != NULL; s = s->next) {
+        if(!backs_up[s->id])
+            continue;
+
+        fprintf(f, "State %d has no match, but can be reached after one:\n",
+                s->id);
+
+        /* The shortest input leading here past a match, and the last match
+         * on the way, which is where the lexer backs up to */
+        node = 2 * s->id + 1;
+        for(len = 0; from[node] >= 0; node = from[node])
+            path[len++] = by[node];
+        for(i = 0; i < len / 2; ++i) {
+            c = path[i];
+            path[i] = path[len - 1 - i];
+            path[len - 1 - i] = (unsigned char) c;
+        }
+
+        for(l = start_states, i = 0; i < origin[2 * s->id + 1]; ++i)
+            l = l->next;
+        name = (const len_string *) l->data1;
+        node = l->state->id;
+        for(i = 0, matched = 0, done_num = l->state->done_num; i < len; ++i) {
+            for(t = states[node]->trans; t != NULL; t = t->next)
+                if(fa_cond(fa, t)[path[i] / ML_UINT_BIT] &
+                   (1 << (path[i] % ML_UINT_BIT)))
+                    break;
+            node = t->dest->id;
+            if(t->dest->done_num) {
+                matched = i + 1;
+                done_num = t->dest->done_num;
+            }
+        }
+
+        fprintf(f, "  e.g. in start state %.*s, ", (int) name->len, name->s);
+        print_example(f, path, matched);
+        fputs(" matches pattern ", f);
+        print_pattern(f, patterns, done_num);
+        fputs(", but then ", f);
+        print_example(f, path + matched, len - matched);
+        fputs(" could only be the start of a longer match\n", f);
+
+        /* The patterns that could still match, by which matches are
+         * reachable from here */
+        memset(live, 0, fa->n_states);
+        memset(can_match, 0, n_patterns + 1);
+        live[s->id] = 1;
+        stack[0] = s;
+        for(sp = 1; sp > 0; ) {
+            for(t = stack[--sp]->trans; t != NULL; t = t->next) {
+                if(!live[t->dest->id]) {
+                    live[t->dest->id] = 1;
+                    if(t->dest->done_num <= n_patterns)
+                        can_match[t->dest->done_num] = 1;
+                    stack[sp++] = t->dest;
+                }
+            }
+        }
+
+        fputs("  patterns that could still match:", f);
+        for(l = patterns; l != NULL; l = l->next) {
+            if(l->done_num > 0 && can_match[l->done_num]) {
+                fputs("\n    ", f);
+                print_pattern(f, patterns, l->done_num);
+            }
+        }
+        fputc('\n', f);
+    }
+
+    if(n == 0)
+        fputs("No backing up: the lexer never scans a character twice.\n", f);
+    else
+        fprintf(f, "%d state%s back%s up.\n", n, (n == 1) ? "" : "s",
+                (n == 1) ? "s" : "");
+
+    free(backs_up);
+    free(seen);
+    free(live);
+    free(can_match);
+    free(states);
+    free(stack);
+    free(queue);
+    free(from);
+    free(origin);
+    free(by);
+    free(path);
+    return n;
 }
 
 void print_fa(FILE *f, fa_t *fa, const char *name)
 {
     state_t *st;
     trans_t *tr;
+    const unsigned int *cond;
     int i, j, k;
 
     if(fa == NULL) {
@@ -564,14 +2350,15 @@ void print_fa(FILE *f, fa_t *fa, const char *name)
         for(tr = st->trans; tr != NULL; tr = tr->next) {
             fprintf(f, "  st%d -> st%d [label=\"", st->id,
                        (tr->dest != NULL) ? tr->dest->id : -1);
-            if(tr->is_nil)
+            if(is_nil_trans(tr))
                 fputs("[nil]", f);
             else {
+                cond = fa_cond(fa, tr);
                 for(i = 0; i < CLASS_SZ; ++i) {
-                    if(!tr->cond[i])
+                    if(!cond[i])
                         continue;
                     for(j = 0; j < ML_UINT_BIT; ++j) {
-                        if(!(tr->cond[i] & (1 << j)))
+                        if(!(cond[i] & (1 << j)))
                             continue;
                         k = (i * ML_UINT_BIT) + j;
                         if(k == 10)
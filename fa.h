@@ -22,21 +22,23 @@
 
 typedef struct state_str state_t;
 
-/* A transition between states */
+/* A transition between states. The set of characters that trigger a
+ * transition is kept in its FA's table of character classes, so that the
+ * (many) transitions on the same set share one copy of it. */
 struct transition {
-    int is_nil;                  /* Is this a nil-transition (typically denoted
-                                  * by epsilon; a transition in an NFA that
-                                  * always happens and consumes no chars) */
-    unsigned int cond[CLASS_SZ]; /* The set of characters that trigger this
-                                  * transition */
-    state_t *dest;               /* The state this transition goes to */
-    struct transition *next;     /* Next transition in a list */
-    struct transition *next_fin; /* Next transition in the list of final
-                                  * transitions for this NFA fragment */
+    state_t *dest;           /* The state this transition goes to */
+    struct transition *next; /* Next transition in a list */
+    int cls;                 /* Index of the set of characters that trigger
+                              * this transition in the FA's class table, or
+                              * CLS_NIL for a nil-transition (typically
+                              * denoted by epsilon; a transition in an NFA
+                              * that always happens and consumes no chars) */
 };
 
 typedef struct transition trans_t;
 
+#define CLS_NIL (-1)
+
 /* A state in a finite automaton */
 struct state_str {
     int id;           /* Unique in the automaton in question */
@@ -46,19 +48,37 @@ struct state_str {
     state_t *next;    /* Next in the list of states in the automaton */
 };
 
-/* A finite automaton (NFA or DFA) */
+/* A finite automaton (NFA or DFA). States and transitions are allocated from
+ * the FA's arena and freed all at once by destroy_fa. */
 typedef struct {
     int n_states;    /* Number of states currently in the automaton */
+    int n_trans;     /* Number of transitions currently in the automaton */
     state_t *first;  /* First in the list of states in the automaton */
     state_t *last;   /* The current tail of the list of states */
+    arena_t *arena;  /* Where the states and transitions live */
+
+    unsigned int *classes; /* The distinct sets of characters used by
+                            * transitions, CLASS_SZ unsigned ints each */
+    int n_classes;
+    int classes_sz;        /* Number of sets classes has room for */
+    int *cls_hash;         /* Open-addressed index into classes (-1 = free) */
+    int cls_hash_sz;       /* A power of two */
 } fa_t;
 
-/* A fragment of an NFA corresponding to part of a regular expression */
-typedef struct {
-    fa_t *fa;       /* The NFA this fragment is a part of */
-    state_t *init;  /* The initial state of this fragment */
-    trans_t *final; /* The list of transitions out of this fragment */
-} fa_frag_t;
+/* Is t a nil-transition? */
+#define is_nil_trans(t) ((t)->cls == CLS_NIL)
+
+/* The set of characters (CLASS_SZ unsigned ints) triggering the non-nil
+ * transition t of the FA fa */
+#define fa_cond(fa, t) ((fa)->classes + (t)->cls * CLASS_SZ)
+
+/* The ways of turning a set of regexes into an NFA: */
+typedef enum {
+    ENGINE_THOMPSON, /* Thompson's construction (with nil-transitions) */
+    ENGINE_GLUSHKOV, /* The position automaton (no nil-transitions) */
+    ENGINE_DERIVATIVES /* No NFA; the DFA is built directly from the regexes
+                        * (see deriv.h) */
+} fa_engine;
 
 /* A list of FA start-states, with associated data: */
 typedef struct fa_list_struct {
@@ -71,10 +91,106 @@ typedef struct fa_list_struct {
     struct fa_list_struct *next;
 } fa_list_t;
 
+/* Limits on how big a DFA may get while it's being built (0 = no limit) */
+typedef struct {
+    int max_states;   /* Number of DFA states */
+    size_t max_bytes; /* Memory for the DFA and the bookkeeping to build it */
+} fa_budget_t;
+
+/* The following build automata piece by piece: a new, empty FA; a new state
+ * in fa; the class-table index of a set of characters in fa; and a new
+ * transition from s1 to s2 on the characters of class cls (or CLS_NIL). */
+fa_t * mkfa(void);
+state_t * mkstate(fa_t *fa);
+int intern_class(fa_t *fa, const unsigned int *cond);
+trans_t * mktrans(fa_t *fa, state_t *s1, state_t *s2, int cls);
+
 void destroy_fa(fa_t *fa);
+size_t fa_size(const fa_t *fa);
 fa_t * single_regex_compile(regex_t *rx, state_t **initstate);
 fa_t * multi_regex_compile(fa_list_t *l);
-fa_t * nfas_to_dfas(fa_t *nfa, fa_list_t *nfa_list, fa_list_t *dfa_list);
+fa_t * multi_regex_glushkov(fa_list_t *l);
+fa_t * nfas_to_dfas(fa_t *nfa, fa_list_t *nfa_list, fa_list_t *dfa_list,
+                    const fa_budget_t *budget, FILE *verb);
+
+/* Joins DFAs built for one start state each (parts[i] for the i-th start
+ * state of dfa_list, whose ->state points into it) into one DFA, moving
+ * dfa_list->state over; the parts are destroyed. */
+fa_t * merge_dfas(fa_t **parts, fa_list_t *dfa_list);
+
+/*
+ * Like nfas_to_dfas, but builds a DFA for each start state of dfa_list on its
+ * own, into parts[i] for the i-th, spread over n_threads threads (the calling
+ * one among them); the start states' DFAs can then be joined by merge_dfas.
+ * Returns 0 (with no parts left) if any of the DFAs outgrows budget.
+ */
+int nfas_to_dfa_parts(fa_t *nfa, fa_list_t *nfa_list, fa_list_t *dfa_list,
+                      const fa_budget_t *budget, int n_threads,
+                      fa_t **parts, FILE *verb);
+
+/* Returns a DFA accepting the same strings as dfa, with its states that no
+ * input can tell apart (the copies merge_dfas makes of states reachable from
+ * several start states, in particular) made one; dfa_list->state is updated,
+ * and dfa is destroyed. */
+fa_t * minimize_dfa(fa_t *dfa, fa_list_t *dfa_list);
+
+/* Has a DFA of n_states states, taking bytes bytes to build, outgrown
+ * budget (which may be NULL)? */
+int over_budget(const fa_budget_t *budget, int n_states, size_t bytes);
+
+/*
+ * Explains to f that a DFA outgrew budget, listing the patterns (data1 a
+ * regex_t *) found in the most DFA states and the start states (data1 a
+ * len_string * name) from which the most DFA states were reached, given the
+ * number of states for each in pat_counts and start_counts.
+ */
+void print_dfa_blowup(FILE *f, const fa_budget_t *budget, int n_states,
+                      size_t bytes, fa_list_t *patterns,
+                      const int *pat_counts, fa_list_t *start_states,
+                      const int *start_counts);
+
+/*
+ * Builds an NFA without nil-transitions that accepts the same strings as nfa,
+ * for simulating at scan time. Each of its states stands for the nil-closure
+ * of a state of nfa that is either a pattern's initial state (nfa_list->state,
+ * which is updated to point into the new NFA) or the destination of a non-nil
+ * transition; its transitions are those out of the whole closure, and its
+ * done_num is the least of the closure's.
+ */
+fa_t * nfa_remove_nils(fa_t *nfa, fa_list_t *nfa_list);
+
+/*
+ * Partitions the 256 byte values into classes that no transition of fa tells
+ * apart, storing each byte's class number in map[0..255]; returns the number
+ * of classes.
+ */
+int fa_byte_classes(const fa_t *fa, int *map);
+
+/* Fills next (fa->n_states * n_classes ints) with the state each state of the
+ * DFA fa goes to on each class of bytes given by map and n_classes (as from
+ * fa_byte_classes), or -1 where it has no transition. */
+void fa_dense_trans(const fa_t *fa, const int *map, int n_classes, int *next);
+
+/* Returns the number of states of fa reachable from from (itself included) */
+int fa_reachable(const fa_t *fa, const state_t *from);
+
+/*
+ * Marks in backs_up (fa->n_states chars, by state id) the states of the DFA
+ * fa that have no match but can be reached after one; a lexer stopping in
+ * one of those has to back up to the last match and scan the characters
+ * after it again. Returns how many there are.
+ */
+int fa_backup_states(const fa_t *fa, char *backs_up);
+
+/*
+ * Writes to f a report of the states fa_backup_states finds in the DFA fa,
+ * each with the shortest input reaching it from one of start_states (data1
+ * a len_string * name) and the patterns (data1 a regex_t *) it's part of
+ * matching. Returns how many states there are.
+ */
+int print_backup_report(FILE *f, const fa_t *fa, const fa_list_t *patterns,
+                        const fa_list_t *start_states);
+
 void print_fa(FILE *f, fa_t *fa, const char *name);
 
 #endif
@@ -0,0 +1,522 @@
+/*
+ * libmoonlime.c: Compiling patterns into a DFA and scanning with it at run
+ * time, without generating a lexer.
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#include "libmoonlime.h"
+
+#ifndef ML_STDARG_H
+#define ML_STDARG_H
+#include <stdarg.h>
+#endif
+
+#ifndef ML_STDIO_H
+#define ML_STDIO_H
+#include <stdio.h>
+#endif
+
+#ifndef ML_STDLIB_H
+#define ML_STDLIB_H
+#include <stdlib.h>
+#endif
+
+#ifndef ML_STRING_H
+#define ML_STRING_H
+#include <string.h>
+#endif
+
+#ifndef ML_UTILS_H
+#include "utils.h"
+#endif
+
+#ifndef ML_REGEX_H
+#include "regex.h"
+#endif
+
+#ifndef ML_FA_H
+#include "fa.h"
+#endif
+
+/* The largest count a counted repetition may have */
+#define MAX_REPEAT 100000000
+
+struct ml_dfa {
+    int n_states;
+    int n_classes;
+    int init;                   /* The initial state */
+    unsigned char classes[256]; /* The class of each byte */
+    int *next;                  /* n_states * n_classes next states, or -1 */
+    int *done;                  /* The pattern (from 1) each state accepts,
+                                 * or 0 */
+};
+
+/*
+ * Regexes are parsed by recursive descent, into the same trees as the lexer
+ * for specs (ml-lexer.l) builds; that lexer treats any mistake as fatal,
+ * while a library has to report it instead.
+ */
+typedef struct {
+    const char *s;
+    size_t pos;
+    const char *error; /* What's wrong with the pattern, or NULL */
+} rx_parser_t;
+
+static regex_t * parse_option(rx_parser_t *p);
+
+static void skip_space(rx_parser_t *p)
+{
+    while(p->s[p->pos] == ' ' || p->s[p->pos] == '\t' ||
+          p->s[p->pos] == '\n')
+        ++p->pos;
+}
+
+static int hex_value(char c)
+{
+    if(c >= '0' && c <= '9')
+        return c - '0';
+    if(c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+/* Reads the escape sequence at p->pos (just past the backslash) into *c;
+ * returns 0 if it's malformed */
+static int parse_escape(rx_parser_t *p, char *c)
+{
+    const char *s = p->s + p->pos;
+
+    switch(s[0]) {
+      case '\0':
+        p->error = "backslash at the end of the pattern";
+        return 0;
+
+      case 'x':
+        if(hex_value(s[1]) < 0 || hex_value(s[2]) < 0) {
+            p->error = "\\x without two hex digits";
+            return 0;
+        }
+        *c = (char) ((hex_value(s[1]) << 4) | hex_value(s[2]));
+        p->pos += 3;
+        return 1;
+
+      case 'n':
+        *c = '\n';
+        break;
+      case 't':
+        *c = '\t';
+        break;
+      default:
+        *c = s[0];
+    }
+
+    ++p->pos;
+    return 1;
+}
+
+static regex_t * parse_class(rx_parser_t *p)
+{
+    regex_t *rx;
+    char c;
+
+    if(p->s[p->pos] == '^') {
+        rx = mk_char_class_rx(1);
+        ++p->pos;
+    } else
+        rx = mk_char_class_rx(0);
+
+    while(p->s[p->pos] != ']') {
+        if(p->s[p->pos] == '\0') {
+            p->error = "[ without ]";
+            free_regex_tree(rx);
+            return NULL;
+        }
+
+        if(p->s[p->pos] == '\\') {
+            ++p->pos;
+            if(!parse_escape(p, &c)) {
+                free_regex_tree(rx);
+                return NULL;
+            }
+        } else
+            c = p->s[p->pos++];
+
+        add_to_char_class(rx, c);
+    }
+
+    ++p->pos;
+    return rx;
+}
+
+static regex_t * parse_atom(rx_parser_t *p)
+{
+    regex_t *rx;
+    char c = p->s[p->pos];
+
+    switch(c) {
+      case '.':
+        ++p->pos;
+        return mk_any_rx();
+
+      case '[':
+        ++p->pos;
+        return parse_class(p);
+
+      case '(':
+        ++p->pos;
+        if((rx = parse_option(p)) == NULL)
+            return NULL;
+        skip_space(p);
+        if(p->s[p->pos] != ')') {
+            p->error = "( without )";
+            free_regex_tree(rx);
+            return NULL;
+        }
+        ++p->pos;
+        return rx;
+
+      case '\\':
+        ++p->pos;
+        return parse_escape(p, &c) ? mk_char_rx(c) : NULL;
+
+      case '?':
+      case '*':
+      case '+':
+      case '{':
+        p->error = "repetition of nothing";
+        return NULL;
+
+      case ']':
+      case '}':
+      case '<':
+        p->error = "unescaped ], }, or <";
+        return NULL;
+
+      default:
+        ++p->pos;
+        return mk_char_rx(c);
+    }
+}
+
+/* Reads a count at p->pos, or sets *n to -1 if there's none there */
+static int parse_count(rx_parser_t *p, int *n)
+{
+    long v = -1;
+
+    while(p->s[p->pos] >= '0' && p->s[p->pos] <= '9') {
+        v = ((v < 0) ? 0 : 10 * v) + (p->s[p->pos++] - '0');
+        if(v > MAX_REPEAT) {
+            p->error = "repetition count too big";
+            return 0;
+        }
+    }
+
+    *n = (int) v;
+    return 1;
+}
+
+/* Reads a counted repetition {n}, {n,}, {,m}, or {n,m} at p->pos (just past
+ * the brace) into *min and *max */
+static int parse_braces(rx_parser_t *p, int *min, int *max)
+{
+    int comma = 0;
+
+    if(!parse_count(p, min))
+        return 0;
+
+    if(p->s[p->pos] == ',') {
+        comma = 1;
+        ++p->pos;
+        if(!parse_count(p, max))
+            return 0;
+    } else
+        *max = *min;
+
+    if(p->s[p->pos] != '}' || (*min < 0 && *max < 0) || (!comma && *min < 0)) {
+        p->error = "malformed counted repetition";
+        return 0;
+    }
+    ++p->pos;
+
+    if(*min >= 0 && *max >= 0 && *min > *max) {
+        p->error = "counted repetition with its minimum over its maximum";
+        return 0;
+    }
+
+    return 1;
+}
+
+static regex_t * parse_repeat(rx_parser_t *p)
+{
+    regex_t *rx = parse_atom(p);
+    int min, max;
+
+    while(rx != NULL) {
+        skip_space(p);
+
+        switch(p->s[p->pos]) {
+          case '?':
+            rx = mk_maybe_rx(rx);
+            break;
+          case '*':
+            rx = mk_star_rx(rx);
+            break;
+          case '+':
+            rx = mk_plus_rx(rx);
+            break;
+
+          case '{':
+            ++p->pos;
+            if(!parse_braces(p, &min, &max)) {
+                free_regex_tree(rx);
+                return NULL;
+            }
+            rx = mk_num_rx(rx, min, max);
+            continue;
+
+          default:
+            return rx;
+        }
+
+        ++p->pos;
+    }
+
+    return NULL;
+}
+
+static regex_t * parse_concat(rx_parser_t *p)
+{
+    regex_t *cat = NULL, *first = NULL, *rx;
+
+    for(;;) {
+        skip_space(p);
+        if(p->s[p->pos] == '\0' || p->s[p->pos] == '|' ||
+           p->s[p->pos] == ')')
+            break;
+
+        if((rx = parse_repeat(p)) == NULL) {
+            if(cat != NULL)
+                free_regex_tree(cat);
+            else if(first != NULL)
+                free_regex_tree(first);
+            return NULL;
+        }
+
+        if(first == NULL)
+            first = rx;
+        else {
+            if(cat == NULL) {
+                cat = mk_concat_rx(0);
+                add_enc_rx(cat, first);
+            }
+            add_enc_rx(cat, rx);
+        }
+    }
+
+    if(cat != NULL)
+        return cat;
+    return (first != NULL) ? first : mk_zero_rx();
+}
+
+static regex_t * parse_option(rx_parser_t *p)
+{
+    regex_t *opt, *rx = parse_concat(p);
+
+    if(rx == NULL || p->s[p->pos] != '|')
+        return rx;
+
+    opt = mk_option_rx();
+    add_enc_rx(opt, rx);
+
+    while(p->s[p->pos] == '|') {
+        ++p->pos;
+        if((rx = parse_concat(p)) == NULL) {
+            free_regex_tree(opt);
+            return NULL;
+        }
+        add_enc_rx(opt, rx);
+    }
+
+    return opt;
+}
+
+/* Parses the whole of the pattern s; returns NULL (setting p->error) if it's
+ * malformed */
+static regex_t * parse_pattern(rx_parser_t *p, const char *s)
+{
+    regex_t *rx;
+
+    p->s = s;
+    p->pos = 0;
+    p->error = NULL;
+
+    if((rx = parse_option(p)) == NULL)
+        return NULL;
+
+    if(p->s[p->pos] != '\0') { /* Only a stray ) stops parse_option early */
+        p->error = ") without (";
+        free_regex_tree(rx);
+        return NULL;
+    }
+
+    if(rx->type == R_ZERO) {
+        p->error = "empty pattern";
+        free_regex_tree(rx);
+        return NULL;
+    }
+
+    return rx;
+}
+
+static void set_error(char *err, size_t err_len, const char *fmt, ...)
+{
+    va_list ap;
+
+    if(err_len == 0)
+        return;
+
+    va_start(ap, fmt);
+    vsnprintf(err, err_len, fmt, ap);
+    va_end(ap);
+}
+
+ml_dfa * ml_compile(const char * const *patterns, int n, int max_states,
+                    char *err, size_t err_len)
+{
+    fa_list_t *rxl, start;
+    rx_parser_t p;
+    fa_budget_t budget;
+    fa_t *nfa, *dfa;
+    state_t *s;
+    ml_dfa *d;
+    int map[256], i;
+
+    if(n < 1) {
+        set_error(err, err_len, "no patterns");
+        return NULL;
+    }
+
+    rxl = malloc_or_die(n, fa_list_t);
+
+    for(i = 0; i < n; ++i) {
+        if((rxl[i].data1 = parse_pattern(&p, patterns[i])) == NULL) {
+            set_error(err, err_len, "pattern %d, at offset %lu: %s", i,
+                      (unsigned long) p.pos, p.error);
+            while(--i >= 0)
+                free_regex_tree((regex_t *) rxl[i].data1);
+            free(rxl);
+            return NULL;
+        }
+
+        rxl[i].data1 = simplify_regex((regex_t *) rxl[i].data1);
+        rxl[i].data2 = NULL; /* Every pattern applies everywhere */
+        rxl[i].done_num = i + 1;
+        rxl[i].state = NULL;
+        rxl[i].next = (i < n - 1) ? &rxl[i+1] : NULL;
+    }
+
+    /* One start state, which every pattern applies in */
+    start.state = NULL;
+    start.data1 = lstring_dupbuf(1, "A");
+    start.next = NULL;
+
+    budget.max_states = max_states;
+    budget.max_bytes = 0;
+
+    nfa = multi_regex_compile(rxl);
+    dfa = nfas_to_dfas(nfa, rxl, &start, &budget, NULL);
+    destroy_fa(nfa);
+
+    for(i = 0; i < n; ++i)
+        free_regex_tree((regex_t *) rxl[i].data1);
+    free(rxl);
+
+    if(dfa == NULL) {
+        set_error(err, err_len, "the DFA has more than %d states",
+                  max_states);
+        free(start.data1);
+        return NULL;
+    }
+
+    dfa = minimize_dfa(dfa, &start);
+
+    d = malloc_or_die(1, ml_dfa);
+    d->n_states = dfa->n_states;
+    d->n_classes = fa_byte_classes(dfa, map);
+    d->init = start.state->id;
+    for(i = 0; i < 256; ++i)
+        d->classes[i] = (unsigned char) map[i];
+
+    d->next = malloc_or_die(d->n_states * d->n_classes, int);
+    fa_dense_trans(dfa, map, d->n_classes, d->next);
+
+    d->done = malloc_or_die(d->n_states, int);
+    for(s = dfa->first; s != NULL; s = s->next)
+        d->done[s->id] = s->done_num;
+
+    destroy_fa(dfa);
+    free(start.data1);
+    return d;
+}
+
+void ml_free(ml_dfa *dfa)
+{
+    if(dfa == NULL)
+        return;
+
+    free(dfa->next);
+    free(dfa->done);
+    free(dfa);
+}
+
+int ml_dfa_states(const ml_dfa *dfa)
+{
+    return dfa->n_states;
+}
+
+size_t ml_match_prefix(const ml_dfa *dfa, const char *buf, size_t len,
+                       int *rule)
+{
+    size_t i, best = 0;
+    int s = dfa->init, best_rule = 0;
+
+    /* As in the generated lexers, the initial state's own pattern (one
+     * matching the empty string) never counts */
+    for(i = 0; i < len; ++i) {
+        s = dfa->next[s * dfa->n_classes +
+                      dfa->classes[(unsigned char) buf[i]]];
+        if(s < 0)
+            break;
+        if(dfa->done[s]) {
+            best_rule = dfa->done[s];
+            best = i + 1;
+        }
+    }
+
+    if(best > 0)
+        *rule = best_rule - 1;
+    return best;
+}
+
+size_t ml_scan(const ml_dfa *dfa, const char *buf, size_t len, ml_match *out,
+               size_t max, size_t *end)
+{
+    size_t pos = 0, n = 0, mlen;
+    int rule;
+
+    while(pos < len && n < max &&
+          (mlen = ml_match_prefix(dfa, buf + pos, len - pos, &rule)) > 0) {
+        out[n].rule = rule;
+        out[n].start = pos;
+        out[n].end = pos + mlen;
+        ++n;
+        pos += mlen;
+    }
+
+    if(end != NULL)
+        *end = pos;
+    return n;
+}
@@ -0,0 +1,63 @@
+/*
+ * libmoonlime.h: Compiling patterns into a DFA and scanning with it at run
+ * time, without generating a lexer.
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#ifndef LIBMOONLIME_H
+#define LIBMOONLIME_H
+
+#include <stddef.h>
+
+#define ML_LIB_VERSION 1
+
+/* A compiled set of patterns; it isn't changed by scanning, so one may be
+ * used by any number of threads at once */
+typedef struct ml_dfa ml_dfa;
+
+/* A match of the pattern numbered rule (its index in the list given to
+ * ml_compile) on the bytes [start, end) of the buffer scanned */
+typedef struct {
+    int rule;
+    size_t start;
+    size_t end;
+} ml_match;
+
+/*
+ * Compiles the n patterns, each a NUL-terminated regex written as in a lexer
+ * spec (so whitespace outside of [] is ignored; escape it, as \x20, to match
+ * it), into a DFA. If the DFA grows beyond max_states states (0 meaning no
+ * limit), or a pattern can't be parsed, NULL is returned, and a description
+ * of the problem is written into err (err_len bytes, which may be 0); a DFA
+ * that grows too big is also explained on stderr. As in moonlime itself,
+ * running out of memory is fatal.
+ */
+ml_dfa * ml_compile(const char * const *patterns, int n, int max_states,
+                    char *err, size_t err_len);
+
+void ml_free(ml_dfa *dfa);
+
+/* Returns the number of states of dfa */
+int ml_dfa_states(const ml_dfa *dfa);
+
+/*
+ * Returns the length of the longest non-empty prefix of the len bytes of buf
+ * that some pattern matches, setting *rule to the first such pattern; returns
+ * 0 (leaving *rule alone) if no pattern matches.
+ */
+size_t ml_match_prefix(const ml_dfa *dfa, const char *buf, size_t len,
+                       int *rule);
+
+/*
+ * Splits the len bytes of buf into tokens as a generated lexer would: each
+ * the longest match at the end of the one before, ties going to the first
+ * pattern. Up to max matches are stored in out; returns the number stored,
+ * and sets *end to where scanning stopped: len if all of buf was matched, or
+ * otherwise the start of the text no pattern matches (or that max ran out
+ * before).
+ */
+size_t ml_scan(const ml_dfa *dfa, const char *buf, size_t len, ml_match *out,
+               size_t max, size_t *end);
+
+#endif
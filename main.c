@@ -46,183 +46,804 @@
 #include "fa.h"
 #endif
 
+#ifndef ML_DERIV_H
+#include "deriv.h"
+#endif
+
+#ifndef ML_DFACACHE_H
+#include "dfacache.h"
+#endif
+
+#ifndef ML_MLTWRITE_H
+#include "mltwrite.h"
+#endif
+
+#ifndef ML_STATS_H
+#include "stats.h"
+#endif
+
+#include <pthread.h>
+
+/* The size of the buffer the lexer is written out through */
+#define OUTPUT_BUF_SIZE 65536
+
+/* With -v, counted repetitions that expand to more than this many character
+ * positions in the NFA are pointed out */
+#define REP_WARN_POSITIONS 1000
+
+/* Settings made by the spec's %option directives */
+typedef struct {
+    fa_engine engine; /* How to build the NFA (or DFA) */
+    int lazy;         /* Build the DFA while scanning instead of up front */
+    int lazy_cache;   /* How many DFA states a lazy lexer may cache */
+    int profile;      /* Have the lexer count its work */
+    fa_budget_t budget; /* Limits on the size of the DFA */
+} ml_options_t;
+
+/* One lexer to generate: the spec it's generated from, and where it goes, as
+ * given on the command line or on a line of a --batch manifest */
+typedef struct {
+    const char *lexer_name;
+    const char *cout_name;
+    const char *hout_name; /* NULL if no header is wanted */
+    const char *mlt_name;  /* With -b, the file the tables go in */
+    int header;            /* -i was given */
+    char *made_hout_name;  /* hout_name, if finish_spec made it up */
+} ml_spec_t;
+
+/* What every lexer generated in a run has in common */
+typedef struct {
+    lstr_list_t *cl_opts; /* Settings given with -O */
+    const char *cache_dir;
+    int verbose, max_states, jobs, stats, backup;
+    int batch;            /* Reports say which spec they're about */
+    tmpl_prog_t ctmpl, htmpl;
+    pthread_mutex_t report_lock; /* Keeps reports on stdout in one piece */
+} ml_run_t;
+
+/* The lexers of a run, handed out in turn to the threads generating them */
+typedef struct {
+    ml_run_t *run;
+    const ml_spec_t *specs;
+    int n_specs;
+    pthread_mutex_t lock; /* Guards next and failed */
+    int next;             /* The next lexer to be taken */
+    int failed;           /* Some lexer couldn't be generated */
+} ml_batch_t;
+
 static fa_list_t * mk_regex_list(lexer_lexer_state *s);
 static fa_list_t * mk_start_state_list(lexer_lexer_state *s);
 static void free_fa_list(fa_list_t *l);
-static void run_tmpl(tmpl_state *t, const char *tmpl_name);
+static int spec_arg(ml_spec_t *sp, int argc, char **argv, int *i,
+                    const char *where);
+static void finish_spec(ml_spec_t *sp);
+static ml_spec_t * read_manifest(const char *name, int *n_specs,
+                                  char **text);
+static int gen_lexer(ml_run_t *run, const ml_spec_t *sp);
+static int run_batch(ml_run_t *run, ml_spec_t *specs, int n_specs,
+                     int n_threads);
+static void load_tmpl(tmpl_prog_t *p, const char *tmpl_name);
+static FILE * open_output(const char *name);
+static int apply_options(lexer_lexer_state *s, ml_options_t *opts);
+static fa_t * build_dfa_cached(fa_list_t *rxl, fa_list_t *stsl,
+                               const ml_options_t *opts, int jobs,
+                               const char *dir, FILE *verb);
+static size_t table_bytes(const fa_t *fa, const fa_list_t *rxl,
+                          const fa_list_t *stsl, int lazy);
+static void print_stats(FILE *f, int json, const char *spec, const fa_t *nfa,
+                        const fa_t *dfa, const fa_t *lnfa,
+                        const fa_list_t *stsl, size_t tables);
 
 int main(int argc, char **argv)
 {
-    lexer_lexer_state s;
-    FILE *f;
-    Moonlime_state *lexer;
-    char buf[256];
-    size_t num_in = 1;
-    const char *lexer_name = NULL;
-    const char *cout_name = NULL;
-    const char *hout_name = NULL;
-    char *new_hout_name = NULL;
     const char *ctmpl_name = SHAREDIR "/tmpl.c";
     const char *htmpl_name = SHAREDIR "/tmpl.h";
-    int i, verbose = 0;
-    size_t slen;
-    fa_list_t *rxl, *stsl;
-    fa_t *nfa, *dfa;
-    tmpl_state tms;
+    const char *manifest = NULL;
+    int i, r, n_specs = 1, n_threads = 1;
+    char *end, *manifest_text = NULL;
+    lstr_list_t **cl_tail;
+    ml_spec_t spec, *specs;
+    ml_run_t run;
+
+    memset(&spec, 0, sizeof(spec));
+    run.cl_opts = NULL;
+    run.cache_dir = NULL;
+    run.verbose = run.stats = run.backup = run.batch = 0;
+    run.max_states = -1;
+    run.jobs = 1;
+    cl_tail = &run.cl_opts;
 
     for(i = 1; i < argc; ++i) {
-        if(!strcmp(argv[i], "-o")) {
+        if(!strcmp(argv[i], "-s")) {
+            if(++i >= argc ||
+               (run.max_states = strtol(argv[i], &end, 10)) < 0 ||
+               *end != '\0' || end == argv[i]) {
+                fputs("-s needs a number of states\n", stderr);
+                return 1;
+            }
+
+        } else if(!strcmp(argv[i], "-j")) {
+            if(++i >= argc || (run.jobs = strtol(argv[i], &end, 10)) < 1 ||
+               *end != '\0' || end == argv[i]) {
+                fputs("-j needs a number of threads\n", stderr);
+                return 1;
+            }
+
+        } else if(!strcmp(argv[i], "-J")) {
+            if(++i >= argc || (n_threads = strtol(argv[i], &end, 10)) < 1 ||
+               *end != '\0' || end == argv[i]) {
+                fputs("-J needs a number of threads\n", stderr);
+                return 1;
+            }
+
+        } else if(!strcmp(argv[i], "-O")) {
             if(++i >= argc) {
-                fputs("No output file given after -o\n", stderr);
+                fputs("No setting given after -O\n", stderr);
                 return 1;
             }
-            cout_name = argv[i];
+            *cl_tail = malloc_or_die(1, lstr_list_t);
+            (*cl_tail)->s = lstring_dupbuf(strlen(argv[i]), argv[i]);
+            (*cl_tail)->next = NULL;
+            cl_tail = &(*cl_tail)->next;
 
-        } else if(!strcmp(argv[i], "-i")) {
+        } else if(!strcmp(argv[i], "--cache-dir")) {
             if(++i >= argc) {
-                if(cout_name == NULL)
-                    continue;
-
-                slen = strlen(cout_name);
-                if(!strcmp(cout_name + slen - 2, ".c")) {
-                    if(new_hout_name != NULL)
-                        free(new_hout_name);
-
-                    new_hout_name = malloc_or_die(slen + 1, char);
-                    strncpy(new_hout_name, cout_name, slen+1);
-                    strcpy(new_hout_name + slen - 2, ".h");
-                    hout_name = new_hout_name;
-                } else {
-                    if(new_hout_name != NULL)
-                        free(new_hout_name);
-                    new_hout_name = NULL;
-                    hout_name = "yylex.h";
-                }
-            } else {
-                if(new_hout_name != NULL)
-                    free(new_hout_name);
-                new_hout_name = NULL;
-                hout_name = argv[i];
+                fputs("No directory given after --cache-dir\n", stderr);
+                return 1;
             }
+            run.cache_dir = argv[i];
+
+        } else if(!strcmp(argv[i], "--batch")) {
+            if(++i >= argc) {
+                fputs("No manifest given after --batch\n", stderr);
+                return 1;
+            }
+            manifest = argv[i];
+
+        } else if(!strcmp(argv[i], "--stats")) {
+            run.stats = 1;
+        } else if(!strcmp(argv[i], "--stats=json")) {
+            run.stats = 2;
+        } else if(!strcmp(argv[i], "--backup")) {
+            run.backup = 1;
         } else if(!strcmp(argv[i], "-v"))
-            verbose = 1;
-        else
-            lexer_name = argv[i];
+            run.verbose = 1;
+        else if((r = spec_arg(&spec, argc, argv, &i, "")) < 0)
+            return 1;
+        else if(r == 0)
+            spec.lexer_name = argv[i];
+    }
+
+    if(manifest != NULL) {
+        if(spec.lexer_name != NULL || spec.cout_name != NULL ||
+           spec.header || spec.mlt_name != NULL) {
+            fputs("With --batch, lexer files (and their -o, -i and -b) go in "
+                  "the manifest\n", stderr);
+            return 1;
+        }
+        specs = read_manifest(manifest, &n_specs, &manifest_text);
+        run.batch = 1;
+    } else {
+        if(spec.lexer_name == NULL) {
+            fputs("No lexer file given\n", stderr);
+            return 1;
+        }
+        finish_spec(&spec);
+        specs = &spec;
     }
 
-    if(lexer_name == NULL) {
-        fputs("No lexer file given\n", stderr);
-        return 1;
+    if(run.stats)
+        stats_enable();
+
+    /* The templates are parsed once, for every lexer */
+    load_tmpl(&run.ctmpl, ctmpl_name);
+    init_tmpl_prog(&run.htmpl);
+    for(i = 0; i < n_specs; ++i) {
+        if(specs[i].hout_name != NULL) {
+            load_tmpl(&run.htmpl, htmpl_name);
+            break;
+        }
     }
-    if(cout_name == NULL)
-        cout_name = "yylex.c";
 
-    /*
-     * Right now, we're just trying to check that the lexer-lexer tokenizes the
-     * file correctly, not try to do anything with the results, so the
-     * following is a little simplified for now.
-     */
+    pthread_mutex_init(&run.report_lock, NULL);
+    r = run_batch(&run, specs, n_specs, n_threads);
+    pthread_mutex_destroy(&run.report_lock);
+
+    free_tmpl_prog(&run.ctmpl);
+    free_tmpl_prog(&run.htmpl);
+    free_lstr_list(run.cl_opts);
+    for(i = 0; i < n_specs; ++i)
+        free(specs[i].made_hout_name);
+    if(specs != &spec) {
+        free(specs);
+        free(manifest_text);
+    }
+
+    return r;
+}
+
+/* Generates the lexer sp describes; returns 0 if it was, or 1 (having said
+ * why on stderr) if not */
+static int gen_lexer(ml_run_t *run, const ml_spec_t *sp)
+{
+    lexer_lexer_state s;
+    Moonlime_state *lexer;
+    file_map_t spec;
+    int i, n_big, ret = 1;
+    size_t tables = 0;
+    fa_list_t *rxl = NULL, *stsl = NULL, *l;
+    lstr_list_t **opt_end = NULL;
+    fa_t *nfa = NULL, *dfa = NULL, *lnfa = NULL, **parts;
+    char *backs_up;
+    tmpl_state tms;
+    ml_options_t opts;
+
+    opts.engine = ENGINE_THOMPSON;
+    opts.lazy = 0;
+    opts.lazy_cache = 1024;
+    opts.profile = 0;
+    opts.budget.max_states = 0;
+    opts.budget.max_bytes = 0;
+
+    stats_reset();
     init_lexer_lexer_state(&s);
-    if(verbose)
+    if(run->verbose)
         s.verb = stderr;
 
-    if((f = fopen(lexer_name, "r")) == NULL) {
-        fprintf(stderr, "Couldn\'t open file \'%s\'\n", argv[1]);
-        return 1;
+    phase_start(PHASE_PARSE);
+
+    if(!map_file(&spec, sp->lexer_name)) {
+        fprintf(stderr, "Couldn\'t read file \'%s\'\n", sp->lexer_name);
+        goto done;
     }
 
     if((lexer = MoonlimeInit(malloc, free)) == NULL) {
         fputs("Couldn\'t initialize lexer\n", stderr);
-        return 1;
+        goto done;
     }
 
-    while(num_in > 0) {
-        num_in = fread(buf, 1, sizeof(buf), f);
-
-        if(num_in != 0) {
-            if(!MoonlimeRead(lexer, buf, num_in, &s)) {
-                fputs("An error occurred during lexing!\n", stderr);
-                MoonlimeDestroy(lexer);
-                return 1;
-            }
-        }
-
-        if(ferror(f)) {
-            fputs("An error occurred during reading!\n", stderr);
-            MoonlimeDestroy(lexer);
-            return 1;
-        }
+    /* The whole spec is lexed in one go */
+    if(spec.len > 0 && !MoonlimeRead(lexer, spec.data, spec.len, &s)) {
+        fprintf(stderr, "An error occurred during lexing %s!\n",
+                sp->lexer_name);
+        MoonlimeDestroy(lexer);
+        goto done;
     }
 
     if(!MoonlimeRead(lexer, NULL, 0, &s)) {
-        fputs("An error occurred during lexing near EOF!\n", stderr);
+        fprintf(stderr, "An error occurred during lexing near the end of "
+                "%s!\n", sp->lexer_name);
         MoonlimeDestroy(lexer);
-        return 1;
+        goto done;
     }
 
     MoonlimeDestroy(lexer);
-    fclose(f);
+    unmap_file(&spec);
+    phase_end(PHASE_PARSE);
+
+    if(s.kw_pending != NULL) {
+        fputs("A %keywords block without a pattern after it!\n", stderr);
+        goto done;
+    }
 
     if(s.states == NULL) {
         s.initstate = lstring_dupbuf(1, "A");
         s.states = malloc_or_die(1, lstr_list_t);
-        s.states->s = s.initstate;
+        s.states->s = lstring_dupbuf(1, "A");
         s.states->next = NULL;
     }
 
+    /* Settings given with -O come after, and so override, the spec's */
+    for(opt_end = &s.options; *opt_end != NULL; opt_end = &(*opt_end)->next)
+        ;
+    *opt_end = run->cl_opts;
+
+    if(!apply_options(&s, &opts))
+        goto done;
+    if(run->max_states >= 0)
+        opts.budget.max_states = run->max_states;
+
     rxl = mk_regex_list(&s);
     stsl = mk_start_state_list(&s);
-    nfa = multi_regex_compile(rxl);
 
-    if(verbose) {
-        fputs("--- total NFA:\n", stderr);
-        print_fa(stderr, nfa, "nfa");
+    if(opts.lazy && opts.engine == ENGINE_DERIVATIVES) {
+        fputs("%option lazy needs an NFA, so can't be used with "
+              "engine=derivatives\n", stderr);
+        goto done;
+    }
+
+    if(opts.lazy && sp->mlt_name != NULL) {
+        fputs("-b writes out a DFA, which %option lazy lexers don't "
+              "have\n", stderr);
+        goto done;
+    }
+
+    /* A lazy lexer has no DFA to cache */
+    if(run->cache_dir != NULL && !opts.lazy) {
+        phase_start(PHASE_DFA);
+        dfa = build_dfa_cached(rxl, stsl, &opts, run->jobs, run->cache_dir,
+                               run->verbose ? stderr : NULL);
+        phase_end(PHASE_DFA);
+    } else if(opts.engine == ENGINE_DERIVATIVES) {
+        phase_start(PHASE_DFA);
+        dfa = regexes_to_dfa(rxl, stsl, &opts.budget,
+                             run->verbose ? stderr : NULL);
+        phase_end(PHASE_DFA);
+    } else {
+        if(run->verbose) {
+            for(i = 1, n_big = 0, l = rxl; l != NULL; l = l->next, ++i)
+                n_big += print_big_repetitions(stderr, (regex_t *) l->data1,
+                                               REP_WARN_POSITIONS, i);
+            if(n_big > 0)
+                fputs("--- warning: the counted repetitions above are written "
+                      "out in full in the NFA\n    (engine=derivatives "
+                      "doesn't do so)\n", stderr);
+        }
+
+        phase_start(PHASE_NFA);
+        nfa = (opts.engine == ENGINE_GLUSHKOV) ? multi_regex_glushkov(rxl)
+                                               : multi_regex_compile(rxl);
+        phase_end(PHASE_NFA);
+
+        if(run->verbose) {
+            fputs("--- total NFA:\n", stderr);
+            print_fa(stderr, nfa, "nfa");
+            fprintf(stderr, "--- NFA size: %d states, %d transitions, "
+                    "%d character classes, %lu bytes\n", nfa->n_states,
+                    nfa->n_trans, nfa->n_classes,
+                    (unsigned long) fa_size(nfa));
+        }
+
+        if(opts.lazy) {
+            phase_start(PHASE_CLOSURE);
+            lnfa = nfa_remove_nils(nfa, rxl);
+            phase_end(PHASE_CLOSURE);
+            dfa = NULL;
+
+            if(run->verbose) {
+                fputs("--- lazy NFA:\n", stderr);
+                print_fa(stderr, lnfa, "lnfa");
+                fprintf(stderr, "--- lazy NFA size: %d states, %d "
+                        "transitions, %d character classes, %lu bytes\n",
+                        lnfa->n_states, lnfa->n_trans, lnfa->n_classes,
+                        (unsigned long) fa_size(lnfa));
+            }
+        } else if(run->jobs > 1) {
+            /* Each start state's DFA is built on its own, and the states
+             * they have in common merged back together afterwards */
+            phase_start(PHASE_DFA);
+            for(i = 0, l = stsl; l != NULL; l = l->next)
+                ++i;
+            parts = malloc_or_die(i, fa_t *);
+            if(nfas_to_dfa_parts(nfa, rxl, stsl, &opts.budget, run->jobs, parts,
+                                 run->verbose ? stderr : NULL))
+                dfa = minimize_dfa(merge_dfas(parts, stsl), stsl);
+            free(parts);
+            phase_end(PHASE_DFA);
+        } else {
+            phase_start(PHASE_DFA);
+            dfa = nfas_to_dfas(nfa, rxl, stsl, &opts.budget,
+                               run->verbose ? stderr : NULL);
+            phase_end(PHASE_DFA);
+        }
     }
 
-    dfa = nfas_to_dfas(nfa, rxl, stsl);
+    if(dfa == NULL && !opts.lazy) {
+        fputs("Raise the limit with %option maxstates, maxmem or -s, or "
+              "consider %option lazy.\n", stderr);
+        goto done;
+    }
 
-    if(verbose) {
+    if(run->verbose && dfa != NULL) {
         fputs("--- total DFA:\n", stderr);
         print_fa(stderr, dfa, "dfa");
+        fprintf(stderr, "--- DFA size: %d states, %d transitions, "
+                "%d character classes, %lu bytes\n", dfa->n_states,
+                dfa->n_trans, dfa->n_classes, (unsigned long) fa_size(dfa));
+    }
+
+    if(run->backup) {
+        pthread_mutex_lock(&run->report_lock);
+        if(run->batch)
+            printf("--- %s:\n", sp->lexer_name);
+        if(dfa != NULL)
+            print_backup_report(stdout, dfa, rxl, stsl);
+        else
+            fputs("A lazy lexer's DFA isn't known ahead of time, so it can't "
+                  "be checked for backing up.\n", stdout);
+        fflush(stdout);
+        pthread_mutex_unlock(&run->report_lock);
     }
 
+    phase_start(PHASE_EMIT);
+
+    /* With -b, the tables go in their own file instead of the lexer */
+    if(sp->mlt_name != NULL &&
+       (tables = write_mlt(sp->mlt_name, dfa, rxl, stsl, &s)) == 0)
+        goto done;
+
     tms.st = &s;
-    tms.dfa = dfa;
+    tms.dfa = (sp->mlt_name != NULL) ? NULL : dfa;
+    tms.nfa = lnfa;
+    tms.mlt = sp->mlt_name;
+    tms.lazy_cache = opts.lazy_cache;
+    tms.profile = opts.profile;
+    /* A lexer whose DFA never backs up can skip keeping track of the last
+     * match, and never has to scan characters again */
+    tms.no_backup = 0;
+    if(tms.dfa != NULL) {
+        backs_up = malloc_or_die(dfa->n_states, char);
+        tms.no_backup = (fa_backup_states(dfa, backs_up) == 0);
+        free(backs_up);
+    }
     tms.patterns = rxl;
     tms.start_states = stsl;
 
-    if((f = fopen(cout_name, "w")) == NULL) {
-        fprintf(stderr, "Can\'t open %s for writing\n", cout_name);
-        return 1;
-    }
+    if((tms.f = open_output(sp->cout_name)) == NULL)
+        goto done;
+    run_tmpl_prog(&run->ctmpl, &tms);
+    fclose(tms.f);
 
-    tms.f = f;
-    run_tmpl(&tms, ctmpl_name);
-    fclose(f);
+    if(sp->hout_name != NULL) {
+        if((tms.f = open_output(sp->hout_name)) == NULL)
+            goto done;
+        run_tmpl_prog(&run->htmpl, &tms);
+        fclose(tms.f);
+    }
 
-    if(hout_name != NULL) {
-        if((f = fopen(hout_name, "w")) == NULL) {
-            fprintf(stderr, "Can\'t open %s for writing\n", hout_name);
-            return 1;
-        }
+    phase_end(PHASE_EMIT);
 
-        tms.f = f;
-        run_tmpl(&tms, htmpl_name);
-        fclose(f);
+    if(run->stats) {
+        if(sp->mlt_name == NULL)
+            tables = (dfa != NULL) ? table_bytes(dfa, rxl, stsl, 0)
+                                   : table_bytes(lnfa, rxl, stsl, 1);
+        pthread_mutex_lock(&run->report_lock);
+        print_stats(stdout, run->stats == 2, run->batch ? sp->lexer_name : NULL,
+                    nfa, dfa, lnfa, stsl, tables);
+        fflush(stdout);
+        pthread_mutex_unlock(&run->report_lock);
     }
 
+    ret = 0;
+
+done:
+    unmap_file(&spec);
     free_fa_list(rxl);
     free_fa_list(stsl);
-    destroy_fa(nfa);
-    destroy_fa(dfa);
+    if(nfa != NULL)
+        destroy_fa(nfa);
+    if(lnfa != NULL)
+        destroy_fa(lnfa);
+    if(dfa != NULL)
+        destroy_fa(dfa);
+
+    /* The -O settings are every lexer's, so aren't freed with this one's */
+    if(opt_end != NULL)
+        *opt_end = NULL;
+    free_lexer_lexer_state(&s);
+
+    return ret;
+}
+
+/* If argv[*i] is one of the options that describe a single lexer (-o, -i and
+ * -b), applies it to sp, moving *i past any argument it takes, and returns 1;
+ * returns 0 if it isn't, or -1 (having said why on stderr, after where) if it
+ * lacks an argument. */
+static int spec_arg(ml_spec_t *sp, int argc, char **argv, int *i,
+                    const char *where)
+{
+    if(!strcmp(argv[*i], "-o")) {
+        if(++*i >= argc) {
+            fprintf(stderr, "%sNo output file given after -o\n", where);
+            return -1;
+        }
+        sp->cout_name = argv[*i];
+
+    } else if(!strcmp(argv[*i], "-i")) {
+        /* Without a name, the header is named after the lexer */
+        sp->header = 1;
+        sp->hout_name = (++*i < argc) ? argv[*i] : NULL;
+
+    } else if(!strcmp(argv[*i], "-b")) {
+        if(++*i >= argc) {
+            fprintf(stderr, "%sNo tables file given after -b\n", where);
+            return -1;
+        }
+        sp->mlt_name = argv[*i];
+
+    } else
+        return 0;
+
+    return 1;
+}
+
+/* Fills in the names sp was given no -o or -i name for */
+static void finish_spec(ml_spec_t *sp)
+{
+    size_t slen;
+    char *name;
+
+    if(sp->cout_name == NULL)
+        sp->cout_name = "yylex.c";
+
+    if(sp->header && sp->hout_name == NULL) {
+        slen = strlen(sp->cout_name);
+        if(slen >= 2 && !strcmp(sp->cout_name + slen - 2, ".c")) {
+            name = malloc_or_die(slen + 1, char);
+            strcpy(name, sp->cout_name);
+            strcpy(name + slen - 2, ".h");
+            sp->hout_name = sp->made_hout_name = name;
+        } else
+            sp->hout_name = "yylex.h";
+    }
+}
+
+/*
+ * Reads the --batch manifest name, returning the lexers it lists (*n_specs of
+ * them). Each line gives one, with the arguments it would have on the command
+ * line (its lexer file, and any -o, -i and -b), separated by spaces or tabs;
+ * blank lines, and those whose first word starts with #, are skipped.
+ * Anything wrong with it is fatal. The lexers' file names point into *text,
+ * a copy of the manifest, to be freed once they're done with.
+ */
+static ml_spec_t * read_manifest(const char *name, int *n_specs,
+                                  char **text)
+{
+    file_map_t m;
+    ml_spec_t *specs = NULL, *sp;
+    char *line, *eol, **words, where[64];
+    int n_words, size = 0, line_num = 0, i;
+
+    if(!map_file(&m, name)) {
+        fprintf(stderr, "Couldn\'t read manifest \'%s\'\n", name);
+        exit(1);
+    }
+
+    /* Split into lines, and each line into words, in place */
+    *text = malloc_or_die(m.len + 1, char);
+    memcpy(*text, m.data, m.len);
+    (*text)[m.len] = '\0';
+    unmap_file(&m);
+
+    *n_specs = 0;
+    for(line = *text; *line != '\0'; line = eol + 1) {
+        ++line_num;
+        if((eol = strchr(line, '\n')) != NULL)
+            *eol = '\0';
+        else
+            eol = line + strlen(line) - 1;
+        words = malloc_or_die(strlen(line) / 2 + 1, char *);
+
+        for(i = 0, n_words = 0; line[i] != '\0'; ) {
+            while(line[i] == ' ' || line[i] == '\t' || line[i] == '\r')
+                line[i++] = '\0';
+            if(line[i] == '\0' || (n_words == 0 && line[i] == '#'))
+                break;
+            words[n_words++] = line + i;
+            while(line[i] != '\0' && line[i] != ' ' && line[i] != '\t' &&
+                  line[i] != '\r')
+                ++i;
+        }
 
-    return 0;
+        if(n_words == 0) {
+            free(words);
+            continue;
+        }
+
+        if(*n_specs == size) {
+            size = (size > 0) ? 2 * size : 64;
+            if((specs = realloc(specs, size * sizeof(ml_spec_t))) == NULL) {
+                fputs(__FILE__ ": Can\'t allocate memory for the manifest\n",
+                      stderr);
+                exit(1);
+            }
+        }
+
+        sp = &specs[(*n_specs)++];
+        memset(sp, 0, sizeof(*sp));
+        sprintf(where, "%.40s:%d: ", name, line_num);
+
+        for(i = 0; i < n_words; ++i) {
+            switch(spec_arg(sp, n_words, words, &i, where)) {
+            case -1:
+                exit(1);
+            case 0:
+                if(words[i][0] == '-' || sp->lexer_name != NULL) {
+                    fprintf(stderr, "%s%s isn\'t allowed here\n", where,
+                            words[i]);
+                    exit(1);
+                }
+                sp->lexer_name = words[i];
+            }
+        }
+
+        if(sp->lexer_name == NULL) {
+            fprintf(stderr, "%sNo lexer file given\n", where);
+            exit(1);
+        }
+        finish_spec(sp);
+        free(words);
+    }
+
+    if(*n_specs == 0) {
+        fprintf(stderr, "No lexer files listed in %s\n", name);
+        exit(1);
+    }
+
+    return specs;
+}
+
+static void * batch_worker(void *arg)
+{
+    ml_batch_t *b = arg;
+    int i;
+
+    for(;;) {
+        pthread_mutex_lock(&b->lock);
+        i = b->failed ? b->n_specs : b->next++;
+        pthread_mutex_unlock(&b->lock);
+
+        if(i >= b->n_specs)
+            break;
+
+        if(gen_lexer(b->run, &b->specs[i]) != 0) {
+            if(b->run->batch)
+                fprintf(stderr, "--- %s: no lexer generated\n",
+                        b->specs[i].lexer_name);
+            pthread_mutex_lock(&b->lock);
+            b->failed = 1;
+            pthread_mutex_unlock(&b->lock);
+        }
+    }
+
+    return NULL;
+}
+
+/* Generates the n_specs lexers specs, on up to n_threads threads; once one
+ * can't be, no more are started. Returns 0 if they all were, 1 if not. */
+static int run_batch(ml_run_t *run, ml_spec_t *specs, int n_specs,
+                     int n_threads)
+{
+    ml_batch_t b;
+    pthread_t *threads;
+    int i, n_started;
+
+    b.run = run;
+    b.specs = specs;
+    b.n_specs = n_specs;
+    b.next = b.failed = 0;
+
+    if(n_threads > n_specs)
+        n_threads = n_specs;
+
+    pthread_mutex_init(&b.lock, NULL);
+    threads = malloc_or_die(n_threads, pthread_t);
+
+    /* The calling thread works too; if a thread can't be started, the
+     * others just take on more of the lexers */
+    for(n_started = 0; n_started < n_threads - 1; ++n_started)
+        if(pthread_create(&threads[n_started], NULL, batch_worker, &b) != 0)
+            break;
+
+    batch_worker(&b);
+
+    for(i = 0; i < n_started; ++i)
+        pthread_join(threads[i], NULL);
+
+    pthread_mutex_destroy(&b.lock);
+    free(threads);
+    return b.failed;
+}
+
+/* Returns 1 if the option setting opt (of the form "name" or "name=value")
+ * has the given name, setting *value to the start of the value part (or NULL
+ * if there is none) and *vlen to its length; returns 0 otherwise. */
+static int option_is(const len_string *opt, const char *name,
+                     const char **value, size_t *vlen)
+{
+    size_t nlen = strlen(name);
+
+    if(opt->len < nlen || strncmp(opt->s, name, nlen) ||
+       (opt->len > nlen && opt->s[nlen] != '='))
+        return 0;
+
+    if(opt->len > nlen) {
+        *value = opt->s + nlen + 1;
+        *vlen = opt->len - nlen - 1;
+    } else {
+        *value = NULL;
+        *vlen = 0;
+    }
+
+    return 1;
+}
+
+/* Returns the value of the option setting opt (whose value part is val, vlen
+ * bytes long) as a positive number, or 0 (having said why on stderr) if it
+ * isn't one. */
+static int option_number(const len_string *opt, const char *val, size_t vlen)
+{
+    size_t i;
+    long n = 0;
+
+    for(i = 0; val != NULL && i < vlen; ++i) {
+        if(val[i] < '0' || val[i] > '9' || n > 100000000) {
+            n = 0;
+            break;
+        }
+        n = n * 10 + (val[i] - '0');
+    }
+
+    if(n <= 0) {
+        fprintf(stderr, "%%option %.*s needs a positive number\n",
+                (int) opt->len, opt->s);
+        return 0;
+    }
+
+    return (int) n;
+}
+
+/* Applies the settings of the spec's %option directives; returns 1, or 0
+ * (having said why on stderr) if there's an unknown option or value. */
+static int apply_options(lexer_lexer_state *s, ml_options_t *opts)
+{
+    lstr_list_t *p;
+    const char *val;
+    size_t vlen;
+    int n;
+
+    for(p = s->options; p != NULL; p = p->next) {
+        if(option_is(p->s, "engine", &val, &vlen)) {
+            if(val != NULL && vlen == 8 && !strncmp(val, "thompson", vlen))
+                opts->engine = ENGINE_THOMPSON;
+            else if(val != NULL && vlen == 8 &&
+                    !strncmp(val, "glushkov", vlen))
+                opts->engine = ENGINE_GLUSHKOV;
+            else if(val != NULL && vlen == 11 &&
+                    !strncmp(val, "derivatives", vlen))
+                opts->engine = ENGINE_DERIVATIVES;
+            else {
+                fprintf(stderr, "Unknown engine in %%option %.*s\n",
+                        (int) p->s->len, p->s->s);
+                return 0;
+            }
+        } else if(option_is(p->s, "lazy", &val, &vlen)) {
+            if(val != NULL) {
+                fprintf(stderr, "%%option lazy takes no value\n");
+                return 0;
+            }
+            opts->lazy = 1;
+        } else if(option_is(p->s, "profile", &val, &vlen)) {
+            if(val != NULL) {
+                fprintf(stderr, "%%option profile takes no value\n");
+                return 0;
+            }
+            opts->profile = 1;
+        } else if(option_is(p->s, "lazy_cache", &val, &vlen)) {
+            if((opts->lazy_cache = option_number(p->s, val, vlen)) == 0)
+                return 0;
+        } else if(option_is(p->s, "maxstates", &val, &vlen)) {
+            if((opts->budget.max_states = option_number(p->s, val, vlen)) == 0)
+                return 0;
+        } else if(option_is(p->s, "maxmem", &val, &vlen)) {
+            if((n = option_number(p->s, val, vlen)) == 0)
+                return 0;
+            opts->budget.max_bytes = (size_t) n * 1024 * 1024;
+        } else {
+            fprintf(stderr, "Unknown option %.*s\n", (int) p->s->len,
+                    p->s->s);
+            return 0;
+        }
+    }
+
+    return 1;
 }
 
 static fa_list_t * mk_regex_list(lexer_lexer_state *s)
 {
     pat_entry_t *p = s->phead;
     fa_list_t *first = NULL, *last = NULL, *curr = NULL;
+    int n = 0;
 
     while(p != NULL) {
         curr = malloc_or_die(1, fa_list_t);
@@ -232,8 +853,10 @@ static fa_list_t * mk_regex_list(lexer_lexer_state *s)
         if(last != NULL)
             last->next = curr;
 
+        /* The same numbers the NFA and DFA builders give the patterns */
+        curr->done_num = ++n;
         curr->state = NULL;
-        curr->data1 = p->rx;
+        curr->data1 = p->rx = simplify_regex(p->rx);
         curr->data2 = p->states;
         curr->data3 = p->code;
 
@@ -284,16 +907,15 @@ static void free_fa_list(fa_list_t *l)
     }
 }
 
-static void run_tmpl(tmpl_state *t, const char *tmpl_name)
+/* Parses the template tmpl_name into p */
+static void load_tmpl(tmpl_prog_t *p, const char *tmpl_name)
 {
-    FILE *f;
-    char buf[1];
     Template_state *lexer;
-    size_t num_in = 1;
-    int num_tot = 0;
 
-    if((f = fopen(tmpl_name, "r")) == NULL) {
-        fprintf(stderr, "Can\'t open %s for reading\n", tmpl_name);
+    init_tmpl_prog(p);
+
+    if(!map_file(&p->src, tmpl_name)) {
+        fprintf(stderr, "Can\'t read %s\n", tmpl_name);
         exit(1);
     }
 
@@ -302,31 +924,253 @@ static void run_tmpl(tmpl_state *t, const char *tmpl_name)
         exit(1);
     }
 
-    while(num_in > 0) {
-        num_in = fread(buf, 1, sizeof(buf), f);
+    if(p->src.len > 0 && !TemplateRead(lexer, p->src.data, p->src.len, p)) {
+        fprintf(stderr, "Error lexing %s\n", tmpl_name);
+        TemplateDestroy(lexer);
+        exit(1);
+    }
 
-        if(num_in != 0) {
-            if(!TemplateRead(lexer, buf, num_in, t)) {
-                fprintf(stderr, "Error lexing %s (%d-%d)\n", tmpl_name,
-                        num_tot, num_tot + (int) num_in);
-                TemplateDestroy(lexer);
-                exit(1);
+    if(!TemplateRead(lexer, NULL, 0, p)) {
+        fprintf(stderr, "Error near the end of %s\n", tmpl_name);
+        exit(1);
+    }
+
+    TemplateDestroy(lexer);
+}
+
+/* Opens the file name to write a lexer to, with a buffer big enough that
+ * its tables go out in large pieces; returns NULL (having said why on stderr)
+ * if it can't be */
+static FILE * open_output(const char *name)
+{
+    FILE *f;
+
+    if((f = fopen(name, "w")) == NULL) {
+        fprintf(stderr, "Can\'t open %s for writing\n", name);
+        return NULL;
+    }
+
+    setvbuf(f, NULL, _IOFBF, OUTPUT_BUF_SIZE);
+    return f;
+}
+
+/* Builds the DFA one start state at a time, reusing the DFAs of those start
+ * states whose patterns are unchanged since they were cached in dir; the
+ * others are built (from an NFA only built if need be, on jobs threads) and
+ * cached. Returns NULL if a DFA outgrows opts->budget. */
+static fa_t * build_dfa_cached(fa_list_t *rxl, fa_list_t *stsl,
+                               const ml_options_t *opts, int jobs,
+                               const char *dir, FILE *verb)
+{
+    fa_t **parts, **built, *nfa, *dfa = NULL;
+    fa_list_t *l, *one, *missing = NULL, **tail = &missing;
+    len_string **keys;
+    char *fresh;
+    int i, n = 0, n_built = 0, ok = 1;
+
+    for(l = stsl; l != NULL; l = l->next)
+        ++n;
+    parts = malloc_or_die(n, fa_t *);
+    built = malloc_or_die(n, fa_t *);
+    keys = malloc_or_die(n, len_string *);
+    one = malloc_or_die(n, fa_list_t);
+    fresh = malloc_or_die(n, char);
+
+    /* First see which start states' DFAs are cached... */
+    for(l = stsl, i = 0; l != NULL; l = l->next, ++i) {
+        one[i] = *l;
+        one[i].next = NULL;
+
+        keys[i] = dfa_cache_key(rxl, &one[i], opts->engine);
+        parts[i] = dfa_cache_load(dir, keys[i], &one[i], verb);
+
+        if(parts[i] != NULL && over_budget(&opts->budget,
+                                           parts[i]->n_states,
+                                           fa_size(parts[i]))) {
+            destroy_fa(parts[i]);
+            parts[i] = NULL;
+        }
+
+        fresh[i] = (parts[i] == NULL);
+        n_built += fresh[i];
+    }
+
+    /* ...then build the rest */
+    if(n_built > 0 && opts->engine == ENGINE_DERIVATIVES) {
+        for(i = 0; i < n && ok; ++i)
+            if(fresh[i])
+                ok = (parts[i] = regexes_to_dfa(rxl, &one[i], &opts->budget,
+                                                verb)) != NULL;
+    } else if(n_built > 0) {
+        for(i = 0; i < n; ++i) {
+            if(fresh[i]) {
+                *tail = &one[i];
+                tail = &one[i].next;
             }
         }
-        num_tot += num_in;
 
-        if(ferror(f)) {
-            fprintf(stderr, "Error reading %s\n", tmpl_name);
-            TemplateDestroy(lexer);
-            exit(1);
+        phase_start(PHASE_NFA);
+        nfa = (opts->engine == ENGINE_GLUSHKOV) ? multi_regex_glushkov(rxl)
+                                                : multi_regex_compile(rxl);
+        phase_end(PHASE_NFA);
+        ok = nfas_to_dfa_parts(nfa, rxl, missing, &opts->budget, jobs,
+                               built, verb);
+        destroy_fa(nfa);
+
+        for(i = 0, l = missing; l != NULL; l = l->next)
+            parts[l - one] = built[i++];
+        for(i = 0; i < n; ++i)
+            one[i].next = NULL;
+    }
+
+    for(i = 0, l = stsl; l != NULL; l = l->next, ++i) {
+        if(ok && fresh[i])
+            dfa_cache_store(dir, keys[i], parts[i], &one[i], verb);
+        l->state = one[i].state;
+        free(keys[i]);
+    }
+
+    if(ok) {
+        if(verb != NULL)
+            fprintf(verb, "--- DFA cache: built %d of %d start states' "
+                    "DFAs\n", n_built, n);
+        dfa = minimize_dfa(merge_dfas(parts, stsl), stsl);
+    } else {
+        for(i = 0; i < n; ++i)
+            if(parts[i] != NULL)
+                destroy_fa(parts[i]);
+    }
+
+    free(parts);
+    free(built);
+    free(keys);
+    free(one);
+    free(fresh);
+    return dfa;
+}
+
+/* Returns the size of the tables the template writes for the DFA fa, or, if
+ * lazy, for the NFA fa a lazy lexer builds its DFA from */
+static size_t table_bytes(const fa_t *fa, const fa_list_t *rxl,
+                          const fa_list_t *stsl, int lazy)
+{
+    const fa_list_t *l, *p;
+    size_t n = (size_t) fa->n_states * 3 * sizeof(int) +
+               (size_t) fa->n_trans * (32 + sizeof(int));
+
+    for(l = stsl; l != NULL; l = l->next) {
+        n += sizeof(int);
+        if(!lazy)
+            continue;
+
+        /* The start state's -1-terminated list of initial NFA states */
+        n += sizeof(int);
+        for(p = rxl; p != NULL; p = p->next)
+            if(p->data2 == NULL ||
+               lstr_in_list((len_string *) l->data1,
+                            (lstr_list_t *) p->data2))
+                n += sizeof(int);
+    }
+
+    return lazy ? n + 256 : n;
+}
+
+/* Writes the len bytes of s to f as a JSON string */
+static void print_json_string(FILE *f, const char *s, size_t len)
+{
+    size_t i;
+    int c;
+
+    fputc('"', f);
+    for(i = 0; i < len; ++i) {
+        c = 0xff & s[i];
+        if(c == '"' || c == '\\')
+            fprintf(f, "\\%c", c);
+        else if(c == '\n')
+            fputs("\\n", f);
+        else if(c == '\t')
+            fputs("\\t", f);
+        else if(c < 0x20)
+            fprintf(f, "\\u%04x", c);
+        else
+            fputc(c, f);
+    }
+    fputc('"', f);
+}
+
+/* Writes the --stats report to f, as JSON if json; if spec isn't NULL, the
+ * report says it's about the lexer spec */
+static void print_stats(FILE *f, int json, const char *spec, const fa_t *nfa,
+                        const fa_t *dfa, const fa_t *lnfa,
+                        const fa_list_t *stsl, size_t tables)
+{
+    const phase_stats_t *ps;
+    const fa_list_t *l;
+    const len_string *name;
+    const fa_t *tfa = (dfa != NULL) ? dfa : lnfa;
+    int map[256], n_classes = fa_byte_classes(tfa, map), i;
+
+    if(!json) {
+        if(spec != NULL)
+            fprintf(f, "--- %s:\n", spec);
+        fputs("phase        time (s)   peak RSS (KB)\n", f);
+        for(i = 0; i < N_PHASES; ++i) {
+            ps = phase_stats((ml_phase) i);
+            if(ps->runs > 0)
+                fprintf(f, "%-10s %10.4f %15ld\n", phase_name((ml_phase) i),
+                        ps->seconds, ps->peak_kb);
         }
+        if(nfa != NULL)
+            fprintf(f, "NFA: %d states, %d transitions\n", nfa->n_states,
+                    nfa->n_trans);
+        fprintf(f, "%s: %d states, %d transitions, %d byte classes\n",
+                (dfa != NULL) ? "DFA" : "lazy NFA", tfa->n_states,
+                tfa->n_trans, n_classes);
+        fprintf(f, "tables: %lu bytes\n", (unsigned long) tables);
+        for(l = stsl; l != NULL && dfa != NULL; l = l->next) {
+            name = (len_string *) l->data1;
+            fprintf(f, "start state %.*s: %d DFA states\n", (int) name->len,
+                    name->s, fa_reachable(dfa, l->state));
+        }
+        return;
     }
 
-    if(!TemplateRead(lexer, NULL, 0, t)) {
-        fprintf(stderr, "Error near the end of %s\n", tmpl_name);
-        exit(1);
+    fputs("{\n", f);
+    if(spec != NULL) {
+        fputs("  \"spec\": ", f);
+        print_json_string(f, spec, strlen(spec));
+        fputs(",\n", f);
+    }
+    fputs("  \"phases\": {", f);
+    for(i = 0; i < N_PHASES; ++i) {
+        ps = phase_stats((ml_phase) i);
+        fprintf(f, "%s\n    \"%s\": {\"runs\": %d, \"seconds\": %.6f, "
+                "\"peak_kb\": %ld}", (i > 0) ? "," : "",
+                phase_name((ml_phase) i), ps->runs, ps->seconds, ps->peak_kb);
     }
+    fputs("\n  },\n", f);
 
-    TemplateDestroy(lexer);
-    fclose(f);
+    if(nfa != NULL)
+        fprintf(f, "  \"nfa\": {\"states\": %d, \"transitions\": %d},\n",
+                nfa->n_states, nfa->n_trans);
+    else
+        fputs("  \"nfa\": null,\n", f);
+
+    fprintf(f, "  \"%s\": {\"states\": %d, \"transitions\": %d, "
+            "\"byte_classes\": %d},\n", (dfa != NULL) ? "dfa" : "lazy_nfa",
+            tfa->n_states, tfa->n_trans, n_classes);
+    fprintf(f, "  \"table_bytes\": %lu,\n", (unsigned long) tables);
+
+    fputs("  \"start_states\": [", f);
+    for(l = stsl; l != NULL; l = l->next) {
+        name = (len_string *) l->data1;
+        fprintf(f, "%s\n    {\"name\": ", (l != stsl) ? "," : "");
+        print_json_string(f, name->s, name->len);
+        if(dfa != NULL)
+            fprintf(f, ", \"dfa_states\": %d}",
+                    fa_reachable(dfa, l->state));
+        else
+            fputs(", \"dfa_states\": null}", f);
+    }
+    fputs("\n  ]\n}\n", f);
 }
@@ -23,13 +23,24 @@ typedef enum {
     D_STATE,
     D_INITSTATE,
     D_PREFIX,
-    D_USTATE_TYPE
+    D_USTATE_TYPE,
+    D_OPTION,
+    D_KEYWORD
 } directive_kind;
 
+/* A keyword of a pattern (see %keywords), and the code run in place of the
+ * pattern's when the pattern matches exactly the keyword */
+typedef struct kw_entry {
+    len_string *word;
+    len_string *code;
+    struct kw_entry *next;
+} kw_entry_t;
+
 struct pattern_entry {
     regex_t *rx;
     len_string *code;
     lstr_list_t *states;
+    kw_entry_t *keywords; /* The pattern's keywords, or NULL */
     struct pattern_entry *next;
 };
 
@@ -39,7 +50,7 @@ typedef struct {
     directive_kind dir;   /* Current type of directive being parsed */
     int c_nest_depth;     /* Current brace-nesting depth in C code */
     int regex_nest_depth; /* Current parenthesis-nesting depth in regex */
-    len_string *code;     /* The current chunk of C code */
+    strbuf_t code;        /* The current chunk of C code */
 
     regex_t *curr_rx; /* Current regular-expression fragment being worked on */
     regex_t *rx_stack; /* Stack of regular-expression fragments -- only
@@ -65,10 +76,39 @@ typedef struct {
 
     FILE *verb; /* An optional file to print verbose information */
     len_string *ustate_type; /* The type of the (optional) user state object */
+
+    lstr_list_t *options; /* The settings given by %option directives, in the
+                           * order they appear (e.g. "engine=glushkov") */
+
+    kw_entry_t *kw_pending; /* Keywords waiting for the next pattern */
+    len_string *kw_word;    /* The keyword whose code is being read */
 } lexer_lexer_state;
 
 void init_lexer_lexer_state(lexer_lexer_state *st);
 
+/* Frees everything st holds, including whatever was left half-parsed, and
+ * reinitializes it */
+void free_lexer_lexer_state(lexer_lexer_state *st);
+
+
+#include <stdlib.h>
+
+typedef struct yy_Moonlime_state Moonlime_state;
+
+Moonlime_state * MoonlimeInit( void * (*alloc)(size_t),
+    void (*unalloc)(void *) );
+void MoonlimeDestroy( Moonlime_state *lexer );
+int MoonlimeRead( Moonlime_state *lexer, char *input, size_t len ,  lexer_lexer_state *  data );
+#if 0 || YY_PROFILE
+#include <stdio.h>
+void MoonlimeDumpProfile( Moonlime_state *lexer, FILE *f );
+#endif
+#if YY_TRACE
+#include <stdio.h>
+unsigned long long MoonlimeLatencyPercentile( Moonlime_state *lexer,
+    double p );
+void MoonlimeDumpLatency( Moonlime_state *lexer, FILE *f );
+#endif
 
 
 #ifndef ML_STDIO_H
@@ -92,7 +132,8 @@ void init_lexer_lexer_state(lexer_lexer_state *st)
         return;
 
     st->dir = D_NONE;
-    st->code = st->header = st->top = st->initstate = st->prefix = NULL;
+    strbuf_init(&st->code);
+    st->header = st->top = st->initstate = st->prefix = NULL;
     st->curr_rx = st->rx_stack = NULL;
     st->phead = st->ptail = NULL;
     st->states = st->curr_st = NULL;
@@ -100,6 +141,62 @@ void init_lexer_lexer_state(lexer_lexer_state *st)
     st->npats = 0;
     st->verb = NULL;
     st->ustate_type = NULL;
+    st->options = NULL;
+    st->kw_pending = NULL;
+    st->kw_word = NULL;
+}
+
+static void free_kw_list(kw_entry_t *kw)
+{
+    kw_entry_t *next;
+
+    while(kw != NULL) {
+        next = kw->next;
+        free(kw->word);
+        free(kw->code);
+        free(kw);
+        kw = next;
+    }
+}
+
+void free_lexer_lexer_state(lexer_lexer_state *st)
+{
+    pat_entry_t *p, *pnext;
+    regex_t *rx, *rxnext;
+
+    if(st == NULL)
+        return;
+
+    for(p = st->phead; p != NULL; p = pnext) {
+        pnext = p->next;
+        if(p->rx != NULL)
+            free_regex_tree(p->rx);
+        free(p->code);
+        free_lstr_list(p->states);
+        free_kw_list(p->keywords);
+        free(p);
+    }
+
+    if(st->curr_rx != NULL)
+        free_regex_tree(st->curr_rx);
+    for(rx = st->rx_stack; rx != NULL; rx = rxnext) {
+        rxnext = rx->next;
+        free_regex_tree(rx);
+    }
+    free_lstr_list(st->curr_st);
+    free_kw_list(st->kw_pending);
+    free(st->kw_word);
+    free(strbuf_finish(&st->code));
+
+    free(st->header);
+    free(st->top);
+    free_lstr_list(st->states);
+    free(st->initstate);
+    free(st->prefix);
+    free(st->ustate_type);
+    free_lstr_list(st->options);
+
+    init_lexer_lexer_state(st);
 }
 
 static void add_simple_regex_impl(lexer_lexer_state *st, regex_t *rx,
@@ -200,6 +297,30 @@ static lstr_list_t * add_to_list_impl(const char *yytext, size_t yylen,
 #define add_to_list(yytext, yylen, lst) \
     add_to_list_impl((yytext), (yylen), (lst), __FILE__, __LINE__)
 
+/* Appends the text denoted by yytext and yylen to the end of the list starting
+ * at lst; returns the start of the new version of the list. */
+static lstr_list_t * append_to_list_impl(const char *yytext, size_t yylen,
+                                         lstr_list_t *lst, const char *fname,
+                                         int line_num)
+{
+    lstr_list_t *p, *ent = mod_2(1, lstr_list_t, fname, line_num);
+
+    ent->s = lstring_dupbuf(yylen, yytext);
+    ent->next = NULL;
+
+    if(lst == NULL)
+        return ent;
+
+    for(p = lst; p->next != NULL; p = p->next)
+        ;
+    p->next = ent;
+
+    return lst;
+}
+
+#define append_to_list(yytext, yylen, lst) \
+    append_to_list_impl((yytext), (yylen), (lst), __FILE__, __LINE__)
+
 #ifdef LEXER_DBG
 static const char * directive_name(directive_kind dir)
 {
@@ -218,6 +339,10 @@ static const char * directive_name(directive_kind dir)
         return "%prefix";
       case D_USTATE_TYPE:
         return "%userdata";
+      case D_OPTION:
+        return "%option";
+      case D_KEYWORD:
+        return "%keywords";
     }
 
     return NULL;
@@ -229,7 +354,77 @@ static const char * directive_name(directive_kind dir)
 #define LEN ((int) yylen)
 
 
-#include <stdlib.h>
+/* Whether the DFA is built bit by bit while scanning, from an embedded NFA,
+ * instead of ahead of time (see %option lazy) */
+#define YY_LAZY 0
+
+/* Whether some pattern has keywords, looked up in a perfect hash after the
+ * pattern matches (see %keywords) */
+#define YY_KEYWORDS 0
+
+/* Whether the DFA tables are loaded at run time from a .mlt file (see
+ * moonlime -b) by the runtime in mltrt.c, instead of compiled in */
+#define YY_MLT 0
+
+#define YY_HAS_UDATA 1
+
+/* Whether no DFA state without a match can be reached after one with, so that
+ * the lexer never has to back up to an earlier match (see moonlime --backup);
+ * define it as 0 when compiling the lexer to use the general scanner anyway */
+#ifndef YY_NO_BACKUP
+#define YY_NO_BACKUP 0
+#endif
+
+/* Run just before the code of each pattern (or keyword) matched, with its
+ * number; define it when compiling the lexer to count or trace tokens */
+#ifndef YY_ON_ACTION
+#define YY_ON_ACTION(done_num)
+#endif
+
+/* The number of patterns and keywords, whose actions are numbered from 1 */
+#define YY_N_ACTIONS 32
+
+/* Whether each lexer counts the matches of each pattern and keyword, and the
+ * work done to find them (see %option profile); the counts are written out
+ * by MoonlimeDumpProfile */
+#ifndef YY_PROFILE
+#define YY_PROFILE 0
+#endif
+
+#if YY_PROFILE
+#define YY_COUNT(counter) (++ms->counter)
+#else
+#define YY_COUNT(counter)
+#endif
+
+/* Whether each lexer notes when the bytes it's handed arrive, and keeps a
+ * histogram of how long each token waits, from its first byte's arrival to
+ * its code being run; read it with MoonlimeLatencyPercentile */
+#ifndef YY_TRACE
+#define YY_TRACE 0
+#endif
+
+#if YY_TRACE
+/* Run just before the code of each token, with its pattern (or keyword)
+ * number, the offsets in the input of its first byte and of the byte after
+ * it, and the time its first byte arrived */
+#ifndef YY_TRACE_TOKEN
+#define YY_TRACE_TOKEN(rule, start_offset, end_offset, ts)
+#endif
+
+/* Each power of two of nanoseconds is split into 1 << YY_TRACE_SUB_BITS
+ * buckets, so waits are known to within 1 part in 16 */
+#define YY_TRACE_SUB_BITS 4
+#define YY_TRACE_BUCKETS ((65 - YY_TRACE_SUB_BITS) << YY_TRACE_SUB_BITS)
+#endif
+
+#if YY_MLT
+#include "mltrt.h"
+
+#ifndef YY_MLT_FILE
+#define YY_MLT_FILE 
+#endif
+#endif
 
 typedef struct {
   int done_num;
@@ -242,6 +437,40 @@ typedef struct {
   int dest_state;
 } yyml_trans;
 
+#if YY_TRACE
+typedef struct {
+  unsigned long long offset; /* Of the first byte handed over by a Read */
+  unsigned long long ts;     /* When it was */
+} yytrace_arrival;
+
+typedef struct {
+  void * (*alloc)(size_t);
+  void (*unalloc)(void *);
+  unsigned long long offset;   /* Of the next token's first byte */
+  unsigned long long received; /* Bytes handed over so far */
+  /* The Reads whose bytes may not all be in tokens yet, oldest first, in a
+   * ring starting at q[q_head] */
+  yytrace_arrival *q;
+  int q_head, q_n, q_size;
+  unsigned long long n, max; /* Tokens traced, and their longest wait */
+  unsigned long hist[YY_TRACE_BUCKETS];
+} yytrace;
+#endif
+
+#if YY_MLT
+typedef struct yy_Moonlime_state {
+  mlt_tables *tables;
+  mlt_lexer *lexer;
+  void (*unalloc)(void *);
+  void *udata; /* The user data passed to the Read in progress */
+#if YY_PROFILE
+  unsigned long yyp_hits[YY_N_ACTIONS + 1]; /* Matches of each action */
+#endif
+#if YY_TRACE
+  yytrace yyt;
+#endif
+} yyml_state;
+#else
 typedef struct yy_Moonlime_state {
   int is_in_error;
   int curr_state; /* state of the DFA */
@@ -254,209 +483,785 @@ typedef struct yy_Moonlime_state {
   void (*unalloc)(void *);
   char *buf;
   char start_buf[64];
+#if YY_LAZY
+  /* The cache of DFA states built so far (in one block, lz_mem) */
+  unsigned long *lz_sets; /* The NFA states in each (YY_SET_WORDS words) */
+  int *lz_next;           /* Next state on each character class, or
+                           * YY_LAZY_UNKNOWN or YY_LAZY_DEAD */
+  int *lz_done;           /* done_num of each state */
+  int *lz_chain;          /* Next state in the same hash bucket */
+  int *lz_hash;           /* First state in each hash bucket, or -1 */
+  int *lz_starts;         /* Initial state of each start state, or -1 */
+  int lz_n;               /* Number of states in the cache */
+  int lz_epoch;           /* Number of times the cache has been flushed */
+  unsigned long lz_bytes; /* Characters scanned since the last flush */
+  int lz_thrash;          /* Flushes in a row that came too soon */
+  int lz_nfa_mode;        /* Given up on the cache; simulate the NFA */
+  unsigned long *lz_cur;  /* The NFA states we're in, when simulating */
+  unsigned long *lz_work; /* Scratch set */
+  void *lz_mem;
+#endif
+#if YY_PROFILE
+  unsigned long yyp_hits[YY_N_ACTIONS + 1]; /* Matches of each action */
+  unsigned long yyp_relexed; /* Characters scanned again after backing up */
+  unsigned long yyp_grows;   /* Times buf was enlarged */
+#if YY_LAZY
+  unsigned long yyp_steps;   /* Transitions taken */
+#else
+  unsigned long *yyp_visits; /* Times each DFA state was entered */
+#endif
+#endif
+#if YY_TRACE
+  yytrace yyt;
+#endif
 } yyml_state;
+#endif
 
-typedef struct yy_Moonlime_state Moonlime_state;
-
+#if YY_MLT
+#elif !YY_LAZY
 static yyml_fa yy_x[] = {
 
- {0, 0, 1},
- {25, 1, 1},
- {0, 1, 3},
- {26, 3, 3},
- {24, 3, 4},
+ {0, 0, 4},
  {0, 4, 6},
- {20, 6, 6},
- {0, 6, 13},
- {23, 13, 13},
- {23, 13, 13},
- {0, 13, 16},
- {0, 16, 17},
- {0, 17, 20},
- {0, 20, 21},
- {23, 21, 23},
- {0, 23, 25},
- {0, 25, 28},
- {0, 28, 30},
- {0, 30, 32},
- {21, 32, 32},
- {22, 32, 32},
- {0, 32, 36},
- {10, 36, 36},
- {10, 36, 36},
- {0, 36, 38},
- {9, 38, 38},
- {0, 38, 39},
- {0, 39, 40},
- {11, 40, 40},
- {0, 40, 51},
- {27, 51, 51},
- {26, 51, 51},
- {12, 51, 51},
- {13, 51, 51},
- {16, 51, 51},
- {7, 51, 51},
- {27, 51, 53},
- {0, 53, 55},
- {0, 55, 58},
- {0, 58, 60},
- {1, 60, 60},
- {0, 60, 62},
- {8, 62, 63},
- {8, 63, 63},
- {0, 63, 65},
- {14, 65, 65},
- {0, 65, 66},
- {0, 66, 67},
- {19, 67, 69},
- {0, 69, 70},
+ {0, 6, 9},
+ {0, 9, 10},
+ {0, 10, 12},
+ {0, 12, 14},
+ {0, 14, 21},
+ {0, 21, 25},
+ {0, 25, 36},
+ {0, 36, 40},
+ {0, 40, 50},
+ {27, 50, 51},
+ {31, 51, 51},
+ {27, 51, 54},
+ {28, 54, 54},
+ {26, 54, 54},
+ {30, 54, 54},
+ {29, 54, 56},
+ {25, 56, 56},
+ {24, 56, 57},
+ {20, 57, 57},
+ {23, 57, 57},
+ {23, 57, 57},
+ {0, 57, 60},
+ {0, 60, 63},
+ {23, 63, 65},
+ {21, 65, 65},
+ {22, 65, 65},
+ {10, 65, 65},
+ {10, 65, 65},
+ {0, 65, 67},
+ {11, 67, 67},
+ {32, 67, 67},
+ {31, 67, 67},
+ {12, 67, 67},
+ {13, 67, 67},
+ {16, 67, 67},
+ {7, 67, 67},
+ {32, 67, 69},
+ {8, 69, 70},
  {0, 70, 72},
- {18, 72, 72},
- {0, 72, 75},
- {0, 75, 77},
- {17, 77, 77},
- {15, 77, 77},
- {0, 77, 81},
- {4, 81, 82},
- {4, 82, 83},
- {5, 83, 83},
- {6, 83, 83},
- {0, 83, 93},
- {27, 93, 94},
- {2, 94, 95},
- {3, 95, 95}
+ {19, 72, 74},
+ {15, 74, 74},
+ {4, 74, 75},
+ {4, 75, 76},
+ {5, 76, 76},
+ {6, 76, 76},
+ {32, 76, 77},
+ {3, 77, 77},
+ {27, 77, 80},
+ {27, 80, 83},
+ {0, 83, 84},
+ {0, 84, 85},
+ {0, 85, 86},
+ {0, 86, 88},
+ {0, 88, 90},
+ {9, 90, 90},
+ {0, 90, 91},
+ {0, 91, 93},
+ {0, 93, 95},
+ {8, 95, 95},
+ {14, 95, 95},
+ {0, 95, 96},
+ {0, 96, 97},
+ {0, 97, 100},
+ {2, 100, 101},
+ {27, 101, 105},
+ {1, 105, 105},
+ {29, 105, 106},
+ {0, 106, 109},
+ {0, 109, 110},
+ {0, 110, 113},
+ {0, 113, 114},
+ {0, 114, 116},
+ {0, 116, 118},
+ {17, 118, 118},
+ {27, 118, 122},
+ {1, 122, 123},
+ {0, 123, 125},
+ {9, 125, 125},
+ {0, 125, 127},
+ {14, 127, 127},
+ {18, 127, 127}
 
 };
 
 static yyml_trans yy_y[] = {
 
- { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 1 },
- { {0,0,0,0,0,0,0,0,254,255,255,135,254,255,255,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 4 },
- { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 3 },
- { {0,0,0,0,0,0,255,3,254,255,255,135,254,255,255,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 4 },
- { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 6 },
- { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 3 },
- { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 20 },
- { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 19 },
- { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 14 },
- { {0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 12 },
- { {0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 10 },
- { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 9 },
- { {255,249,255,255,122,127,255,255,255,255,255,255,255,255,255,215,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 8 },
- { {0,0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 11 },
- { {0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 8 },
- { {255,255,255,255,251,255,255,255,255,255,255,239,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 10 },
- { {255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 10 },
- { {0,0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 13 },
- { {0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 8 },
- { {255,255,255,255,127,255,255,255,255,255,255,239,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 12 },
- { {255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 12 },
- { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 18 },
- { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 15 },
- { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 16 },
- { {255,255,255,255,255,251,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 15 },
- { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 8 },
- { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 17 },
- { {255,255,255,255,255,123,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 15 },
- { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 17 },
- { {255,255,255,255,255,123,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 15 },
- { {0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 8 },
- { {255,251,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 18 },
- { {0,0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 28 },
- { {0,0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 24 },
- { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 23 },
- { {255,249,255,255,254,255,255,255,255,255,255,207,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 22 },
- { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 26 },
- { {255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,254,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 25 },
- { {0,0,0,0,0,0,255,3,126,0,0,0,126,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 27 },
- { {0,0,0,0,0,0,255,3,126,0,0,0,126,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 25 },
- { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 55 },
- { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 48 },
- { {0,0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 44 },
- { {0,0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 42 },
- { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 36 },
- { {0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 35 },
- { {0,0,0,0,0,12,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 34 },
- { {0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 33 },
- { {0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 32 },
- { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 31 },
- { {255,249,255,255,254,48,255,111,255,255,255,199,255,255,255,199,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 30 },
- { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 41 },
- { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 37 },
- { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 38 },
- { {255,255,255,255,255,251,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 37 },
- { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 40 },
- { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 39 },
- { {255,255,255,255,255,123,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 37 },
- { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 39 },
- { {255,255,255,255,255,123,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 37 },
- { {0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 40 },
- { {255,251,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 41 },
- { {0,0,0,0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 43 },
- { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 46 },
- { {255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,254,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 45 },
- { {0,0,0,0,0,0,255,3,126,0,0,0,126,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 47 },
- { {0,0,0,0,0,0,255,3,126,0,0,0,126,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 45 },
- { {0,0,0,0,0,0,255,3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 52 },
- { {0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 49 },
- { {0,0,0,0,0,0,255,3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 50 },
- { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 51 },
- { {0,0,0,0,0,0,255,3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 50 },
- { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 54 },
- { {0,0,0,0,0,0,255,3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 52 },
- { {0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 53 },
- { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 54 },
- { {0,0,0,0,0,0,255,3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 50 },
- { {0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 60 },
- { {0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 59 },
- { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 58 },
- { {255,249,255,255,254,239,255,191,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 57 },
- { {255,255,255,255,255,239,255,191,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 57 },
- { {255,255,255,255,255,239,255,191,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 57 },
- { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 55 },
- { {0,0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 44 },
- { {0,0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 42 },
- { {0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 64 },
- { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 36 },
- { {0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 35 },
- { {0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 32 },
- { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 62 },
- { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 31 },
- { {255,249,255,255,222,48,255,111,255,255,255,199,255,255,255,199,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 30 },
- { {0,0,0,0,0,0,0,0,0,0,0,0,254,255,255,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 63 },
- { {0,0,0,0,0,0,0,0,0,0,0,0,254,255,255,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 63 }
+ { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 14 },
+ { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 13 },
+ { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 12 },
+ { {255,249,255,255,254,127,255,255,255,255,255,255,255,255,255,215,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 11 },
+ { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 15 },
+ { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 12 },
+ { {0,0,0,0,0,0,0,0,0,0,0,128,254,255,255,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 17 },
+ { {0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 16 },
+ { {0,2,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 12 },
+ { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 18 },
+ { {0,0,0,0,0,0,0,0,254,255,255,135,254,255,255,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 19 },
+ { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 12 },
+ { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 20 },
+ { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 12 },
+ { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 27 },
+ { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 26 },
+ { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 25 },
+ { {0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 24 },
+ { {0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 23 },
+ { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 22 },
+ { {255,249,255,255,122,127,255,255,255,255,255,255,255,255,255,215,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 21 },
+ { {0,0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 31 },
+ { {0,0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 30 },
+ { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 29 },
+ { {255,249,255,255,254,255,255,255,255,255,255,207,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 28 },
+ { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 42 },
+ { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 41 },
+ { {0,0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 40 },
+ { {0,0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 39 },
+ { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 38 },
+ { {0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 37 },
+ { {0,0,0,0,0,12,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 36 },
+ { {0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 35 },
+ { {0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 34 },
+ { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 33 },
+ { {255,249,255,255,254,48,255,111,255,255,255,199,255,255,255,199,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 32 },
+ { {0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 46 },
+ { {0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 45 },
+ { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 44 },
+ { {255,249,255,255,254,239,255,191,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 43 },
+ { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 42 },
+ { {0,0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 40 },
+ { {0,0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 39 },
+ { {0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 48 },
+ { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 38 },
+ { {0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 37 },
+ { {0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 34 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 47 },
+ { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 33 },
+ { {255,249,255,255,222,48,255,111,255,255,255,199,255,255,255,199,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 32 },
+ { {255,249,255,255,254,255,255,255,255,255,255,255,255,255,255,215,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 11 },
+ { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 50 },
+ { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 49 },
+ { {255,249,255,255,254,123,255,255,255,255,255,255,255,255,255,215,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 11 },
+ { {0,0,0,0,0,0,0,0,0,0,0,128,254,255,255,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 17 },
+ { {0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 51 },
+ { {0,0,0,0,0,0,255,3,254,255,255,135,254,255,255,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 19 },
+ { {0,0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 52 },
+ { {0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 21 },
+ { {255,255,255,255,251,255,255,255,255,255,255,239,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 23 },
+ { {0,0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 53 },
+ { {0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 21 },
+ { {255,255,255,255,127,255,255,255,255,255,255,239,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 24 },
+ { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 55 },
+ { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 54 },
+ { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 57 },
+ { {255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,254,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 56 },
+ { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 59 },
+ { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 58 },
+ { {0,0,0,0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 60 },
+ { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 62 },
+ { {255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,254,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 61 },
+ { {0,0,0,0,0,0,255,3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 64 },
+ { {0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 63 },
+ { {255,255,255,255,255,239,255,191,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 43 },
+ { {255,255,255,255,255,239,255,191,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 43 },
+ { {0,0,0,0,0,0,0,0,0,0,0,0,254,255,255,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 65 },
+ { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 66 },
+ { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,40,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 58 },
+ { {255,249,255,255,254,251,255,255,255,255,255,255,255,255,255,215,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 49 },
+ { {0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 67 },
+ { {0,2,0,0,1,0,0,0,0,0,0,0,0,0,0,40,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 59 },
+ { {255,249,255,255,254,255,255,255,255,255,255,255,255,255,255,215,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 50 },
+ { {0,0,0,0,0,64,255,3,254,255,255,135,254,255,255,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 68 },
+ { {255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 23 },
+ { {255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 24 },
+ { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 69 },
+ { {255,255,255,255,255,251,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 54 },
+ { {0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 21 },
+ { {255,251,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 55 },
+ { {0,0,0,0,0,0,255,3,126,0,0,0,126,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 70 },
+ { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 71 },
+ { {255,255,255,255,255,251,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 58 },
+ { {0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 67 },
+ { {255,251,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 59 },
+ { {0,0,0,0,0,0,255,3,126,0,0,0,126,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 72 },
+ { {0,0,0,0,0,0,255,3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 73 },
+ { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 75 },
+ { {0,0,0,0,0,0,255,3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 64 },
+ { {0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 74 },
+ { {0,0,0,0,0,0,0,0,0,0,0,0,254,255,255,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 65 },
+ { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 77 },
+ { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 76 },
+ { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,40,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 58 },
+ { {255,249,255,255,254,123,255,255,255,255,255,255,255,255,255,215,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 49 },
+ { {0,0,0,0,0,64,255,3,254,255,255,135,254,255,255,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 68 },
+ { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 21 },
+ { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 78 },
+ { {255,255,255,255,255,123,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 54 },
+ { {0,0,0,0,0,0,255,3,126,0,0,0,126,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 79 },
+ { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 67 },
+ { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 80 },
+ { {255,255,255,255,255,123,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 58 },
+ { {0,0,0,0,0,0,255,3,126,0,0,0,126,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 81 },
+ { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 82 },
+ { {0,0,0,0,0,0,255,3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 73 },
+ { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 75 },
+ { {0,0,0,0,0,0,255,3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 73 },
+ { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 11 },
+ { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 76 },
+ { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,40,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 58 },
+ { {255,249,255,255,254,123,255,255,255,255,255,255,255,255,255,215,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 49 },
+ { {255,249,255,255,254,255,255,255,255,255,255,255,255,255,255,215,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 11 },
+ { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 78 },
+ { {255,255,255,255,255,123,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 54 },
+ { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 80 },
+ { {255,255,255,255,255,123,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 58 }
 
 };
 
 static int yy_init_states[] = {
 
  0,
+ 1,
  2,
+ 3,
+ 4,
  5,
+ 6,
  7,
- 21,
- 29,
- 56,
- 61
+ 8,
+ 9,
+ 10
+
+};
+#else
+static yyml_fa yy_nx[] = {
+
+};
+
+static yyml_trans yy_ny[] = {
+
+};
+
+/* The NFA states each start state begins in, as -1-terminated lists */
+static int yy_nfa_inits[] = {
 
 };
 
-#define YY_STATE_NON_WHSP_IS_ERROR 0
-#define YY_STATE_PRE_C_TOKEN 1
-#define YY_STATE_PRE_C_CODE 2
-#define YY_STATE_C_CODE 3
-#define YY_STATE_IN_CHARCLASS 4
-#define YY_STATE_IN_REGEX 5
-#define YY_STATE_IN_SELECTOR 6
-#define YY_STATE_MAIN 7
-#define YY_MAXSTATE 7
+/* Where each start state's list starts in yy_nfa_inits */
+static int yy_nfa_starts[] = {
+
+};
+
+/* The class of each character; no transition tells those in a class apart */
+static unsigned char yy_classes[256] = {
+
+};
+
+#define YY_NFA_STATES 
+#define YY_NCLASSES 
+#define YY_SET_WORDS ((YY_NFA_STATES + 31) / 32)
+
+#ifndef YY_LAZY_CACHE
+#define YY_LAZY_CACHE 1024
+#endif
+/* A flush after fewer than YY_LAZY_MIN_BYTES characters per cached state
+ * counts as thrashing; after YY_LAZY_MAX_THRASH of those in a row, the lexer
+ * stops caching and simulates the NFA directly. */
+#ifndef YY_LAZY_MIN_BYTES
+#define YY_LAZY_MIN_BYTES 10
+#endif
+#ifndef YY_LAZY_MAX_THRASH
+#define YY_LAZY_MAX_THRASH 3
+#endif
+#define YY_LAZY_HASH (2 * YY_LAZY_CACHE)
+#define YY_LAZY_UNKNOWN (-1)
+#define YY_LAZY_DEAD (-2)
+#endif
+
+#if YY_KEYWORDS && !YY_MLT
+
+#endif
+
+#if YY_TRACE
+#ifndef YY_TRACE_NOW
+#include <time.h>
+
+static unsigned long long yytrace_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* The time now, in nanoseconds */
+#define YY_TRACE_NOW() yytrace_now()
+#endif
+
+static void yytrace_init(yytrace *tr, void * (*alloc)(size_t),
+                         void (*unalloc)(void *))
+{
+    int i;
+
+    tr->alloc = alloc;
+    tr->unalloc = unalloc;
+    tr->offset = tr->received = 0;
+    tr->q = NULL;
+    tr->q_head = tr->q_n = tr->q_size = 0;
+    tr->n = tr->max = 0;
+    for(i = 0; i < YY_TRACE_BUCKETS; ++i)
+        tr->hist[i] = 0;
+}
+
+static void yytrace_free(yytrace *tr)
+{
+    if(tr->q != NULL)
+        tr->unalloc(tr->q);
+}
+
+/* Forgets the Reads all of whose bytes are in tokens already */
+static void yytrace_drop(yytrace *tr)
+{
+    while(tr->q_n > 1 &&
+          tr->q[(tr->q_head + 1) % tr->q_size].offset <= tr->offset) {
+        tr->q_head = (tr->q_head + 1) % tr->q_size;
+        --tr->q_n;
+    }
+}
+
+/* Notes the arrival of len more bytes */
+static void yytrace_arrive(yytrace *tr, size_t len)
+{
+    yytrace_arrival *q;
+    int i;
+
+    yytrace_drop(tr);
+
+    if(tr->q_n == tr->q_size) {
+        /* With no room to be had, the bytes are taken to have come with the
+         * last Read's, making their tokens seem to wait longer */
+        if((q = tr->alloc((tr->q_size ? 2 * tr->q_size : 8) *
+                          sizeof(yytrace_arrival))) == NULL) {
+            tr->received += len;
+            return;
+        }
+        for(i = 0; i < tr->q_n; ++i)
+            q[i] = tr->q[(tr->q_head + i) % tr->q_size];
+        yytrace_free(tr);
+        tr->q = q;
+        tr->q_head = 0;
+        tr->q_size = tr->q_size ? 2 * tr->q_size : 8;
+    }
+
+    q = &tr->q[(tr->q_head + tr->q_n++) % tr->q_size];
+    q->offset = tr->received;
+    q->ts = YY_TRACE_NOW();
+    tr->received += len;
+}
+
+/* Records the wait of the next token, len bytes long, matched by rule */
+static void yytrace_token(yytrace *tr, int rule, size_t len)
+{
+    unsigned long long now = YY_TRACE_NOW(), arrived, wait;
+    int e, b;
+
+    yytrace_drop(tr);
+    arrived = (tr->q_n > 0) ? tr->q[tr->q_head].ts : now;
+    wait = (now > arrived) ? now - arrived : 0;
+
+    /* Small waits have a bucket each; bigger ones share with those having
+     * the same highest YY_TRACE_SUB_BITS + 1 bits */
+    if(wait < (2ULL << YY_TRACE_SUB_BITS))
+        b = (int) wait;
+    else {
+        for(e = YY_TRACE_SUB_BITS + 1; (wait >> e) > 1; ++e)
+            ;
+        b = ((e - YY_TRACE_SUB_BITS) << YY_TRACE_SUB_BITS) +
+            (int) (wait >> (e - YY_TRACE_SUB_BITS));
+    }
+    ++tr->hist[b];
+    ++tr->n;
+    if(wait > tr->max)
+        tr->max = wait;
+
+    YY_TRACE_TOKEN(rule, tr->offset, tr->offset + len, arrived);
+    tr->offset += len;
+}
+#endif
+
+#define YY_STATE_IN_KEYWORDS 0
+#define YY_STATE_PRE_KEYWORDS 1
+#define YY_STATE_IN_OPTION 2
+#define YY_STATE_NON_WHSP_IS_ERROR 3
+#define YY_STATE_PRE_C_TOKEN 4
+#define YY_STATE_PRE_C_CODE 5
+#define YY_STATE_C_CODE 6
+#define YY_STATE_IN_CHARCLASS 7
+#define YY_STATE_IN_REGEX 8
+#define YY_STATE_IN_SELECTOR 9
+#define YY_STATE_MAIN 10
+#define YY_MAXSTATE 10
 #define YY_INITSTATE YY_STATE_MAIN
 
 
+#if YY_LAZY && !YY_MLT
+static void yylazy_flush(yyml_state *ms)
+{
+    int i;
+
+    for(i = 0; i < YY_LAZY_HASH; ++i)
+        ms->lz_hash[i] = -1;
+    for(i = 0; i <= YY_MAXSTATE; ++i)
+        ms->lz_starts[i] = -1;
+
+    ms->lz_n = 0;
+    ++ms->lz_epoch;
+}
+
+static int yylazy_alloc(yyml_state *ms)
+{
+    size_t n_words = (size_t) (YY_LAZY_CACHE + 2) * YY_SET_WORDS;
+    size_t n_ints = (size_t) YY_LAZY_CACHE * (YY_NCLASSES + 2) +
+                    YY_LAZY_HASH + YY_MAXSTATE + 1;
+    char *mem = ms->alloc(n_words * sizeof(unsigned long) +
+                          n_ints * sizeof(int));
+
+    if(mem == NULL)
+        return 0;
+
+    ms->lz_mem = mem;
+    ms->lz_sets = (unsigned long *) mem;
+    ms->lz_cur = ms->lz_sets + YY_LAZY_CACHE * YY_SET_WORDS;
+    ms->lz_work = ms->lz_cur + YY_SET_WORDS;
+    ms->lz_next = (int *) (ms->lz_work + YY_SET_WORDS);
+    ms->lz_done = ms->lz_next + YY_LAZY_CACHE * YY_NCLASSES;
+    ms->lz_chain = ms->lz_done + YY_LAZY_CACHE;
+    ms->lz_hash = ms->lz_chain + YY_LAZY_CACHE;
+    ms->lz_starts = ms->lz_hash + YY_LAZY_HASH;
+
+    ms->lz_epoch = 0;
+    ms->lz_bytes = 0;
+    ms->lz_thrash = 0;
+    ms->lz_nfa_mode = 0;
+    yylazy_flush(ms);
+
+    return 1;
+}
+
+/* Sets out to the NFA states reached from those in set on the character c;
+ * returns the least done_num among them (0 if none), or -1 if there are no
+ * such states at all */
+static int yylazy_step(const unsigned long *set, unsigned char c,
+                       unsigned long *out)
+{
+    int i, j, s, t, d, done_num = 0, found = 0;
+
+    for(i = 0; i < YY_SET_WORDS; ++i)
+        out[i] = 0;
+
+    for(i = 0; i < YY_SET_WORDS; ++i) {
+        if(set[i] == 0)
+            continue;
+
+        for(j = 0; j < 32; ++j) {
+            if(!(set[i] & (1UL << j)))
+                continue;
+
+            s = i * 32 + j;
+            for(t = yy_nx[s].trans_start; t < yy_nx[s].trans_end; ++t) {
+                if(!(yy_ny[t].transset[c >> 3] & (1 << (c & 7))))
+                    continue;
+
+                d = yy_ny[t].dest_state;
+                out[d / 32] |= 1UL << (d % 32);
+                found = 1;
+                if(yy_nx[d].done_num &&
+                   (done_num == 0 || yy_nx[d].done_num < done_num))
+                    done_num = yy_nx[d].done_num;
+            }
+        }
+    }
+
+    return found ? done_num : -1;
+}
+
+/* Returns the cache index of the DFA state for the NFA states in set, adding
+ * it if need be (flushing the cache first if it's full), or -1 if the cache
+ * is thrashing and the lexer has switched to simulating the NFA */
+static int yylazy_state(yyml_state *ms, const unsigned long *set,
+                        int done_num)
+{
+    unsigned long h = 2166136261UL;
+    int i, k;
+
+    for(i = 0; i < YY_SET_WORDS; ++i)
+        h = (h ^ set[i]) * 16777619UL;
+    h %= YY_LAZY_HASH;
+
+    for(k = ms->lz_hash[h]; k >= 0; k = ms->lz_chain[k]) {
+        for(i = 0; i < YY_SET_WORDS; ++i)
+            if(ms->lz_sets[k * YY_SET_WORDS + i] != set[i])
+                break;
+        if(i == YY_SET_WORDS)
+            return k;
+    }
+
+    if(ms->lz_n >= YY_LAZY_CACHE) {
+        if(ms->lz_bytes < (unsigned long) YY_LAZY_MIN_BYTES * YY_LAZY_CACHE) {
+            if(++ms->lz_thrash >= YY_LAZY_MAX_THRASH) {
+                ms->lz_nfa_mode = 1;
+                return -1;
+            }
+        } else
+            ms->lz_thrash = 0;
+
+        ms->lz_bytes = 0;
+        yylazy_flush(ms);
+    }
+
+    k = ms->lz_n++;
+    for(i = 0; i < YY_SET_WORDS; ++i)
+        ms->lz_sets[k * YY_SET_WORDS + i] = set[i];
+    for(i = 0; i < YY_NCLASSES; ++i)
+        ms->lz_next[k * YY_NCLASSES + i] = YY_LAZY_UNKNOWN;
+    ms->lz_done[k] = done_num;
+    ms->lz_chain[k] = ms->lz_hash[h];
+    ms->lz_hash[h] = k;
+
+    return k;
+}
+
+static void yylazy_swap_sets(yyml_state *ms)
+{
+    unsigned long *tmp = ms->lz_cur;
+
+    ms->lz_cur = ms->lz_work;
+    ms->lz_work = tmp;
+}
+
+/* Puts the lexer in the initial state of the start state start_state */
+static void yylazy_start(yyml_state *ms, int start_state)
+{
+    int i, k, d, done_num = 0;
+
+    if(!ms->lz_nfa_mode && ms->lz_starts[start_state] >= 0) {
+        ms->curr_state = ms->lz_starts[start_state];
+        return;
+    }
+
+    for(i = 0; i < YY_SET_WORDS; ++i)
+        ms->lz_work[i] = 0;
+
+    for(i = yy_nfa_starts[start_state]; (d = yy_nfa_inits[i]) >= 0; ++i) {
+        ms->lz_work[d / 32] |= 1UL << (d % 32);
+        if(yy_nx[d].done_num &&
+           (done_num == 0 || yy_nx[d].done_num < done_num))
+            done_num = yy_nx[d].done_num;
+    }
+
+    if(!ms->lz_nfa_mode &&
+       (k = yylazy_state(ms, ms->lz_work, done_num)) >= 0) {
+        ms->curr_state = ms->lz_starts[start_state] = k;
+        return;
+    }
+
+    yylazy_swap_sets(ms);
+}
+
+/* Moves the lexer on by the character c, building the DFA state it goes to
+ * if it isn't in the cache; returns that state's done_num, or -1 (leaving
+ * the lexer where it was) if there's no transition on c */
+static int yylazy_next(yyml_state *ms, unsigned char c)
+{
+    int from = ms->curr_state, cls = yy_classes[c], next, done_num, epoch;
+
+    ++ms->lz_bytes;
+
+    if(ms->lz_nfa_mode) {
+        if((done_num = yylazy_step(ms->lz_cur, c, ms->lz_work)) < 0)
+            return -1;
+        yylazy_swap_sets(ms);
+        return done_num;
+    }
+
+    next = ms->lz_next[from * YY_NCLASSES + cls];
+
+    if(next == YY_LAZY_UNKNOWN) {
+        done_num = yylazy_step(ms->lz_sets + from * YY_SET_WORDS, c,
+                               ms->lz_work);
+
+        if(done_num < 0)
+            next = YY_LAZY_DEAD;
+        else {
+            epoch = ms->lz_epoch;
+
+            if((next = yylazy_state(ms, ms->lz_work, done_num)) < 0) {
+                yylazy_swap_sets(ms);
+                return done_num;
+            }
+
+            if(epoch != ms->lz_epoch) { /* from was flushed */
+                ms->curr_state = next;
+                return done_num;
+            }
+        }
+
+        ms->lz_next[from * YY_NCLASSES + cls] = next;
+    }
+
+    if(next == YY_LAZY_DEAD)
+        return -1;
+
+    ms->curr_state = next;
+    return ms->lz_done[next];
+}
+#endif
+
+static void yymoonlime_action(int done_num, const char *yytext, size_t yylen,
+                              int *yy_start_state ,  lexer_lexer_state *  yydata);
+
+#if YY_KEYWORDS && !YY_MLT
+static int yykeyword(int done_num, const char *yytext, size_t yylen);
+#endif
+
+#if YY_MLT
+static void yymlt_action(int rule, const char *yytext, size_t yylen,
+                         int *start_state, void *data)
+{
+    yyml_state *ms = data;
+
+    YY_COUNT(yyp_hits[rule]);
+#if YY_TRACE
+    yytrace_token(&ms->yyt, rule, yylen);
+#endif
+#if YY_HAS_UDATA
+    yymoonlime_action(rule, yytext, yylen, start_state,
+                      *( lexer_lexer_state *  *) ms->udata);
+#else
+    (void) ms;
+    yymoonlime_action(rule, yytext, yylen, start_state);
+#endif
+}
+
+Moonlime_state * MoonlimeInit( void * (*alloc)(size_t),
+    void (*unalloc)(void *) )
+{
+    yyml_state *ms;
+#if YY_PROFILE
+    int i;
+#endif
+
+    if(alloc == NULL || unalloc == NULL)
+        return NULL;
+
+    if((ms = alloc(sizeof(yyml_state))) == NULL)
+        return NULL;
+
+    ms->unalloc = unalloc;
+    ms->udata = NULL;
+    ms->lexer = NULL;
+#if YY_PROFILE
+    for(i = 0; i <= YY_N_ACTIONS; ++i)
+        ms->yyp_hits[i] = 0;
+#endif
+#if YY_TRACE
+    yytrace_init(&ms->yyt, alloc, unalloc);
+#endif
+
+    /* Tables for a different set of actions can't be used */
+    if((ms->tables = mlt_open(YY_MLT_FILE)) == NULL ||
+       mlt_n_actions(ms->tables) != YY_N_ACTIONS ||
+       mlt_n_starts(ms->tables) != YY_MAXSTATE + 1 ||
+       (ms->lexer = mlt_init(ms->tables, yymlt_action, ms, alloc,
+                             unalloc)) == NULL) {
+        mlt_close(ms->tables);
+        unalloc(ms);
+        return NULL;
+    }
+
+    return ms;
+}
+
+void MoonlimeDestroy( Moonlime_state *lexer )
+{
+    yyml_state *ms = lexer;
+
+    if(ms == NULL)
+        return;
+
+    mlt_destroy(ms->lexer);
+    mlt_close(ms->tables);
+#if YY_TRACE
+    yytrace_free(&ms->yyt);
+#endif
+    ms->unalloc(ms);
+}
+
+int MoonlimeRead( Moonlime_state *lexer, char *input, size_t len ,  lexer_lexer_state *  data )
+{
+    yyml_state *ms = lexer;
+
+    if(ms == NULL)
+        return 0;
+
+#if YY_HAS_UDATA
+    ms->udata = &data;
+#endif
+#if YY_TRACE
+    if(len > 0)
+        yytrace_arrive(&ms->yyt, len);
+#endif
+    return mlt_read(ms->lexer, input, len);
+}
+
+#if YY_PROFILE
+/* The runtime does the scanning, so only the matches are counted */
+void MoonlimeDumpProfile( Moonlime_state *lexer, FILE *f )
+{
+    yyml_state *ms = lexer;
+    int i;
+
+    if(ms == NULL)
+        return;
+
+    fputs("Moonlime profile:\n", f);
+    for(i = 1; i <= YY_N_ACTIONS; ++i)
+        if(ms->yyp_hits[i] != 0)
+            fprintf(f, "  action %d: %lu matches\n", i, ms->yyp_hits[i]);
+}
+#endif
+#else
 Moonlime_state * MoonlimeInit( void * (*alloc)(size_t),
     void (*unalloc)(void *) )
 {
     yyml_state *ms;
+#if YY_PROFILE
+    int i;
+#if !YY_LAZY
+    int n_states;
+#endif
+#endif
 
     if(alloc == NULL || unalloc == NULL)
         return NULL;
@@ -466,8 +1271,30 @@ Moonlime_state * MoonlimeInit( void * (*alloc)(size_t),
     if(ms == NULL)
         return NULL;
 
+    ms->alloc = alloc;
+    ms->unalloc = unalloc;
+
+#if YY_PROFILE
+    for(i = 0; i <= YY_N_ACTIONS; ++i)
+        ms->yyp_hits[i] = 0;
+    ms->yyp_relexed = ms->yyp_grows = 0;
+#if YY_LAZY
+    ms->yyp_steps = 0;
+#else
+    n_states = sizeof(yy_x) / sizeof(yy_x[0]);
+    if((ms->yyp_visits = alloc(n_states * sizeof(unsigned long))) == NULL) {
+        unalloc(ms);
+        return NULL;
+    }
+    for(i = 0; i < n_states; ++i)
+        ms->yyp_visits[i] = 0;
+#endif
+#endif
+#if YY_TRACE
+    yytrace_init(&ms->yyt, alloc, unalloc);
+#endif
+
     ms->is_in_error = 0;
-    ms->curr_state = yy_init_states[YY_INITSTATE];
     ms->curr_start_state = YY_INITSTATE;
     ms->last_done_num = 0;
     ms->last_done_len = 0;
@@ -476,8 +1303,15 @@ Moonlime_state * MoonlimeInit( void * (*alloc)(size_t),
     ms->curr_buf_size = 64;
     ms->buf = ms->start_buf;
 
-    ms->alloc = alloc;
-    ms->unalloc = unalloc;
+#if YY_LAZY
+    if(!yylazy_alloc(ms)) {
+        unalloc(ms);
+        return NULL;
+    }
+    yylazy_start(ms, YY_INITSTATE);
+#else
+    ms->curr_state = yy_init_states[YY_INITSTATE];
+#endif
 
     return ms;
 }
@@ -493,16 +1327,47 @@ void MoonlimeDestroy( Moonlime_state *lexer )
         ms->unalloc(ms->buf);
     }
 
+#if YY_LAZY
+    ms->unalloc(ms->lz_mem);
+#endif
+#if YY_PROFILE && !YY_LAZY
+    ms->unalloc(ms->yyp_visits);
+#endif
+#if YY_TRACE
+    yytrace_free(&ms->yyt);
+#endif
+
     ms->unalloc(ms);
 }
 
-static void yymoonlime_action(int done_num, const char *yytext, size_t yylen,
-                              int *yy_start_state ,  lexer_lexer_state *  yydata);
-
-static int yyrun_char(yyml_state *ms, char c, int add_to_buf, int len)
+/* Adds c to the text of the token being scanned */
+static int yyadd_char(yyml_state *ms, char c)
 {
-    int curr_trans, end_trans, c_idx, c_mask, next_state, i;
     char *new_buf;
+    int i;
+
+    if(ms->string_len >= ms->curr_buf_size - 1) {
+        if((new_buf = ms->alloc(ms->curr_buf_size * 2)) == NULL) {
+            ms->is_in_error = 1;
+            return 0;
+        }
+        YY_COUNT(yyp_grows);
+        for(i = 0; i < ms->string_len; ++i)
+            new_buf[i] = ms->buf[i];
+        ms->curr_buf_size *= 2;
+        if(ms->buf != ms->start_buf)
+            ms->unalloc(ms->buf);
+        ms->buf = new_buf;
+    }
+    ms->buf[ms->string_len++] = c;
+    return 1;
+}
+
+#if YY_NO_BACKUP
+/* Takes the DFA's transition on c, if it has one, adding c to the token */
+static int yystep(yyml_state *ms, char c)
+{
+    int curr_trans, end_trans, c_idx, c_mask;
 
     curr_trans = yy_x[ms->curr_state].trans_start;
     end_trans = yy_x[ms->curr_state].trans_end;
@@ -510,25 +1375,55 @@ static int yyrun_char(yyml_state *ms, char c, int add_to_buf, int len)
     c_idx = ((unsigned char) c) >> 3;
     c_mask = 1 << (c & 7);
 
-    if(add_to_buf) {
-        if(ms->string_len >= ms->curr_buf_size - 1) {
-                if((new_buf = ms->alloc(ms->curr_buf_size * 2)) == NULL) {
-                    ms->is_in_error = 1;
+    while(curr_trans < end_trans) {
+        if(yy_y[curr_trans].transset[c_idx] & c_mask) {
+            if(!yyadd_char(ms, c))
                 return 0;
-            }
-            for(i = 0; i < ms->string_len; ++i)
-                new_buf[i] = ms->buf[i];
-            ms->curr_buf_size *= 2;
-            if(ms->buf != ms->start_buf)
-                ms->unalloc(ms->buf);
-            ms->buf = new_buf;
+            ms->curr_state = yy_y[curr_trans].dest_state;
+            YY_COUNT(yyp_visits[ms->curr_state]);
+            return 1;
         }
-        ms->buf[ms->string_len++] = c;
+        ++curr_trans;
+    }
+
+    return 0;
+}
+#else
+static int yyrun_char(yyml_state *ms, char c, int add_to_buf, int len)
+{
+#if YY_LAZY
+    int done_num;
+#else
+    int curr_trans, end_trans, c_idx, c_mask, next_state;
+#endif
+
+    if(add_to_buf) {
+        if(!yyadd_char(ms, c))
+            return 0;
+    } else
+        YY_COUNT(yyp_relexed);
+
+#if YY_LAZY
+    if((done_num = yylazy_next(ms, (unsigned char) c)) < 0)
+        return 0;
+    YY_COUNT(yyp_steps);
+
+    if(done_num) {
+        ms->last_done_num = done_num;
+        ms->last_done_len = len;
     }
+    return 1;
+#else
+    curr_trans = yy_x[ms->curr_state].trans_start;
+    end_trans = yy_x[ms->curr_state].trans_end;
+
+    c_idx = ((unsigned char) c) >> 3;
+    c_mask = 1 << (c & 7);
 
     while(curr_trans < end_trans) {
         if(yy_y[curr_trans].transset[c_idx] & c_mask) {
             ms->curr_state = next_state = yy_y[curr_trans].dest_state;
+            YY_COUNT(yyp_visits[next_state]);
 
             if(yy_x[next_state].done_num) {
                 ms->last_done_num = yy_x[next_state].done_num;
@@ -540,7 +1435,9 @@ static int yyrun_char(yyml_state *ms, char c, int add_to_buf, int len)
     }
 
     return 0;
+#endif
 }
+#endif
 
 static void yyreset_state(yyml_state *ms)
 {
@@ -550,9 +1447,81 @@ static void yyreset_state(yyml_state *ms)
         ms->buf[i - ms->last_done_len] = ms->buf[i];
     ms->string_len -= ms->last_done_len;
     ms->last_done_len = ms->last_done_num = 0;
+#if YY_LAZY
+    yylazy_start(ms, ms->curr_start_state);
+#else
     ms->curr_state = yy_init_states[ms->curr_start_state];
+#endif
+}
+
+/* Runs the code of the longest match found, and starts scanning again just
+ * after it */
+static void yyaccept(yyml_state *ms ,  lexer_lexer_state *  data)
+{
+    int done_num = ms->last_done_num;
+
+#if YY_KEYWORDS
+    done_num = yykeyword(done_num, ms->buf, ms->last_done_len);
+#endif
+    YY_COUNT(yyp_hits[done_num]);
+#if YY_TRACE
+    yytrace_token(&ms->yyt, done_num, ms->last_done_len);
+#endif
+
+    yymoonlime_action(done_num, ms->buf, ms->last_done_len,
+                      &(ms->curr_start_state) , data);
+    yyreset_state(ms);
 }
 
+#if YY_NO_BACKUP
+/* With no backing up, the longest match is the one the DFA is in when it
+ * has no transition on the next character, and no character is scanned
+ * twice */
+int MoonlimeRead( Moonlime_state *lexer, char *input, size_t len ,  lexer_lexer_state *  data )
+{
+    char *end = input + len;
+    yyml_state *ms = lexer;
+
+    if(ms == NULL || ms->is_in_error)
+        return 0;
+
+#if YY_TRACE
+    if(len > 0)
+        yytrace_arrive(&ms->yyt, len);
+#endif
+
+    while(input < end) {
+        if(!yystep(ms, *input)) {
+            if(ms->is_in_error)
+                return 0;
+            if(ms->string_len == 0 || !yy_x[ms->curr_state].done_num) {
+                ms->is_in_error = 1; /* no pattern matches buf */
+                return 0;
+            }
+
+            /* *input starts the next token */
+            ms->last_done_num = yy_x[ms->curr_state].done_num;
+            ms->last_done_len = ms->string_len;
+            yyaccept(ms , data);
+            continue;
+        }
+        ++input;
+    }
+
+    if(len == 0 && ms->string_len > 0) { /* Signifies EOF */
+        if(!yy_x[ms->curr_state].done_num) {
+            ms->is_in_error = 1;
+            return 0;
+        }
+
+        ms->last_done_num = yy_x[ms->curr_state].done_num;
+        ms->last_done_len = ms->string_len;
+        yyaccept(ms , data);
+    }
+
+    return 1;
+}
+#else
 int MoonlimeRead( Moonlime_state *lexer, char *input, size_t len ,  lexer_lexer_state *  data )
 {
     int done_relexing, i;
@@ -562,6 +1531,11 @@ int MoonlimeRead( Moonlime_state *lexer, char *input, size_t len ,  lexer_lexer_
     if(ms == NULL || ms->is_in_error)
         return 0;
 
+#if YY_TRACE
+    if(len > 0)
+        yytrace_arrive(&ms->yyt, len);
+#endif
+
     if(len == 0) { /* Signifies EOF */
         if(ms->string_len == 0)
             return 1;
@@ -571,9 +1545,7 @@ int MoonlimeRead( Moonlime_state *lexer, char *input, size_t len ,  lexer_lexer_
             return 0;
         }
 
-        yymoonlime_action(ms->last_done_num, ms->buf, ms->last_done_len,
-                          &(ms->curr_start_state) , data);
-        yyreset_state(ms);
+        yyaccept(ms , data);
 
         while(ms->string_len > 0) {
             for(i = 0; i < ms->string_len; ++i) {
@@ -584,10 +1556,7 @@ int MoonlimeRead( Moonlime_state *lexer, char *input, size_t len ,  lexer_lexer_
                         return 0;
                     }
 
-                    yymoonlime_action(ms->last_done_num, ms->buf,
-                                      ms->last_done_len,
-                                      &(ms->curr_start_state) , data);
-                    yyreset_state(ms);
+                    yyaccept(ms , data);
                     break;
                 }
             }
@@ -604,9 +1573,7 @@ int MoonlimeRead( Moonlime_state *lexer, char *input, size_t len ,  lexer_lexer_
                 ms->is_in_error = 1;
                 return 0;
             }
-            yymoonlime_action(ms->last_done_num, ms->buf, ms->last_done_len,
-                              &(ms->curr_start_state) , data);
-            yyreset_state(ms);
+            yyaccept(ms , data);
 
             /* Re-lex remaining part of the buffer */
             done_relexing = 0;
@@ -619,10 +1586,7 @@ int MoonlimeRead( Moonlime_state *lexer, char *input, size_t len ,  lexer_lexer_
                         if(ms->is_in_error)
                             return 0;
 
-                        yymoonlime_action(ms->last_done_num, ms->buf,
-                                          ms->last_done_len,
-                                          &(ms->curr_start_state) , data);
-                        yyreset_state(ms);
+                        yyaccept(ms , data);
                         i = 0;
                         continue;
                     }
@@ -638,12 +1602,135 @@ int MoonlimeRead( Moonlime_state *lexer, char *input, size_t len ,  lexer_lexer_
 
     return 1;
 }
+#endif
+
+#if YY_PROFILE
+void MoonlimeDumpProfile( Moonlime_state *lexer, FILE *f )
+{
+    yyml_state *ms = lexer;
+    int i;
+
+    if(ms == NULL)
+        return;
+
+    fputs("Moonlime profile:\n", f);
+    for(i = 1; i <= YY_N_ACTIONS; ++i)
+        if(ms->yyp_hits[i] != 0)
+            fprintf(f, "  action %d: %lu matches\n", i, ms->yyp_hits[i]);
+
+    fprintf(f, "  characters re-scanned after backing up: %lu\n"
+               "  buffer enlargements: %lu\n", ms->yyp_relexed,
+            ms->yyp_grows);
+
+#if YY_LAZY
+    /* The cache is first flushed when it's set up */
+    fprintf(f, "  transitions: %lu (%d cache flushes)\n", ms->yyp_steps,
+            ms->lz_epoch - 1);
+#else
+    for(i = 0; i < (int) (sizeof(yy_x) / sizeof(yy_x[0])); ++i)
+        if(ms->yyp_visits[i] != 0)
+            fprintf(f, "  DFA state %d: %lu visits\n", i, ms->yyp_visits[i]);
+#endif
+}
+#endif
+#endif
+
+#if YY_TRACE
+unsigned long long MoonlimeLatencyPercentile( Moonlime_state *lexer,
+    double p )
+{
+    yyml_state *ms = lexer;
+    unsigned long long want, seen = 0, high;
+    int b, e, m;
+
+    if(ms == NULL || ms->yyt.n == 0)
+        return 0;
+
+    want = (unsigned long long) (p * ms->yyt.n + 0.5);
+    if(want < 1)
+        want = 1;
+
+    for(b = 0; b < YY_TRACE_BUCKETS; ++b) {
+        if((seen += ms->yyt.hist[b]) < want)
+            continue;
+
+        /* The longest wait that goes in bucket b (see yytrace_token) */
+        if(b < (2 << YY_TRACE_SUB_BITS))
+            high = b;
+        else {
+            e = (b >> YY_TRACE_SUB_BITS) - 1;
+            m = (b & ((1 << YY_TRACE_SUB_BITS) - 1)) + (1 << YY_TRACE_SUB_BITS);
+            high = ((m + 1ULL) << e) - 1;
+        }
+        return (high < ms->yyt.max) ? high : ms->yyt.max;
+    }
+
+    return ms->yyt.max;
+}
+
+void MoonlimeDumpLatency( Moonlime_state *lexer, FILE *f )
+{
+    yyml_state *ms = lexer;
+
+    if(ms == NULL)
+        return;
+
+    fprintf(f, "Moonlime token latency: %llu tokens; p50 %llu ns, "
+               "p99 %llu ns, p99.9 %llu ns, max %llu ns\n", ms->yyt.n,
+            MoonlimeLatencyPercentile(lexer, 0.5),
+            MoonlimeLatencyPercentile(lexer, 0.99),
+            MoonlimeLatencyPercentile(lexer, 0.999), ms->yyt.max);
+}
+#endif
+
+#if YY_KEYWORDS && !YY_MLT
+/* Must be kept in step with phash_fn() in Moonlime's phash.c */
+static unsigned long yykw_hash(int rule, const char *s, size_t len,
+                               unsigned long seed)
+{
+  unsigned long h = (2166136261UL + seed * 2654435761UL +
+                     (unsigned long) rule) & 0xffffffffUL;
+  size_t i;
+
+  for(i = 0; i < len; ++i)
+    h = ((h ^ (0xff & (unsigned long) s[i])) * 16777619UL) & 0xffffffffUL;
+
+  return h;
+}
+
+/* If the text matched by pattern done_num is one of its keywords, returns the
+ * number of the keyword's action; otherwise, returns done_num. */
+static int yykeyword(int done_num, const char *yytext, size_t yylen)
+{
+  unsigned long b;
+  int k;
+  size_t i;
+
+  if(!yy_kw_has[done_num])
+    return done_num;
+
+  b = yykw_hash(done_num, yytext, yylen, 0) % YY_KW_BUCKETS;
+  k = yy_kw_slots[yykw_hash(done_num, yytext, yylen, yy_kw_disp[b]) %
+                  YY_KW_SLOTS];
+
+  if(k < 0 || yy_kw_rules[k] != done_num || yy_kw_lens[k] != (int) yylen)
+    return done_num;
+
+  for(i = 0; i < yylen; ++i)
+    if(yy_kw_words[k][i] != yytext[i])
+      return done_num;
+
+  return YY_KW_FIRST_ACTION + k;
+}
+#endif
 
 #define YYSTART(x) do { *yy_start_state = YY_STATE_ ## x ; } while(0)
 
 static void yymoonlime_action(int done_num, const char *yytext, size_t yylen,
                               int *yy_start_state ,  lexer_lexer_state *  yydata)
 {
+    YY_ON_ACTION(done_num);
+
     switch(done_num) {
 case 1: {
  ; 
@@ -674,6 +1761,18 @@ case 2: {
         yydata->dir = D_USTATE_TYPE;
         YYSTART(PRE_C_CODE);
 
+    } else if(yylen == 7 && !strncmp(yytext, "%option", yylen)) {
+        yydata->dir = D_OPTION;
+        YYSTART(IN_OPTION);
+
+    } else if(yylen == 9 && !strncmp(yytext, "%keywords", yylen)) {
+        if(yydata->kw_pending != NULL) {
+            fputs("Two %keywords blocks without a pattern between them\n",
+                  stderr);
+            exit(1);
+        }
+        YYSTART(PRE_KEYWORDS);
+
     } else {
         fprintf(stderr, "Unknown directive %.*s!\n", (int) yylen, yytext);
         exit(1);
@@ -1023,30 +2122,24 @@ case 19: {
 case 20: {
 
     yydata->c_nest_depth = 1;
-
-    if(yydata->code != NULL)
-        free(yydata->code);
-    yydata->code = mk_blank_lstring(0);
-
     YYSTART(C_CODE);
 
 } break;
 case 21: {
 
-    len_string *x;
-
     ++yydata->c_nest_depth;
-    x = lstrcat_s(yydata->code, "{");
-    free(yydata->code);
-    yydata->code = x;
+    strbuf_add(&yydata->code, 1, "{");
 
 } break;
 case 22: {
 
-    len_string *x;
+    len_string *code;
     pat_entry_t *ent;
+    kw_entry_t *kw, *kp;
 
     if(--yydata->c_nest_depth == 0) {
+        code = strbuf_finish(&yydata->code);
+
         switch(yydata->dir) {
           case D_NONE:
             vfprintf(yydata->verb, "Pattern:\n");
@@ -1054,14 +2147,15 @@ case 22: {
                 print_regex_tree(yydata->verb, yydata->curr_rx);
             vfputs("Code associated with pattern: {\n");
             if(yydata->verb != NULL)
-                lstr_fwrite(yydata->code, yydata->verb);
+                lstr_fwrite(code, yydata->verb);
             vfputs("\n}\n");
 
             ent = malloc_or_die(1, pat_entry_t);
 
             ent->rx = yydata->curr_rx;
-            ent->code = yydata->code;
+            ent->code = code;
             ent->states = yydata->curr_st;
+            ent->keywords = yydata->kw_pending;
             ent->next = NULL;
 
             if(yydata->phead == NULL) {
@@ -1075,37 +2169,61 @@ case 22: {
 
             yydata->curr_rx = NULL;
             yydata->curr_st = NULL;
+            yydata->kw_pending = NULL;
 
             break;
 
+          case D_KEYWORD:
+            vfprintf(yydata->verb, "Keyword %.*s: {\n",
+                     (int) yydata->kw_word->len, yydata->kw_word->s);
+            if(yydata->verb != NULL)
+                lstr_fwrite(code, yydata->verb);
+            vfputs("\n}\n");
+
+            kw = malloc_or_die(1, kw_entry_t);
+            kw->word = yydata->kw_word;
+            kw->code = code;
+            kw->next = NULL;
+
+            if(yydata->kw_pending == NULL) {
+                yydata->kw_pending = kw;
+            } else {
+                for(kp = yydata->kw_pending; kp->next != NULL; kp = kp->next)
+                    ;
+                kp->next = kw;
+            }
+
+            yydata->kw_word = NULL;
+            break;
+
           case D_HEADER:
             vfputs("Header: {\n");
             if(yydata->verb != NULL)
-                lstr_fwrite(yydata->code, yydata->verb);
+                lstr_fwrite(code, yydata->verb);
             vfputs("\n}\n");
 
             if(yydata->header != NULL)
                 free(yydata->header);
-            yydata->header = yydata->code;
+            yydata->header = code;
             break;
 
           case D_TOP:
             vfputs("Top: {\n");
             if(yydata->verb != NULL)
-                lstr_fwrite(yydata->code, yydata->verb);
+                lstr_fwrite(code, yydata->verb);
             vfputs("\n}\n");
 
             if(yydata->top != NULL)
                 free(yydata->top);
-            yydata->top = yydata->code;
+            yydata->top = code;
             break;
 
           case D_USTATE_TYPE:
             vfprintf(yydata->verb, "User-state: {\n%.*s\n}\n",
-                     (int) yydata->code->len, yydata->code->s);
+                     (int) code->len, code->s);
             if(yydata->ustate_type != NULL)
                 free(yydata->ustate_type);
-            yydata->ustate_type = yydata->code;
+            yydata->ustate_type = code;
             break;
 
           default:
@@ -1114,21 +2232,20 @@ case 22: {
             exit(1);
         }
 
+        /* The code of a keyword is followed by more of its block */
+        if(yydata->dir == D_KEYWORD)
+            YYSTART(IN_KEYWORDS);
+        else
+            YYSTART(MAIN);
+
         yydata->dir = D_NONE;
-        yydata->code = NULL;
-        YYSTART(MAIN);
-    } else {
-        x = lstrcat_s(yydata->code, "}");
-        free(yydata->code);
-        yydata->code = x;
-    }
+    } else
+        strbuf_add(&yydata->code, 1, "}");
 
 } break;
 case 23: {
 
-    len_string *x = lstrcat_buf(yydata->code, yylen, yytext);
-    free(yydata->code);
-    yydata->code = x;
+    strbuf_add(&yydata->code, yylen, yytext);
 
 } break;
 case 24: {
@@ -1175,10 +2292,45 @@ case 25: {
  YYSTART(MAIN); 
 } break;
 case 26: {
- ; 
+ YYSTART(IN_KEYWORDS); 
 } break;
 case 27: {
 
+    kw_entry_t *kp;
+
+    for(kp = yydata->kw_pending; kp != NULL; kp = kp->next) {
+        if(kp->word->len == yylen && !memcmp(kp->word->s, yytext, yylen)) {
+            fprintf(stderr, "Keyword %.*s given twice\n", LEN, yytext);
+            exit(1);
+        }
+    }
+
+    yydata->kw_word = lstring_dupbuf(yylen, yytext);
+    yydata->dir = D_KEYWORD;
+    YYSTART(PRE_C_CODE);
+
+} break;
+case 28: {
+ YYSTART(MAIN); 
+} break;
+case 29: {
+
+    vfprintf(yydata->verb, "%%option directive: %.*s\n", LEN, yytext);
+
+    yydata->options = append_to_list(yytext, yylen, yydata->options);
+
+} break;
+case 30: {
+
+    yydata->dir = D_NONE;
+    YYSTART(MAIN);
+
+} break;
+case 31: {
+ ; 
+} break;
+case 32: {
+
 #ifdef LEXER_DBG
     vfprintf(yydata->verb, "Char \'%c\'\n", yytext[0]);
 #endif
@@ -26,13 +26,24 @@ typedef enum {
     D_STATE,
     D_INITSTATE,
     D_PREFIX,
-    D_USTATE_TYPE
+    D_USTATE_TYPE,
+    D_OPTION,
+    D_KEYWORD
 } directive_kind;
 
+/* A keyword of a pattern (see %keywords), and the code run in place of the
+ * pattern's when the pattern matches exactly the keyword */
+typedef struct kw_entry {
+    len_string *word;
+    len_string *code;
+    struct kw_entry *next;
+} kw_entry_t;
+
 struct pattern_entry {
     regex_t *rx;
     len_string *code;
     lstr_list_t *states;
+    kw_entry_t *keywords; /* The pattern's keywords, or NULL */
     struct pattern_entry *next;
 };
 
@@ -42,7 +53,7 @@ typedef struct {
     directive_kind dir;   /* Current type of directive being parsed */
     int c_nest_depth;     /* Current brace-nesting depth in C code */
     int regex_nest_depth; /* Current parenthesis-nesting depth in regex */
-    len_string *code;     /* The current chunk of C code */
+    strbuf_t code;        /* The current chunk of C code */
 
     regex_t *curr_rx; /* Current regular-expression fragment being worked on */
     regex_t *rx_stack; /* Stack of regular-expression fragments -- only
@@ -68,10 +79,22 @@ typedef struct {
 
     FILE *verb; /* An optional file to print verbose information */
     len_string *ustate_type; /* The type of the (optional) user state object */
+
+    lstr_list_t *options; /* The settings given by %option directives, in the
+                           * order they appear (e.g. "engine=glushkov") */
+
+    kw_entry_t *kw_pending; /* Keywords waiting for the next pattern */
+    len_string *kw_word;    /* The keyword whose code is being read */
 } lexer_lexer_state;
 
 void init_lexer_lexer_state(lexer_lexer_state *st);
 
+/* Frees everything st holds, including whatever was left half-parsed, and
+ * reinitializes it */
+void free_lexer_lexer_state(lexer_lexer_state *st);
+
+
+#include <stdlib.h>
 
 typedef struct yy_Moonlime_state Moonlime_state;
 
@@ -79,5 +102,15 @@ Moonlime_state * MoonlimeInit( void * (*alloc)(size_t),
     void (*unalloc)(void *) );
 void MoonlimeDestroy( Moonlime_state *lexer );
 int MoonlimeRead( Moonlime_state *lexer, char *input, size_t len ,  lexer_lexer_state *  data );
+#if 0 || YY_PROFILE
+#include <stdio.h>
+void MoonlimeDumpProfile( Moonlime_state *lexer, FILE *f );
+#endif
+#if YY_TRACE
+#include <stdio.h>
+unsigned long long MoonlimeLatencyPercentile( Moonlime_state *lexer,
+    double p );
+void MoonlimeDumpLatency( Moonlime_state *lexer, FILE *f );
+#endif
 
 #endif
@@ -0,0 +1,419 @@
+/*
+ * mltrt.c: A lexer runtime driven by DFA tables loaded from a .mlt file (as
+ * written by moonlime -b) instead of compiled into the lexer.
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#include "mltrt.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct mlt_tables {
+    void *map;
+    size_t size;
+    const uint32_t *h;           /* The header words */
+    const unsigned char *classes;
+    const int32_t *next;
+    const int32_t *done;
+    const int32_t *starts;
+    const uint32_t *names;
+    const uint32_t *kw_disp;
+    const int32_t *kw_slot;
+    const int32_t *kw_rules;
+    const uint32_t *kw_words;
+    const unsigned char *kw_has;
+    const char *strings;
+};
+
+struct mlt_lexer {
+    const mlt_tables *t;
+    mlt_action act;
+    void *data;
+    int is_in_error;
+    int curr_state;
+    int curr_start_state;
+    int last_done_num;
+    int last_done_len;
+    size_t string_len;
+    size_t curr_buf_size;
+    void * (*alloc)(size_t);
+    void (*unalloc)(void *);
+    char *buf;
+    char start_buf[64];
+};
+
+/* Returns where the table whose offset is header word off starts, if n
+ * elements of elsize bytes each fit in the file there; NULL otherwise */
+static const void * mlt_table(const mlt_tables *t, int off, uint32_t n,
+                              size_t elsize)
+{
+    unsigned long long start = t->h[off];
+
+    if(start % 4 != 0 || start > t->size ||
+       (unsigned long long) n * elsize > t->size - start)
+        return NULL;
+
+    return (const char *) t->map + start;
+}
+
+/* Are the n (offset, length) pairs in pairs all within the strings? */
+static int mlt_strings_ok(const mlt_tables *t, const uint32_t *pairs,
+                          uint32_t n)
+{
+    uint32_t i;
+
+    for(i = 0; i < n; ++i)
+        if(pairs[2*i] > t->h[MLT_H_N_STRINGS] ||
+           pairs[2*i + 1] > t->h[MLT_H_N_STRINGS] - pairs[2*i])
+            return 0;
+
+    return 1;
+}
+
+/* Checks that the tables are well-formed, so that a lexer running on them
+ * can't stray outside the file */
+static int mlt_check(mlt_tables *t)
+{
+    const uint32_t *h = t->h;
+    uint32_t n_states = h[MLT_H_N_STATES], n_classes = h[MLT_H_N_CLASSES];
+    uint32_t i;
+
+    if(h[MLT_H_ORDER] != MLT_ORDER || h[MLT_H_VERSION] != MLT_VERSION ||
+       h[MLT_H_SIZE] != t->size || n_states < 1 || n_classes < 1 ||
+       n_classes > 256 || n_states > INT32_MAX / n_classes ||
+       h[MLT_H_N_STARTS] < 1 || h[MLT_H_INIT_START] >= h[MLT_H_N_STARTS] ||
+       h[MLT_H_N_PATTERNS] > h[MLT_H_N_ACTIONS] ||
+       h[MLT_H_N_ACTIONS] - h[MLT_H_N_PATTERNS] != h[MLT_H_N_KEYWORDS] ||
+       h[MLT_H_N_ACTIONS] > INT32_MAX ||
+       (h[MLT_H_N_KEYWORDS] > 0 &&
+        (h[MLT_H_KW_BUCKETS] < 1 || h[MLT_H_KW_SLOTS] < 1)))
+        return 0;
+
+    if((t->classes = mlt_table(t, MLT_H_CLASSES_OFF, 256, 1)) == NULL ||
+       (t->next = mlt_table(t, MLT_H_NEXT_OFF, n_states * n_classes,
+                            4)) == NULL ||
+       (t->done = mlt_table(t, MLT_H_DONE_OFF, n_states, 4)) == NULL ||
+       (t->starts = mlt_table(t, MLT_H_STARTS_OFF, h[MLT_H_N_STARTS],
+                              4)) == NULL ||
+       (t->names = mlt_table(t, MLT_H_NAMES_OFF, 2 * h[MLT_H_N_STARTS],
+                             4)) == NULL ||
+       (t->kw_disp = mlt_table(t, MLT_H_KW_DISP_OFF, h[MLT_H_KW_BUCKETS],
+                               4)) == NULL ||
+       (t->kw_slot = mlt_table(t, MLT_H_KW_SLOT_OFF, h[MLT_H_KW_SLOTS],
+                               4)) == NULL ||
+       (t->kw_rules = mlt_table(t, MLT_H_KW_RULES_OFF, h[MLT_H_N_KEYWORDS],
+                                4)) == NULL ||
+       (t->kw_words = mlt_table(t, MLT_H_KW_WORDS_OFF,
+                                2 * h[MLT_H_N_KEYWORDS], 4)) == NULL ||
+       (t->kw_has = mlt_table(t, MLT_H_KW_HAS_OFF, h[MLT_H_N_PATTERNS] + 1,
+                              1)) == NULL ||
+       (t->strings = mlt_table(t, MLT_H_STRINGS_OFF, h[MLT_H_N_STRINGS],
+                               1)) == NULL)
+        return 0;
+
+    for(i = 0; i < 256; ++i)
+        if(t->classes[i] >= n_classes)
+            return 0;
+    for(i = 0; i < n_states * n_classes; ++i)
+        if(t->next[i] < -1 || t->next[i] >= (int32_t) n_states)
+            return 0;
+    for(i = 0; i < n_states; ++i)
+        if(t->done[i] < 0 || t->done[i] > (int32_t) h[MLT_H_N_PATTERNS])
+            return 0;
+    for(i = 0; i < h[MLT_H_N_STARTS]; ++i)
+        if(t->starts[i] < 0 || t->starts[i] >= (int32_t) n_states)
+            return 0;
+    for(i = 0; i < h[MLT_H_KW_SLOTS] && h[MLT_H_N_KEYWORDS] > 0; ++i)
+        if(t->kw_slot[i] < -1 ||
+           t->kw_slot[i] >= (int32_t) h[MLT_H_N_KEYWORDS])
+            return 0;
+
+    return mlt_strings_ok(t, t->names, h[MLT_H_N_STARTS]) &&
+           mlt_strings_ok(t, t->kw_words, h[MLT_H_N_KEYWORDS]);
+}
+
+mlt_tables * mlt_open(const char *path)
+{
+    mlt_tables *t;
+    struct stat st;
+    int fd;
+
+    if((fd = open(path, O_RDONLY)) < 0)
+        return NULL;
+
+    if(fstat(fd, &st) != 0 ||
+       st.st_size < (off_t) (8 + 4 * MLT_HEADER_WORDS) ||
+       (t = malloc(sizeof(mlt_tables))) == NULL) {
+        close(fd);
+        return NULL;
+    }
+
+    t->size = (size_t) st.st_size;
+    t->map = mmap(NULL, t->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(t->map == MAP_FAILED) {
+        free(t);
+        return NULL;
+    }
+
+    t->h = (const uint32_t *) ((const char *) t->map + 8);
+
+    if(memcmp(t->map, MLT_MAGIC, 8) || !mlt_check(t)) {
+        munmap(t->map, t->size);
+        free(t);
+        return NULL;
+    }
+
+    return t;
+}
+
+void mlt_close(mlt_tables *t)
+{
+    if(t == NULL)
+        return;
+
+    munmap(t->map, t->size);
+    free(t);
+}
+
+int mlt_n_actions(const mlt_tables *t)
+{
+    return (int) t->h[MLT_H_N_ACTIONS];
+}
+
+int mlt_n_starts(const mlt_tables *t)
+{
+    return (int) t->h[MLT_H_N_STARTS];
+}
+
+int mlt_start_state(const mlt_tables *t, const char *name)
+{
+    size_t len = strlen(name);
+    uint32_t i;
+
+    for(i = 0; i < t->h[MLT_H_N_STARTS]; ++i)
+        if(t->names[2*i + 1] == len &&
+           !memcmp(t->strings + t->names[2*i], name, len))
+            return (int) i;
+
+    return -1;
+}
+
+mlt_lexer * mlt_init(const mlt_tables *t, mlt_action act, void *data,
+                     void * (*alloc)(size_t), void (*unalloc)(void *))
+{
+    mlt_lexer *lx;
+
+    if(t == NULL || act == NULL || alloc == NULL || unalloc == NULL ||
+       (lx = alloc(sizeof(mlt_lexer))) == NULL)
+        return NULL;
+
+    lx->t = t;
+    lx->act = act;
+    lx->data = data;
+    lx->alloc = alloc;
+    lx->unalloc = unalloc;
+
+    lx->is_in_error = 0;
+    lx->curr_start_state = (int) t->h[MLT_H_INIT_START];
+    lx->curr_state = t->starts[lx->curr_start_state];
+    lx->last_done_num = 0;
+    lx->last_done_len = 0;
+
+    lx->string_len = 0;
+    lx->curr_buf_size = sizeof(lx->start_buf);
+    lx->buf = lx->start_buf;
+
+    return lx;
+}
+
+void mlt_destroy(mlt_lexer *lx)
+{
+    if(lx == NULL)
+        return;
+
+    if(lx->buf != lx->start_buf)
+        lx->unalloc(lx->buf);
+
+    lx->unalloc(lx);
+}
+
+/* Must be kept in step with phash_fn() in Moonlime's phash.c */
+static uint32_t mlt_kw_hash(int rule, const char *s, size_t len,
+                            uint32_t seed)
+{
+    uint32_t h = 2166136261UL + seed * 2654435761UL + (uint32_t) rule;
+    size_t i;
+
+    for(i = 0; i < len; ++i)
+        h = (h ^ (unsigned char) s[i]) * 16777619UL;
+
+    return h;
+}
+
+/* If the text matched by pattern done_num is one of its keywords, returns the
+ * number of the keyword's action; otherwise, returns done_num. */
+static int mlt_keyword(const mlt_tables *t, int done_num, const char *yytext,
+                       size_t yylen)
+{
+    uint32_t b;
+    int32_t k;
+
+    if(!t->kw_has[done_num])
+        return done_num;
+
+    b = mlt_kw_hash(done_num, yytext, yylen, 0) % t->h[MLT_H_KW_BUCKETS];
+    k = t->kw_slot[mlt_kw_hash(done_num, yytext, yylen, t->kw_disp[b]) %
+                   t->h[MLT_H_KW_SLOTS]];
+
+    if(k < 0 || t->kw_rules[k] != done_num || t->kw_words[2*k + 1] != yylen ||
+       memcmp(t->strings + t->kw_words[2*k], yytext, yylen))
+        return done_num;
+
+    return (int) t->h[MLT_H_N_PATTERNS] + 1 + k;
+}
+
+static void mlt_action_run(mlt_lexer *lx)
+{
+    const mlt_tables *t = lx->t;
+    int rule = lx->last_done_num;
+
+    if(t->h[MLT_H_N_KEYWORDS] > 0)
+        rule = mlt_keyword(t, rule, lx->buf, lx->last_done_len);
+
+    lx->act(rule, lx->buf, lx->last_done_len, &lx->curr_start_state,
+            lx->data);
+
+    if(lx->curr_start_state < 0 ||
+       lx->curr_start_state >= (int) t->h[MLT_H_N_STARTS])
+        lx->curr_start_state = (int) t->h[MLT_H_INIT_START];
+}
+
+static int mlt_run_char(mlt_lexer *lx, char c, int add_to_buf, int len)
+{
+    const mlt_tables *t = lx->t;
+    char *new_buf;
+    int32_t next;
+
+    if(add_to_buf) {
+        if(lx->string_len >= lx->curr_buf_size - 1) {
+            if((new_buf = lx->alloc(lx->curr_buf_size * 2)) == NULL) {
+                lx->is_in_error = 1;
+                return 0;
+            }
+            memcpy(new_buf, lx->buf, lx->string_len);
+            lx->curr_buf_size *= 2;
+            if(lx->buf != lx->start_buf)
+                lx->unalloc(lx->buf);
+            lx->buf = new_buf;
+        }
+        lx->buf[lx->string_len++] = c;
+    }
+
+    next = t->next[(size_t) lx->curr_state * t->h[MLT_H_N_CLASSES] +
+                   t->classes[(unsigned char) c]];
+    if(next < 0)
+        return 0;
+
+    lx->curr_state = next;
+    if(t->done[next]) {
+        lx->last_done_num = t->done[next];
+        lx->last_done_len = len;
+    }
+    return 1;
+}
+
+static void mlt_reset_state(mlt_lexer *lx)
+{
+    memmove(lx->buf, lx->buf + lx->last_done_len,
+            lx->string_len - lx->last_done_len);
+    lx->string_len -= lx->last_done_len;
+    lx->last_done_len = lx->last_done_num = 0;
+    lx->curr_state = lx->t->starts[lx->curr_start_state];
+}
+
+int mlt_read(mlt_lexer *lx, const char *input, size_t len)
+{
+    int done_relexing, i;
+    const char *end = input + len;
+
+    if(lx == NULL || lx->is_in_error)
+        return 0;
+
+    if(len == 0) { /* Signifies EOF */
+        if(lx->string_len == 0)
+            return 1;
+
+        if(lx->last_done_num == 0) {
+            lx->is_in_error = 1;
+            return 0;
+        }
+
+        mlt_action_run(lx);
+        mlt_reset_state(lx);
+
+        while(lx->string_len > 0) {
+            for(i = 0; i < lx->string_len; ++i) {
+                if(!mlt_run_char(lx, lx->buf[i], 0, i+1) ||
+                   i == lx->string_len - 1) {
+                    if(lx->is_in_error || lx->last_done_num == 0) {
+                        lx->is_in_error = 1;
+                        return 0;
+                    }
+
+                    mlt_action_run(lx);
+                    mlt_reset_state(lx);
+                    break;
+                }
+            }
+        }
+
+        return 1;
+    }
+
+    while(input < end) {
+        if(!mlt_run_char(lx, *input, 1, lx->string_len + 1)) {
+            if(lx->is_in_error)
+                return 0;
+            if(lx->last_done_num == 0) { /* no pattern matches buf */
+                lx->is_in_error = 1;
+                return 0;
+            }
+            mlt_action_run(lx);
+            mlt_reset_state(lx);
+
+            /* Re-lex remaining part of the buffer */
+            done_relexing = 0;
+            while(lx->string_len > 0 && !done_relexing) {
+                i = 0;
+                while(i < lx->string_len) {
+                    if(!mlt_run_char(lx, lx->buf[i], 0, i+1)) {
+                        if(!lx->is_in_error && lx->last_done_num == 0)
+                            lx->is_in_error = 1;
+                        if(lx->is_in_error)
+                            return 0;
+
+                        mlt_action_run(lx);
+                        mlt_reset_state(lx);
+                        i = 0;
+                        continue;
+                    }
+                    ++i;
+                }
+
+                if(i == lx->string_len)
+                    done_relexing = 1;
+            }
+        }
+        ++input;
+    }
+
+    return 1;
+}
@@ -0,0 +1,108 @@
+/*
+ * mltrt.h: A lexer runtime driven by DFA tables loaded from a .mlt file (as
+ * written by moonlime -b) instead of compiled into the lexer.
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#ifndef MLT_RT_H
+#define MLT_RT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * The layout of a .mlt file. It starts with the 8 bytes of MLT_MAGIC, then
+ * MLT_HEADER_WORDS 32-bit words, indexed by the MLT_H_* values below; the
+ * MLT_H_*_OFF words give the offset (from the start of the file) of each of
+ * the tables, all of which are 4-byte aligned. The file holds no pointers, so
+ * it can be mapped anywhere; the words are in the byte order of the machine
+ * that wrote it, which MLT_H_ORDER (MLT_ORDER as written) tells.
+ *
+ *   classes  256 bytes: the character class of each byte
+ *   next     n_states * n_classes int32s: the state each state goes to on
+ *            each class, or -1 if none
+ *   done     n_states int32s: the pattern each state accepts, or 0
+ *   starts   n_starts int32s: the initial state of each start state
+ *   names    n_starts pairs (offset in strings, length) of start-state names
+ *   kw_disp, kw_slot, kw_rules, kw_words (pairs as for names), kw_has
+ *            (n_patterns + 1 bytes, indexed by pattern number): the perfect
+ *            hash of a lexer's %keywords, as in the generated C lexer
+ *   strings  the bytes the names and keywords point into
+ */
+#define MLT_MAGIC "MLTABLE\n"
+#define MLT_ORDER 0x01020304UL
+#define MLT_VERSION 1
+
+enum {
+    MLT_H_ORDER,
+    MLT_H_VERSION,
+    MLT_H_SIZE,        /* Size of the whole file in bytes */
+    MLT_H_N_STATES,
+    MLT_H_N_CLASSES,
+    MLT_H_N_STARTS,
+    MLT_H_INIT_START,  /* The start state a lexer begins in */
+    MLT_H_N_PATTERNS,
+    MLT_H_N_ACTIONS,   /* Patterns and keywords */
+    MLT_H_N_KEYWORDS,
+    MLT_H_KW_BUCKETS,
+    MLT_H_KW_SLOTS,
+    MLT_H_N_STRINGS,   /* Bytes in strings */
+    MLT_H_CLASSES_OFF,
+    MLT_H_NEXT_OFF,
+    MLT_H_DONE_OFF,
+    MLT_H_STARTS_OFF,
+    MLT_H_NAMES_OFF,
+    MLT_H_KW_DISP_OFF,
+    MLT_H_KW_SLOT_OFF,
+    MLT_H_KW_RULES_OFF,
+    MLT_H_KW_WORDS_OFF,
+    MLT_H_KW_HAS_OFF,
+    MLT_H_STRINGS_OFF,
+    MLT_HEADER_WORDS
+};
+
+/* A mapped .mlt file; any number of lexers may share one */
+typedef struct mlt_tables mlt_tables;
+
+/* A lexer running on a mlt_tables */
+typedef struct mlt_lexer mlt_lexer;
+
+/*
+ * The code of the lexer: called with the number of the pattern (or keyword)
+ * that matched yytext, numbered as the cases of the generated C lexer's
+ * actions are, and the data given to mlt_init. *start_state may be set to the
+ * index of the start state to go on in (see mlt_start_state); an index out of
+ * range sends the lexer back to its initial start state.
+ */
+typedef void (*mlt_action)(int rule, const char *yytext, size_t yylen,
+                           int *start_state, void *data);
+
+/* Maps the tables in the file path, checking that they're well-formed;
+ * returns NULL if they can't be read or aren't. */
+mlt_tables * mlt_open(const char *path);
+
+void mlt_close(mlt_tables *t);
+
+/* Returns the number of patterns and keywords, the largest rule an action
+ * can be called with */
+int mlt_n_actions(const mlt_tables *t);
+
+/* Returns the number of start states */
+int mlt_n_starts(const mlt_tables *t);
+
+/* Returns the index of the start state named name, or -1 if there is none */
+int mlt_start_state(const mlt_tables *t, const char *name);
+
+/* Makes a lexer running on t, which must outlive it, and calling act with
+ * data; returns NULL if memory from alloc runs out. */
+mlt_lexer * mlt_init(const mlt_tables *t, mlt_action act, void *data,
+                     void * (*alloc)(size_t), void (*unalloc)(void *));
+
+void mlt_destroy(mlt_lexer *lx);
+
+/* Lexes the len bytes of input (len 0 meaning the end of the input), as
+ * the generated lexers' Read functions do; returns 0 on a lexing error. */
+int mlt_read(mlt_lexer *lx, const char *input, size_t len);
+
+#endif
@@ -0,0 +1,200 @@
+/*
+ * mltwrite.c: Writing a lexer's DFA tables as a .mlt file (see mltrt.h).
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#include "mltwrite.h"
+
+#ifndef ML_STDIO_H
+#define ML_STDIO_H
+#include <stdio.h>
+#endif
+
+#ifndef ML_STDLIB_H
+#define ML_STDLIB_H
+#include <stdlib.h>
+#endif
+
+#ifndef ML_STRING_H
+#define ML_STRING_H
+#include <string.h>
+#endif
+
+#ifndef ML_UTILS_H
+#include "utils.h"
+#endif
+
+#ifndef ML_PHASH_H
+#include "phash.h"
+#endif
+
+#ifndef MLT_RT_H
+#include "mltrt.h"
+#endif
+
+/* Sets header word off to where a table of n bytes goes (at *pos, rounded up
+ * to a multiple of 4), and moves *pos past it */
+static void place_table(uint32_t *h, int off, size_t n, size_t *pos)
+{
+    *pos = (*pos + 3) & ~(size_t) 3;
+    h[off] = (uint32_t) *pos;
+    *pos += n;
+}
+
+#define table_at(mem, h, off, type) ((type *) ((mem) + (h)[off]))
+
+size_t write_mlt(const char *name, const fa_t *dfa,
+                 const fa_list_t *patterns, const fa_list_t *start_states,
+                 const lexer_lexer_state *st)
+{
+    uint32_t h[MLT_HEADER_WORDS], *names, *kw_words, *kw_disp;
+    int32_t *next, *done, *starts, *kw_slot, *kw_rules;
+    unsigned char *classes, *kw_has;
+    int map[256], n_classes, n_starts = 0, n_pats = 0, n_kw = 0, i, c;
+    int *rules = NULL, *dense;
+    len_string **words = NULL, *sname;
+    const pat_entry_t *p;
+    const kw_entry_t *kw;
+    const fa_list_t *l;
+    const state_t *s;
+    phash_t *ph = NULL;
+    size_t pos, n_strings = 0;
+    char *mem, *strings;
+    FILE *f;
+    int ok;
+
+    n_classes = fa_byte_classes(dfa, map);
+
+    for(l = start_states; l != NULL; l = l->next) {
+        ++n_starts;
+        n_strings += ((len_string *) l->data1)->len;
+    }
+
+    for(p = st->phead; p != NULL; p = p->next) {
+        ++n_pats;
+        for(kw = p->keywords; kw != NULL; kw = kw->next) {
+            ++n_kw;
+            n_strings += kw->word->len;
+        }
+    }
+
+    if(n_kw > 0) {
+        rules = malloc_or_die(n_kw, int);
+        words = malloc_or_die(n_kw, len_string *);
+        for(i = 0, p = st->phead, l = patterns; p != NULL;
+            p = p->next, l = l->next) {
+            for(kw = p->keywords; kw != NULL; kw = kw->next) {
+                rules[i] = l->done_num;
+                words[i++] = kw->word;
+            }
+        }
+        ph = mk_phash(n_kw, rules, words);
+    }
+
+    memset(h, 0, sizeof(h));
+    h[MLT_H_ORDER] = MLT_ORDER;
+    h[MLT_H_VERSION] = MLT_VERSION;
+    h[MLT_H_N_STATES] = dfa->n_states;
+    h[MLT_H_N_CLASSES] = n_classes;
+    h[MLT_H_N_STARTS] = n_starts;
+    h[MLT_H_N_PATTERNS] = n_pats;
+    h[MLT_H_N_ACTIONS] = n_pats + n_kw;
+    h[MLT_H_N_KEYWORDS] = n_kw;
+    h[MLT_H_KW_BUCKETS] = (ph != NULL) ? ph->n_buckets : 0;
+    h[MLT_H_KW_SLOTS] = (ph != NULL) ? ph->n_slots : 0;
+    h[MLT_H_N_STRINGS] = n_strings;
+
+    for(i = 0, l = start_states; l != NULL; l = l->next, ++i)
+        if(lstr_eq((len_string *) l->data1, st->initstate))
+            h[MLT_H_INIT_START] = i;
+
+    pos = 8 + sizeof(h);
+    place_table(h, MLT_H_CLASSES_OFF, 256, &pos);
+    place_table(h, MLT_H_NEXT_OFF,
+                (size_t) dfa->n_states * n_classes * sizeof(int32_t), &pos);
+    place_table(h, MLT_H_DONE_OFF, dfa->n_states * sizeof(int32_t), &pos);
+    place_table(h, MLT_H_STARTS_OFF, n_starts * sizeof(int32_t), &pos);
+    place_table(h, MLT_H_NAMES_OFF, 2 * n_starts * sizeof(uint32_t), &pos);
+    place_table(h, MLT_H_KW_DISP_OFF, h[MLT_H_KW_BUCKETS] * sizeof(uint32_t),
+                &pos);
+    place_table(h, MLT_H_KW_SLOT_OFF, h[MLT_H_KW_SLOTS] * sizeof(int32_t),
+                &pos);
+    place_table(h, MLT_H_KW_RULES_OFF, n_kw * sizeof(int32_t), &pos);
+    place_table(h, MLT_H_KW_WORDS_OFF, 2 * n_kw * sizeof(uint32_t), &pos);
+    place_table(h, MLT_H_KW_HAS_OFF, n_pats + 1, &pos);
+    place_table(h, MLT_H_STRINGS_OFF, n_strings, &pos);
+    pos = (pos + 3) & ~(size_t) 3;
+    h[MLT_H_SIZE] = pos;
+
+    mem = malloc_or_die(pos, char);
+    memset(mem, 0, pos);
+    memcpy(mem, MLT_MAGIC, 8);
+    memcpy(mem + 8, h, sizeof(h));
+
+    classes = table_at(mem, h, MLT_H_CLASSES_OFF, unsigned char);
+    for(c = 0; c < 256; ++c)
+        classes[c] = map[c];
+
+    dense = malloc_or_die(dfa->n_states * n_classes, int);
+    fa_dense_trans(dfa, map, n_classes, dense);
+    next = table_at(mem, h, MLT_H_NEXT_OFF, int32_t);
+    for(i = 0; i < dfa->n_states * n_classes; ++i)
+        next[i] = dense[i];
+    free(dense);
+
+    done = table_at(mem, h, MLT_H_DONE_OFF, int32_t);
+    for(s = dfa->first; s != NULL; s = s->next)
+        done[s->id] = s->done_num;
+
+    strings = table_at(mem, h, MLT_H_STRINGS_OFF, char);
+    n_strings = 0;
+
+    starts = table_at(mem, h, MLT_H_STARTS_OFF, int32_t);
+    names = table_at(mem, h, MLT_H_NAMES_OFF, uint32_t);
+    for(i = 0, l = start_states; l != NULL; l = l->next, ++i) {
+        sname = (len_string *) l->data1;
+        starts[i] = l->state->id;
+        names[2*i] = n_strings;
+        names[2*i + 1] = sname->len;
+        memcpy(strings + n_strings, sname->s, sname->len);
+        n_strings += sname->len;
+    }
+
+    kw_disp = table_at(mem, h, MLT_H_KW_DISP_OFF, uint32_t);
+    kw_slot = table_at(mem, h, MLT_H_KW_SLOT_OFF, int32_t);
+    kw_rules = table_at(mem, h, MLT_H_KW_RULES_OFF, int32_t);
+    kw_words = table_at(mem, h, MLT_H_KW_WORDS_OFF, uint32_t);
+    kw_has = table_at(mem, h, MLT_H_KW_HAS_OFF, unsigned char);
+    for(i = 0; ph != NULL && i < ph->n_buckets; ++i)
+        kw_disp[i] = ph->disp[i];
+    for(i = 0; ph != NULL && i < ph->n_slots; ++i)
+        kw_slot[i] = ph->slot[i];
+    for(i = 0; i < n_kw; ++i) {
+        kw_rules[i] = rules[i];
+        kw_words[2*i] = n_strings;
+        kw_words[2*i + 1] = words[i]->len;
+        memcpy(strings + n_strings, words[i]->s, words[i]->len);
+        n_strings += words[i]->len;
+    }
+    for(i = 1, p = st->phead; p != NULL; p = p->next, ++i)
+        kw_has[i] = (p->keywords != NULL);
+
+    if((f = fopen(name, "wb")) == NULL) {
+        fprintf(stderr, "Can\'t open %s for writing\n", name);
+        ok = 0;
+    } else {
+        ok = (fwrite(mem, 1, pos, f) == pos);
+        if(fclose(f) != 0)
+            ok = 0;
+        if(!ok)
+            fprintf(stderr, "Error writing %s\n", name);
+    }
+
+    if(ph != NULL)
+        destroy_phash(ph);
+    free(rules);
+    free(words);
+    free(mem);
+    return ok ? pos : 0;
+}
@@ -0,0 +1,29 @@
+/*
+ * mltwrite.h: Writing a lexer's DFA tables as a .mlt file (see mltrt.h).
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#ifndef ML_MLTWRITE_H
+#define ML_MLTWRITE_H
+
+#ifndef ML_FA_H
+#include "fa.h"
+#endif
+
+#ifndef ML_ML_LEXER_H
+#include "mllexgen.h"
+#endif
+
+/*
+ * Writes the tables of the lexer specified by st to the file name: the DFA
+ * dfa, whose start states (data1 a len_string * name, in the order they're
+ * numbered in) are start_states, and the keywords of st's patterns, which are
+ * patterns (as given to the DFA builders, done_num the pattern number).
+ * Returns the size of the file; on failure, says why on stderr and returns 0.
+ */
+size_t write_mlt(const char *name, const fa_t *dfa,
+                 const fa_list_t *patterns, const fa_list_t *start_states,
+                 const lexer_lexer_state *st);
+
+#endif
@@ -0,0 +1,197 @@
+/*
+ * phash.c: Perfect hashing of keyword tables.
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#include "phash.h"
+
+#ifndef ML_STDLIB_H
+#define ML_STDLIB_H
+#include <stdlib.h>
+#endif
+
+#ifndef ML_STDIO_H
+#define ML_STDIO_H
+#include <stdio.h>
+#endif
+
+#ifndef ML_STRING_H
+#define ML_STRING_H
+#include <string.h>
+#endif
+
+/* How many displacements to try for a bucket before giving up and starting
+ * over with more slots */
+#define MAX_DISP 100000
+
+/* How many times to start over before giving up altogether; each try has a
+ * quarter more slots than the one before */
+#define MAX_TRIES 40
+
+unsigned long phash_fn(int rule, const char *s, size_t len,
+                       unsigned long seed)
+{
+    unsigned long h = (2166136261UL + seed * 2654435761UL +
+                       (unsigned long) rule) & 0xffffffffUL;
+    size_t i;
+
+    for(i = 0; i < len; ++i)
+        h = ((h ^ (0xff & (unsigned long) s[i])) * 16777619UL) & 0xffffffffUL;
+
+    return h;
+}
+
+/* Tries to place every key with n_slots slots; returns 1 on success */
+static int place_keys(phash_t *ph, const int *rules,
+                      len_string * const *words, const int *order,
+                      const int *bucket_of, int *scratch)
+{
+    int b, i, j, k, n_in, ok;
+    unsigned long d;
+
+    for(i = 0; i < ph->n_slots; ++i)
+        ph->slot[i] = -1;
+
+    /* Buckets are handled biggest first (order lists the keys by bucket,
+     * biggest buckets first) */
+    for(i = 0; i < ph->n_keys; i += n_in) {
+        b = bucket_of[order[i]];
+        for(n_in = 1; i + n_in < ph->n_keys &&
+            bucket_of[order[i + n_in]] == b; ++n_in)
+            ;
+
+        for(d = 1; d <= MAX_DISP; ++d) {
+            ok = 1;
+            for(j = 0; j < n_in && ok; ++j) {
+                k = order[i + j];
+                scratch[j] = phash_fn(rules[k], words[k]->s, words[k]->len,
+                                      d) % ph->n_slots;
+                if(ph->slot[scratch[j]] != -1)
+                    ok = 0;
+                for(k = 0; k < j && ok; ++k)
+                    if(scratch[k] == scratch[j])
+                        ok = 0;
+            }
+
+            if(ok)
+                break;
+        }
+
+        if(d > MAX_DISP)
+            return 0;
+
+        ph->disp[b] = d;
+        for(j = 0; j < n_in; ++j)
+            ph->slot[scratch[j]] = order[i + j];
+    }
+
+    return 1;
+}
+
+/* A key, as sorted by bucket: the comparison needs nothing outside it, so
+ * tables can be built on several threads at once (see --batch) */
+typedef struct {
+    int key, bucket, bucket_size;
+} bucket_key_t;
+
+/* Sorts the keys by bucket, biggest buckets first */
+static int bucket_cmp(const void *a, const void *b)
+{
+    const bucket_key_t *x = a, *y = b;
+
+    if(x->bucket_size != y->bucket_size)
+        return y->bucket_size - x->bucket_size;
+    if(x->bucket != y->bucket)
+        return x->bucket - y->bucket;
+    return x->key - y->key;
+}
+
+phash_t * mk_phash(int n, const int *rules, len_string * const *words)
+{
+    phash_t *ph = malloc_or_die(1, phash_t);
+    int *bucket_of = malloc_or_die(n + 1, int);
+    int *order = malloc_or_die(n + 1, int);
+    int *scratch = malloc_or_die(n + 1, int);
+    int *bucket_size;
+    bucket_key_t *sorted;
+    int i, j, a, b, tries;
+
+    ph->n_keys = n;
+    ph->n_buckets = n / 2 + 1;
+    ph->n_slots = n + n / 4 + 1;
+    ph->disp = malloc_or_die(ph->n_buckets, unsigned long);
+    bucket_size = malloc_or_die(ph->n_buckets, int);
+
+    for(i = 0; i < ph->n_buckets; ++i) {
+        ph->disp[i] = 0;
+        bucket_size[i] = 0;
+    }
+
+    for(i = 0; i < n; ++i) {
+        bucket_of[i] = phash_fn(rules[i], words[i]->s, words[i]->len, 0) %
+                       ph->n_buckets;
+        ++bucket_size[bucket_of[i]];
+    }
+
+    sorted = malloc_or_die(n + 1, bucket_key_t);
+    for(i = 0; i < n; ++i) {
+        sorted[i].key = i;
+        sorted[i].bucket = bucket_of[i];
+        sorted[i].bucket_size = bucket_size[bucket_of[i]];
+    }
+
+    qsort(sorted, n, sizeof(bucket_key_t), bucket_cmp);
+    for(i = 0; i < n; ++i)
+        order[i] = sorted[i].key;
+    free(sorted);
+
+    /* Two keys the same would never be given different slots; as they'd be
+     * in the same bucket, it's enough to compare the keys within each */
+    for(i = 0; i < n; ++i) {
+        for(j = i + 1; j < n && bucket_of[order[j]] == bucket_of[order[i]];
+            ++j) {
+            a = order[i];
+            b = order[j];
+            if(rules[a] == rules[b] && words[a]->len == words[b]->len &&
+               !memcmp(words[a]->s, words[b]->s, words[a]->len)) {
+                fprintf(stderr, __FILE__ ":%d: keyword %.*s of pattern %d "
+                        "appears twice\n", __LINE__, (int) words[a]->len,
+                        words[a]->s, rules[a]);
+                exit(1);
+            }
+        }
+    }
+
+    ph->slot = NULL;
+    for(tries = 0; ; ++tries) {
+        if(tries == MAX_TRIES) {
+            fprintf(stderr, __FILE__ ":%d: no perfect hash found for %d "
+                    "keywords\n", __LINE__, n);
+            exit(1);
+        }
+
+        free(ph->slot);
+        ph->slot = malloc_or_die(ph->n_slots, int);
+        if(place_keys(ph, rules, words, order, bucket_of, scratch))
+            break;
+        ph->n_slots += ph->n_slots / 4 + 1;
+    }
+
+    free(bucket_of);
+    free(order);
+    free(scratch);
+    free(bucket_size);
+
+    return ph;
+}
+
+void destroy_phash(phash_t *ph)
+{
+    if(ph == NULL)
+        return;
+
+    free(ph->disp);
+    free(ph->slot);
+    free(ph);
+}
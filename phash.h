@@ -0,0 +1,43 @@
+/*
+ * phash.h: Perfect hashing of keyword tables.
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#ifndef ML_PHASH_H
+#define ML_PHASH_H
+
+#ifndef ML_UTILS_H
+#include "utils.h"
+#endif
+
+/*
+ * A perfect hash for a set of keys, each a word together with the number of
+ * the pattern the word is a keyword of, built by "hash and displace": a key
+ * goes in bucket phash_fn(key, 0) % n_buckets, and then in slot
+ * phash_fn(key, disp[bucket]) % n_slots, where the displacements disp are
+ * chosen so that no two keys share a slot.
+ */
+typedef struct {
+    int n_keys;
+    int n_buckets;
+    int n_slots;
+    unsigned long *disp; /* The displacement of each bucket */
+    int *slot;           /* The key in each slot, or -1 */
+} phash_t;
+
+/*
+ * The hash function: 32-bit FNV-1a over the len bytes of s, started from a
+ * value mixing in the pattern number rule and seed. The generated lexer
+ * carries an identical copy (see tmpl.c), so the two must be kept in step.
+ */
+unsigned long phash_fn(int rule, const char *s, size_t len,
+                       unsigned long seed);
+
+/* Builds a perfect hash for the n keys (rules[i], words[i]), which must be
+ * distinct; it's a fatal error if they aren't, or no hash can be found */
+phash_t * mk_phash(int n, const int *rules, len_string * const *words);
+
+void destroy_phash(phash_t *ph);
+
+#endif
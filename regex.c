@@ -15,6 +15,11 @@
 #include <stdio.h>
 #endif
 
+#ifndef ML_STRING_H
+#define ML_STRING_H
+#include <string.h>
+#endif
+
 static regex_t * alloc_regex(size_t array_sz, const char *fname, int line)
 {
     regex_t *ptr, **init_array;
@@ -222,6 +227,37 @@ regex_t * mk_paren_rx_impl(const char *fname, int line)
     return rx;
 }
 
+void regex_leaf_set(const regex_t *rx, unsigned int *cond)
+{
+    int i;
+
+    for(i = 0; i < CLASS_SZ; ++i)
+        cond[i] = 0;
+
+    switch(rx->type) {
+      case R_CHAR:
+        i = rx->data.c;
+        cond[i / ML_UINT_BIT] = 1 << (i % ML_UINT_BIT);
+        break;
+
+      case R_CLASS:
+        for(i = 0; i < CLASS_SZ; ++i)
+            cond[i] = rx->data.cls.is_inverted ? ~rx->data.cls.set[i]
+                                               : rx->data.cls.set[i];
+        break;
+
+      case R_ANY:
+        for(i = 0; i < CLASS_SZ; ++i)
+            cond[i] = ~0;
+        break;
+
+      default:
+        fprintf(stderr, __FILE__ ":%d: regex type %d isn\'t a leaf!\n",
+                __LINE__, rx->type);
+        exit(1);
+    }
+}
+
 void free_regex_tree_impl(regex_t *rx, const char *fname, int line)
 {
     size_t i;
@@ -334,3 +370,324 @@ void print_regex_tree(FILE *f, regex_t *rx)
 {
     print_regex_tree_int(f, rx, 0);
 }
+
+/* Prints c as it would be written in a pattern */
+static void print_pattern_char(FILE *f, int c, const char *special)
+{
+    if(c != '\0' && strchr(special, c) != NULL)
+        fprintf(f, "\\%c", c);
+    else if(c == '\n')
+        fputs("\\n", f);
+    else if(c < 0x20 || c >= 0x7f)
+        fprintf(f, "\\x%02x", 0xff & c);
+    else
+        fputc(c, f);
+}
+
+/* Prints rx, parenthesized if it's a concatenation, as the operand of a
+ * repetition */
+static void print_regex_operand(FILE *f, const regex_t *rx)
+{
+    int paren = rx != NULL && rx->type == R_CONCAT && rx->data.list.n_enc > 1;
+
+    if(paren)
+        fputc('(', f);
+    print_regex(f, rx);
+    if(paren)
+        fputc(')', f);
+}
+
+void print_regex(FILE *f, const regex_t *rx)
+{
+    size_t i;
+    int c, end;
+
+    if(rx == NULL)
+        return;
+
+    switch(rx->type) {
+      case R_CHAR:
+        print_pattern_char(f, rx->data.c, "\\.[]()|*+?{}");
+        break;
+
+      case R_CLASS:
+        fputs(rx->data.cls.is_inverted ? "[^" : "[", f);
+        for(c = 0; c < 256; ++c) {
+            if(!(rx->data.cls.set[c / ML_UINT_BIT] & (1 << (c % ML_UINT_BIT))))
+                continue;
+
+            /* Runs of 4 or more characters are abbreviated */
+            for(end = c; end + 1 < 256 &&
+                (rx->data.cls.set[(end + 1) / ML_UINT_BIT] &
+                 (1 << ((end + 1) % ML_UINT_BIT))); ++end)
+                ;
+            print_pattern_char(f, c, "\\[]^-");
+            if(end - c >= 3) {
+                fputc('-', f);
+                print_pattern_char(f, end, "\\[]^-");
+                c = end;
+            }
+        }
+        fputc(']', f);
+        break;
+
+      case R_ANY:
+        fputc('.', f);
+        break;
+
+      case R_OPTION:
+      case R_CONCAT:
+        if(rx->type == R_OPTION)
+            fputc('(', f);
+        for(i = 0; i < rx->data.list.n_enc; ++i) {
+            if(i > 0 && rx->type == R_OPTION)
+                fputc('|', f);
+            print_regex(f, rx->data.list.enc[i]);
+        }
+        if(rx->type == R_OPTION)
+            fputc(')', f);
+        break;
+
+      case R_MAYBE:
+      case R_STAR:
+      case R_PLUS:
+        print_regex_operand(f, rx->data.enc);
+        fputc((rx->type == R_MAYBE) ? '?' : (rx->type == R_STAR) ? '*' : '+',
+              f);
+        break;
+
+      case R_NUM:
+        print_regex_operand(f, rx->data.num.enc);
+        fputc('{', f);
+        if(rx->data.num.min >= 0)
+            fprintf(f, "%d", rx->data.num.min);
+        if(rx->data.num.max != rx->data.num.min) {
+            fputc(',', f);
+            if(rx->data.num.max >= 0)
+                fprintf(f, "%d", rx->data.num.max);
+        }
+        fputc('}', f);
+        break;
+
+      case R_ZERO:
+        fputs("()", f);
+        break;
+
+      case R_PAREN:
+        break;
+    }
+}
+
+/* Frees rx itself, but not the regexes it encloses */
+static void free_regex_node(regex_t *rx)
+{
+    if(rx->type == R_OPTION || rx->type == R_CONCAT)
+        free(rx->data.list.enc);
+    free(rx);
+}
+
+static int is_leaf(const regex_t *rx)
+{
+    return rx->type == R_CHAR || rx->type == R_CLASS || rx->type == R_ANY;
+}
+
+/* Simplifies the enclosed regexes of the option or concatenation rx, splicing
+ * in the lists of enclosed regexes of the same type and (in an option)
+ * merging the single-character ones into one class */
+static void simplify_list(regex_t *rx)
+{
+    regex_t **old = rx->data.list.enc, *enc;
+    size_t n = rx->data.list.n_enc, i, j, cls_idx = 0;
+    int n_leaves = 0;
+    unsigned int set[CLASS_SZ];
+
+    rx->data.list.enc = malloc_or_die(n + 1, regex_t *);
+    rx->data.list.array_sz = n + 1;
+    rx->data.list.n_enc = 0;
+
+    for(i = 0; i < n; ++i) {
+        enc = simplify_regex(old[i]);
+
+        if(enc->type == rx->type) {
+            for(j = 0; j < enc->data.list.n_enc; ++j)
+                add_enc_rx(rx, enc->data.list.enc[j]);
+            free_regex_node(enc);
+        } else if(rx->type == R_CONCAT && enc->type == R_ZERO) {
+            free_regex_node(enc);
+        } else if(rx->type == R_OPTION && is_leaf(enc)) {
+            if(n_leaves++ == 0) {
+                cls_idx = rx->data.list.n_enc;
+                add_enc_rx(rx, enc);
+                continue;
+            }
+
+            if(n_leaves == 2) { /* Turn the first one into a class */
+                regex_leaf_set(rx->data.list.enc[cls_idx], set);
+                free_regex_node(rx->data.list.enc[cls_idx]);
+                rx->data.list.enc[cls_idx] = mk_char_class_rx(0);
+                for(j = 0; j < CLASS_SZ; ++j)
+                    rx->data.list.enc[cls_idx]->data.cls.set[j] = set[j];
+            }
+
+            regex_leaf_set(enc, set);
+            for(j = 0; j < CLASS_SZ; ++j)
+                rx->data.list.enc[cls_idx]->data.cls.set[j] |= set[j];
+            free_regex_node(enc);
+        } else
+            add_enc_rx(rx, enc);
+    }
+
+    free(old);
+}
+
+regex_t * simplify_regex(regex_t *rx)
+{
+    regex_t *enc;
+    int min, max;
+
+    switch(rx->type) {
+      case R_OPTION:
+      case R_CONCAT:
+        simplify_list(rx);
+
+        if(rx->data.list.n_enc == 1) {
+            enc = rx->data.list.enc[0];
+            free_regex_node(rx);
+            return enc;
+        }
+
+        if(rx->data.list.n_enc == 0 && rx->type == R_CONCAT) {
+            free(rx->data.list.enc);
+            rx->type = R_ZERO;
+        }
+        return rx;
+
+      case R_MAYBE:
+      case R_STAR:
+      case R_PLUS:
+        enc = rx->data.enc = simplify_regex(rx->data.enc);
+
+        if(enc->type == R_ZERO) {
+            free_regex_node(rx);
+            return enc;
+        }
+
+        /* Of the nine combinations of two of ?, *, and +, those of a kind
+         * are the same as one of them, and the rest are the same as * */
+        if(enc->type == R_MAYBE || enc->type == R_STAR ||
+           enc->type == R_PLUS) {
+            if(enc->type == rx->type) {
+                free_regex_node(rx);
+                return enc;
+            }
+
+            rx->type = R_STAR;
+            rx->data.enc = enc->data.enc;
+            free_regex_node(enc);
+        }
+        return rx;
+
+      case R_NUM:
+        enc = rx->data.num.enc = simplify_regex(rx->data.num.enc);
+        min = (rx->data.num.min < 0) ? 0 : rx->data.num.min;
+        max = rx->data.num.max;
+
+        if(max == 0) {
+            free_regex_tree(enc);
+            rx->type = R_ZERO;
+            return rx;
+        }
+
+        if(min == 1 && max == 1) {
+            free_regex_node(rx);
+            return enc;
+        }
+
+        if(min <= 1 && (max == -1 || (min == 0 && max == 1))) {
+            rx->type = (max == 1) ? R_MAYBE : (min == 0) ? R_STAR : R_PLUS;
+            rx->data.enc = enc;
+            return simplify_regex(rx);
+        }
+        return rx;
+
+      default:
+        return rx;
+    }
+}
+
+long regex_positions(const regex_t *rx)
+{
+    long n = 0, copies;
+    size_t i;
+
+    switch(rx->type) {
+      case R_CHAR:
+      case R_CLASS:
+      case R_ANY:
+        return 1;
+
+      case R_OPTION:
+      case R_CONCAT:
+        for(i = 0; i < rx->data.list.n_enc && n < REGEX_POSITIONS_MAX; ++i)
+            n += regex_positions(rx->data.list.enc[i]);
+        break;
+
+      case R_MAYBE:
+      case R_STAR:
+      case R_PLUS:
+        return regex_positions(rx->data.enc);
+
+      case R_NUM:
+        if(rx->data.num.max != -1)
+            copies = rx->data.num.max;
+        else
+            copies = ((rx->data.num.min > 0) ? rx->data.num.min : 0) + 1;
+        n = regex_positions(rx->data.num.enc);
+        if(n > 0 && copies > REGEX_POSITIONS_MAX / n)
+            return REGEX_POSITIONS_MAX;
+        n *= copies;
+        break;
+
+      default:
+        break;
+    }
+
+    return (n < REGEX_POSITIONS_MAX) ? n : REGEX_POSITIONS_MAX;
+}
+
+int print_big_repetitions(FILE *f, const regex_t *rx, long threshold, int n)
+{
+    long pos;
+    int found = 0;
+    size_t i;
+
+    switch(rx->type) {
+      case R_OPTION:
+      case R_CONCAT:
+        for(i = 0; i < rx->data.list.n_enc; ++i)
+            found += print_big_repetitions(f, rx->data.list.enc[i], threshold,
+                                           n);
+        break;
+
+      case R_MAYBE:
+      case R_STAR:
+      case R_PLUS:
+        found = print_big_repetitions(f, rx->data.enc, threshold, n);
+        break;
+
+      case R_NUM:
+        if((pos = regex_positions(rx)) <= threshold)
+            break;
+        fprintf(f, "pattern %d: ", n);
+        print_regex(f, rx);
+        fprintf(f, " expands to %ld%s positions\n", pos,
+                (pos >= REGEX_POSITIONS_MAX) ? " or more" : "");
+        found = 1;
+        break;
+
+      default:
+        break;
+    }
+
+    return found;
+}
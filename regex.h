@@ -101,6 +101,19 @@ void add_enc_rx_impl(regex_t *rx, regex_t *enc, const char *fname, int line);
     __FILE__, __LINE__)
 #define add_enc_rx(rx, enc) add_enc_rx_impl((rx), (enc), __FILE__, __LINE__)
 
+/* Sets set (CLASS_SZ unsigned ints) to the characters matched by the
+ * single-character regex rx (of type R_CHAR, R_CLASS, or R_ANY): */
+void regex_leaf_set(const regex_t *rx, unsigned int *set);
+
+/*
+ * Rewrites the tree rx into a simpler equivalent one, freeing the nodes it no
+ * longer needs, and returns the new root. Nested concatenations and options
+ * are flattened, options of single characters become classes, R_NUM
+ * repetitions of the forms {0,}, {1,}, {0,1}, and {1,1} become *, +, ?, and
+ * the enclosed regex itself, and repeated ?, *, and + collapse to one.
+ */
+regex_t * simplify_regex(regex_t *rx);
+
 /* The following unallocates a tree of regex objects: */
 void free_regex_tree_impl(regex_t *rx, const char *fname, int line);
 
@@ -109,4 +122,18 @@ void free_regex_tree_impl(regex_t *rx, const char *fname, int line);
 /* The following prints out a human-readable version of a regex tree: */
 void print_regex_tree(FILE *f, regex_t *rx);
 
+/* ...and this prints it on one line, roughly as written in a lexer spec: */
+void print_regex(FILE *f, const regex_t *rx);
+
+/* Returns the number of single-character regexes in rx once its counted
+ * repetitions are written out in full (roughly the number of NFA states
+ * they cost); the count stops growing at REGEX_POSITIONS_MAX. */
+#define REGEX_POSITIONS_MAX 1000000000L
+long regex_positions(const regex_t *rx);
+
+/* Prints a line to f, headed by "pattern n", for each outermost counted
+ * repetition in rx with more than threshold positions when written out;
+ * returns the number of lines printed. */
+int print_big_repetitions(FILE *f, const regex_t *rx, long threshold, int n);
+
 #endif
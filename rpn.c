@@ -0,0 +1,1261 @@
+/* The default lexical-scanner template for Moonlime. Terms under which the
+ * generated code may be distributed, modified, etc. are provided by the
+ * lexer-writer below. */
+
+
+
+#include <stdlib.h>
+
+typedef struct yy_Calc_state Calc_state;
+
+Calc_state * CalcInit( void * (*alloc)(size_t),
+    void (*unalloc)(void *) );
+void CalcDestroy( Calc_state *lexer );
+int CalcRead( Calc_state *lexer, char *input, size_t len  );
+#if 0 || YY_PROFILE
+#include <stdio.h>
+void CalcDumpProfile( Calc_state *lexer, FILE *f );
+#endif
+#if YY_TRACE
+#include <stdio.h>
+unsigned long long CalcLatencyPercentile( Calc_state *lexer,
+    double p );
+void CalcDumpLatency( Calc_state *lexer, FILE *f );
+#endif
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define STK_SZ 20
+long stack[STK_SZ];
+int i = 0;
+
+void err(const char *s)
+{
+    fputs(s, stderr);
+    exit(1);
+}
+
+int main()
+{
+    int c; char x;
+    Calc_state *r = CalcInit(malloc, free);
+    while((c = getchar()) != EOF) {
+        x = c;
+        if(!CalcRead(r, &x, 1)) err("bad input\n");
+    }
+    if(!CalcRead(r, NULL, 0)) err("bad input\n");
+    CalcDestroy(r);
+    return 0;
+}
+
+#define op(x) if(i < 2) err("stack underflow"); \
+    stack[i-2] = stack[i-2] x stack[i-1]; \
+    i -= 1
+
+
+/* Whether the DFA is built bit by bit while scanning, from an embedded NFA,
+ * instead of ahead of time (see %option lazy) */
+#define YY_LAZY 0
+
+/* Whether some pattern has keywords, looked up in a perfect hash after the
+ * pattern matches (see %keywords) */
+#define YY_KEYWORDS 0
+
+/* Whether the DFA tables are loaded at run time from a .mlt file (see
+ * moonlime -b) by the runtime in mltrt.c, instead of compiled in */
+#define YY_MLT 0
+
+#define YY_HAS_UDATA 0
+
+/* Whether no DFA state without a match can be reached after one with, so that
+ * the lexer never has to back up to an earlier match (see moonlime --backup);
+ * define it as 0 when compiling the lexer to use the general scanner anyway */
+#ifndef YY_NO_BACKUP
+#define YY_NO_BACKUP 0
+#endif
+
+/* Run just before the code of each pattern (or keyword) matched, with its
+ * number; define it when compiling the lexer to count or trace tokens */
+#ifndef YY_ON_ACTION
+#define YY_ON_ACTION(done_num)
+#endif
+
+/* The number of patterns and keywords, whose actions are numbered from 1 */
+#define YY_N_ACTIONS 8
+
+/* Whether each lexer counts the matches of each pattern and keyword, and the
+ * work done to find them (see %option profile); the counts are written out
+ * by CalcDumpProfile */
+#ifndef YY_PROFILE
+#define YY_PROFILE 0
+#endif
+
+#if YY_PROFILE
+#define YY_COUNT(counter) (++ms->counter)
+#else
+#define YY_COUNT(counter)
+#endif
+
+/* Whether each lexer notes when the bytes it's handed arrive, and keeps a
+ * histogram of how long each token waits, from its first byte's arrival to
+ * its code being run; read it with CalcLatencyPercentile */
+#ifndef YY_TRACE
+#define YY_TRACE 0
+#endif
+
+#if YY_TRACE
+/* Run just before the code of each token, with its pattern (or keyword)
+ * number, the offsets in the input of its first byte and of the byte after
+ * it, and the time its first byte arrived */
+#ifndef YY_TRACE_TOKEN
+#define YY_TRACE_TOKEN(rule, start_offset, end_offset, ts)
+#endif
+
+/* Each power of two of nanoseconds is split into 1 << YY_TRACE_SUB_BITS
+ * buckets, so waits are known to within 1 part in 16 */
+#define YY_TRACE_SUB_BITS 4
+#define YY_TRACE_BUCKETS ((65 - YY_TRACE_SUB_BITS) << YY_TRACE_SUB_BITS)
+#endif
+
+#if YY_MLT
+#include "mltrt.h"
+
+#ifndef YY_MLT_FILE
+#define YY_MLT_FILE 
+#endif
+#endif
+
+typedef struct {
+  int done_num;
+  int trans_start;
+  int trans_end;
+} yyml_fa;
+
+typedef struct {
+  unsigned char transset[32];
+  int dest_state;
+} yyml_trans;
+
+#if YY_TRACE
+typedef struct {
+  unsigned long long offset; /* Of the first byte handed over by a Read */
+  unsigned long long ts;     /* When it was */
+} yytrace_arrival;
+
+typedef struct {
+  void * (*alloc)(size_t);
+  void (*unalloc)(void *);
+  unsigned long long offset;   /* Of the next token's first byte */
+  unsigned long long received; /* Bytes handed over so far */
+  /* The Reads whose bytes may not all be in tokens yet, oldest first, in a
+   * ring starting at q[q_head] */
+  yytrace_arrival *q;
+  int q_head, q_n, q_size;
+  unsigned long long n, max; /* Tokens traced, and their longest wait */
+  unsigned long hist[YY_TRACE_BUCKETS];
+} yytrace;
+#endif
+
+#if YY_MLT
+typedef struct yy_Calc_state {
+  mlt_tables *tables;
+  mlt_lexer *lexer;
+  void (*unalloc)(void *);
+  void *udata; /* The user data passed to the Read in progress */
+#if YY_PROFILE
+  unsigned long yyp_hits[YY_N_ACTIONS + 1]; /* Matches of each action */
+#endif
+#if YY_TRACE
+  yytrace yyt;
+#endif
+} yyml_state;
+#else
+typedef struct yy_Calc_state {
+  int is_in_error;
+  int curr_state; /* state of the DFA */
+  int curr_start_state; /* which DFA to use... */
+  int last_done_num;
+  int last_done_len;
+  size_t string_len;
+  size_t curr_buf_size;
+  void * (*alloc)(size_t);
+  void (*unalloc)(void *);
+  char *buf;
+  char start_buf[64];
+#if YY_LAZY
+  /* The cache of DFA states built so far (in one block, lz_mem) */
+  unsigned long *lz_sets; /* The NFA states in each (YY_SET_WORDS words) */
+  int *lz_next;           /* Next state on each character class, or
+                           * YY_LAZY_UNKNOWN or YY_LAZY_DEAD */
+  int *lz_done;           /* done_num of each state */
+  int *lz_chain;          /* Next state in the same hash bucket */
+  int *lz_hash;           /* First state in each hash bucket, or -1 */
+  int *lz_starts;         /* Initial state of each start state, or -1 */
+  int lz_n;               /* Number of states in the cache */
+  int lz_epoch;           /* Number of times the cache has been flushed */
+  unsigned long lz_bytes; /* Characters scanned since the last flush */
+  int lz_thrash;          /* Flushes in a row that came too soon */
+  int lz_nfa_mode;        /* Given up on the cache; simulate the NFA */
+  unsigned long *lz_cur;  /* The NFA states we're in, when simulating */
+  unsigned long *lz_work; /* Scratch set */
+  void *lz_mem;
+#endif
+#if YY_PROFILE
+  unsigned long yyp_hits[YY_N_ACTIONS + 1]; /* Matches of each action */
+  unsigned long yyp_relexed; /* Characters scanned again after backing up */
+  unsigned long yyp_grows;   /* Times buf was enlarged */
+#if YY_LAZY
+  unsigned long yyp_steps;   /* Transitions taken */
+#else
+  unsigned long *yyp_visits; /* Times each DFA state was entered */
+#endif
+#endif
+#if YY_TRACE
+  yytrace yyt;
+#endif
+} yyml_state;
+#endif
+
+#if YY_MLT
+#elif !YY_LAZY
+static yyml_fa yy_x[] = {
+
+ {0, 0, 7},
+ {8, 7, 7},
+ {4, 7, 7},
+ {2, 7, 7},
+ {3, 7, 7},
+ {5, 7, 7},
+ {1, 7, 8},
+ {6, 8, 9},
+ {0, 9, 10},
+ {7, 10, 10}
+
+};
+
+static yyml_trans yy_y[] = {
+
+ { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 7 },
+ { {0,0,0,0,0,0,255,3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 6 },
+ { {0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 5 },
+ { {0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 4 },
+ { {0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 3 },
+ { {0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 2 },
+ { {0,6,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 1 },
+ { {0,0,0,0,0,0,255,3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 6 },
+ { {0,0,0,0,0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 8 },
+ { {0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 9 }
+
+};
+
+static int yy_init_states[] = {
+
+ 0
+
+};
+#else
+static yyml_fa yy_nx[] = {
+
+};
+
+static yyml_trans yy_ny[] = {
+
+};
+
+/* The NFA states each start state begins in, as -1-terminated lists */
+static int yy_nfa_inits[] = {
+
+};
+
+/* Where each start state's list starts in yy_nfa_inits */
+static int yy_nfa_starts[] = {
+
+};
+
+/* The class of each character; no transition tells those in a class apart */
+static unsigned char yy_classes[256] = {
+
+};
+
+#define YY_NFA_STATES 
+#define YY_NCLASSES 
+#define YY_SET_WORDS ((YY_NFA_STATES + 31) / 32)
+
+#ifndef YY_LAZY_CACHE
+#define YY_LAZY_CACHE 1024
+#endif
+/* A flush after fewer than YY_LAZY_MIN_BYTES characters per cached state
+ * counts as thrashing; after YY_LAZY_MAX_THRASH of those in a row, the lexer
+ * stops caching and simulates the NFA directly. */
+#ifndef YY_LAZY_MIN_BYTES
+#define YY_LAZY_MIN_BYTES 10
+#endif
+#ifndef YY_LAZY_MAX_THRASH
+#define YY_LAZY_MAX_THRASH 3
+#endif
+#define YY_LAZY_HASH (2 * YY_LAZY_CACHE)
+#define YY_LAZY_UNKNOWN (-1)
+#define YY_LAZY_DEAD (-2)
+#endif
+
+#if YY_KEYWORDS && !YY_MLT
+
+#endif
+
+#if YY_TRACE
+#ifndef YY_TRACE_NOW
+#include <time.h>
+
+static unsigned long long yytrace_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* The time now, in nanoseconds */
+#define YY_TRACE_NOW() yytrace_now()
+#endif
+
+static void yytrace_init(yytrace *tr, void * (*alloc)(size_t),
+                         void (*unalloc)(void *))
+{
+    int i;
+
+    tr->alloc = alloc;
+    tr->unalloc = unalloc;
+    tr->offset = tr->received = 0;
+    tr->q = NULL;
+    tr->q_head = tr->q_n = tr->q_size = 0;
+    tr->n = tr->max = 0;
+    for(i = 0; i < YY_TRACE_BUCKETS; ++i)
+        tr->hist[i] = 0;
+}
+
+static void yytrace_free(yytrace *tr)
+{
+    if(tr->q != NULL)
+        tr->unalloc(tr->q);
+}
+
+/* Forgets the Reads all of whose bytes are in tokens already */
+static void yytrace_drop(yytrace *tr)
+{
+    while(tr->q_n > 1 &&
+          tr->q[(tr->q_head + 1) % tr->q_size].offset <= tr->offset) {
+        tr->q_head = (tr->q_head + 1) % tr->q_size;
+        --tr->q_n;
+    }
+}
+
+/* Notes the arrival of len more bytes */
+static void yytrace_arrive(yytrace *tr, size_t len)
+{
+    yytrace_arrival *q;
+    int i;
+
+    yytrace_drop(tr);
+
+    if(tr->q_n == tr->q_size) {
+        /* With no room to be had, the bytes are taken to have come with the
+         * last Read's, making their tokens seem to wait longer */
+        if((q = tr->alloc((tr->q_size ? 2 * tr->q_size : 8) *
+                          sizeof(yytrace_arrival))) == NULL) {
+            tr->received += len;
+            return;
+        }
+        for(i = 0; i < tr->q_n; ++i)
+            q[i] = tr->q[(tr->q_head + i) % tr->q_size];
+        yytrace_free(tr);
+        tr->q = q;
+        tr->q_head = 0;
+        tr->q_size = tr->q_size ? 2 * tr->q_size : 8;
+    }
+
+    q = &tr->q[(tr->q_head + tr->q_n++) % tr->q_size];
+    q->offset = tr->received;
+    q->ts = YY_TRACE_NOW();
+    tr->received += len;
+}
+
+/* Records the wait of the next token, len bytes long, matched by rule */
+static void yytrace_token(yytrace *tr, int rule, size_t len)
+{
+    unsigned long long now = YY_TRACE_NOW(), arrived, wait;
+    int e, b;
+
+    yytrace_drop(tr);
+    arrived = (tr->q_n > 0) ? tr->q[tr->q_head].ts : now;
+    wait = (now > arrived) ? now - arrived : 0;
+
+    /* Small waits have a bucket each; bigger ones share with those having
+     * the same highest YY_TRACE_SUB_BITS + 1 bits */
+    if(wait < (2ULL << YY_TRACE_SUB_BITS))
+        b = (int) wait;
+    else {
+        for(e = YY_TRACE_SUB_BITS + 1; (wait >> e) > 1; ++e)
+            ;
+        b = ((e - YY_TRACE_SUB_BITS) << YY_TRACE_SUB_BITS) +
+            (int) (wait >> (e - YY_TRACE_SUB_BITS));
+    }
+    ++tr->hist[b];
+    ++tr->n;
+    if(wait > tr->max)
+        tr->max = wait;
+
+    YY_TRACE_TOKEN(rule, tr->offset, tr->offset + len, arrived);
+    tr->offset += len;
+}
+#endif
+
+#define YY_STATE_A 0
+#define YY_MAXSTATE 0
+#define YY_INITSTATE YY_STATE_A
+
+
+#if YY_LAZY && !YY_MLT
+static void yylazy_flush(yyml_state *ms)
+{
+    int i;
+
+    for(i = 0; i < YY_LAZY_HASH; ++i)
+        ms->lz_hash[i] = -1;
+    for(i = 0; i <= YY_MAXSTATE; ++i)
+        ms->lz_starts[i] = -1;
+
+    ms->lz_n = 0;
+    ++ms->lz_epoch;
+}
+
+static int yylazy_alloc(yyml_state *ms)
+{
+    size_t n_words = (size_t) (YY_LAZY_CACHE + 2) * YY_SET_WORDS;
+    size_t n_ints = (size_t) YY_LAZY_CACHE * (YY_NCLASSES + 2) +
+                    YY_LAZY_HASH + YY_MAXSTATE + 1;
+    char *mem = ms->alloc(n_words * sizeof(unsigned long) +
+                          n_ints * sizeof(int));
+
+    if(mem == NULL)
+        return 0;
+
+    ms->lz_mem = mem;
+    ms->lz_sets = (unsigned long *) mem;
+    ms->lz_cur = ms->lz_sets + YY_LAZY_CACHE * YY_SET_WORDS;
+    ms->lz_work = ms->lz_cur + YY_SET_WORDS;
+    ms->lz_next = (int *) (ms->lz_work + YY_SET_WORDS);
+    ms->lz_done = ms->lz_next + YY_LAZY_CACHE * YY_NCLASSES;
+    ms->lz_chain = ms->lz_done + YY_LAZY_CACHE;
+    ms->lz_hash = ms->lz_chain + YY_LAZY_CACHE;
+    ms->lz_starts = ms->lz_hash + YY_LAZY_HASH;
+
+    ms->lz_epoch = 0;
+    ms->lz_bytes = 0;
+    ms->lz_thrash = 0;
+    ms->lz_nfa_mode = 0;
+    yylazy_flush(ms);
+
+    return 1;
+}
+
+/* Sets out to the NFA states reached from those in set on the character c;
+ * returns the least done_num among them (0 if none), or -1 if there are no
+ * such states at all */
+static int yylazy_step(const unsigned long *set, unsigned char c,
+                       unsigned long *out)
+{
+    int i, j, s, t, d, done_num = 0, found = 0;
+
+    for(i = 0; i < YY_SET_WORDS; ++i)
+        out[i] = 0;
+
+    for(i = 0; i < YY_SET_WORDS; ++i) {
+        if(set[i] == 0)
+            continue;
+
+        for(j = 0; j < 32; ++j) {
+            if(!(set[i] & (1UL << j)))
+                continue;
+
+            s = i * 32 + j;
+            for(t = yy_nx[s].trans_start; t < yy_nx[s].trans_end; ++t) {
+                if(!(yy_ny[t].transset[c >> 3] & (1 << (c & 7))))
+                    continue;
+
+                d = yy_ny[t].dest_state;
+                out[d / 32] |= 1UL << (d % 32);
+                found = 1;
+                if(yy_nx[d].done_num &&
+                   (done_num == 0 || yy_nx[d].done_num < done_num))
+                    done_num = yy_nx[d].done_num;
+            }
+        }
+    }
+
+    return found ? done_num : -1;
+}
+
+/* Returns the cache index of the DFA state for the NFA states in set, adding
+ * it if need be (flushing the cache first if it's full), or -1 if the cache
+ * is thrashing and the lexer has switched to simulating the NFA */
+static int yylazy_state(yyml_state *ms, const unsigned long *set,
+                        int done_num)
+{
+    unsigned long h = 2166136261UL;
+    int i, k;
+
+    for(i = 0; i < YY_SET_WORDS; ++i)
+        h = (h ^ set[i]) * 16777619UL;
+    h %= YY_LAZY_HASH;
+
+    for(k = ms->lz_hash[h]; k >= 0; k = ms->lz_chain[k]) {
+        for(i = 0; i < YY_SET_WORDS; ++i)
+            if(ms->lz_sets[k * YY_SET_WORDS + i] != set[i])
+                break;
+        if(i == YY_SET_WORDS)
+            return k;
+    }
+
+    if(ms->lz_n >= YY_LAZY_CACHE) {
+        if(ms->lz_bytes < (unsigned long) YY_LAZY_MIN_BYTES * YY_LAZY_CACHE) {
+            if(++ms->lz_thrash >= YY_LAZY_MAX_THRASH) {
+                ms->lz_nfa_mode = 1;
+                return -1;
+            }
+        } else
+            ms->lz_thrash = 0;
+
+        ms->lz_bytes = 0;
+        yylazy_flush(ms);
+    }
+
+    k = ms->lz_n++;
+    for(i = 0; i < YY_SET_WORDS; ++i)
+        ms->lz_sets[k * YY_SET_WORDS + i] = set[i];
+    for(i = 0; i < YY_NCLASSES; ++i)
+        ms->lz_next[k * YY_NCLASSES + i] = YY_LAZY_UNKNOWN;
+    ms->lz_done[k] = done_num;
+    ms->lz_chain[k] = ms->lz_hash[h];
+    ms->lz_hash[h] = k;
+
+    return k;
+}
+
+static void yylazy_swap_sets(yyml_state *ms)
+{
+    unsigned long *tmp = ms->lz_cur;
+
+    ms->lz_cur = ms->lz_work;
+    ms->lz_work = tmp;
+}
+
+/* Puts the lexer in the initial state of the start state start_state */
+static void yylazy_start(yyml_state *ms, int start_state)
+{
+    int i, k, d, done_num = 0;
+
+    if(!ms->lz_nfa_mode && ms->lz_starts[start_state] >= 0) {
+        ms->curr_state = ms->lz_starts[start_state];
+        return;
+    }
+
+    for(i = 0; i < YY_SET_WORDS; ++i)
+        ms->lz_work[i] = 0;
+
+    for(i = yy_nfa_starts[start_state]; (d = yy_nfa_inits[i]) >= 0; ++i) {
+        ms->lz_work[d / 32] |= 1UL << (d % 32);
+        if(yy_nx[d].done_num &&
+           (done_num == 0 || yy_nx[d].done_num < done_num))
+            done_num = yy_nx[d].done_num;
+    }
+
+    if(!ms->lz_nfa_mode &&
+       (k = yylazy_state(ms, ms->lz_work, done_num)) >= 0) {
+        ms->curr_state = ms->lz_starts[start_state] = k;
+        return;
+    }
+
+    yylazy_swap_sets(ms);
+}
+
+/* Moves the lexer on by the character c, building the DFA state it goes to
+ * if it isn't in the cache; returns that state's done_num, or -1 (leaving
+ * the lexer where it was) if there's no transition on c */
+static int yylazy_next(yyml_state *ms, unsigned char c)
+{
+    int from = ms->curr_state, cls = yy_classes[c], next, done_num, epoch;
+
+    ++ms->lz_bytes;
+
+    if(ms->lz_nfa_mode) {
+        if((done_num = yylazy_step(ms->lz_cur, c, ms->lz_work)) < 0)
+            return -1;
+        yylazy_swap_sets(ms);
+        return done_num;
+    }
+
+    next = ms->lz_next[from * YY_NCLASSES + cls];
+
+    if(next == YY_LAZY_UNKNOWN) {
+        done_num = yylazy_step(ms->lz_sets + from * YY_SET_WORDS, c,
+                               ms->lz_work);
+
+        if(done_num < 0)
+            next = YY_LAZY_DEAD;
+        else {
+            epoch = ms->lz_epoch;
+
+            if((next = yylazy_state(ms, ms->lz_work, done_num)) < 0) {
+                yylazy_swap_sets(ms);
+                return done_num;
+            }
+
+            if(epoch != ms->lz_epoch) { /* from was flushed */
+                ms->curr_state = next;
+                return done_num;
+            }
+        }
+
+        ms->lz_next[from * YY_NCLASSES + cls] = next;
+    }
+
+    if(next == YY_LAZY_DEAD)
+        return -1;
+
+    ms->curr_state = next;
+    return ms->lz_done[next];
+}
+#endif
+
+static void yymoonlime_action(int done_num, const char *yytext, size_t yylen,
+                              int *yy_start_state );
+
+#if YY_KEYWORDS && !YY_MLT
+static int yykeyword(int done_num, const char *yytext, size_t yylen);
+#endif
+
+#if YY_MLT
+static void yymlt_action(int rule, const char *yytext, size_t yylen,
+                         int *start_state, void *data)
+{
+    yyml_state *ms = data;
+
+    YY_COUNT(yyp_hits[rule]);
+#if YY_TRACE
+    yytrace_token(&ms->yyt, rule, yylen);
+#endif
+#if YY_HAS_UDATA
+    yymoonlime_action(rule, yytext, yylen, start_state,
+                      *( *) ms->udata);
+#else
+    (void) ms;
+    yymoonlime_action(rule, yytext, yylen, start_state);
+#endif
+}
+
+Calc_state * CalcInit( void * (*alloc)(size_t),
+    void (*unalloc)(void *) )
+{
+    yyml_state *ms;
+#if YY_PROFILE
+    int i;
+#endif
+
+    if(alloc == NULL || unalloc == NULL)
+        return NULL;
+
+    if((ms = alloc(sizeof(yyml_state))) == NULL)
+        return NULL;
+
+    ms->unalloc = unalloc;
+    ms->udata = NULL;
+    ms->lexer = NULL;
+#if YY_PROFILE
+    for(i = 0; i <= YY_N_ACTIONS; ++i)
+        ms->yyp_hits[i] = 0;
+#endif
+#if YY_TRACE
+    yytrace_init(&ms->yyt, alloc, unalloc);
+#endif
+
+    /* Tables for a different set of actions can't be used */
+    if((ms->tables = mlt_open(YY_MLT_FILE)) == NULL ||
+       mlt_n_actions(ms->tables) != YY_N_ACTIONS ||
+       mlt_n_starts(ms->tables) != YY_MAXSTATE + 1 ||
+       (ms->lexer = mlt_init(ms->tables, yymlt_action, ms, alloc,
+                             unalloc)) == NULL) {
+        mlt_close(ms->tables);
+        unalloc(ms);
+        return NULL;
+    }
+
+    return ms;
+}
+
+void CalcDestroy( Calc_state *lexer )
+{
+    yyml_state *ms = lexer;
+
+    if(ms == NULL)
+        return;
+
+    mlt_destroy(ms->lexer);
+    mlt_close(ms->tables);
+#if YY_TRACE
+    yytrace_free(&ms->yyt);
+#endif
+    ms->unalloc(ms);
+}
+
+int CalcRead( Calc_state *lexer, char *input, size_t len  )
+{
+    yyml_state *ms = lexer;
+
+    if(ms == NULL)
+        return 0;
+
+#if YY_HAS_UDATA
+    ms->udata = &data;
+#endif
+#if YY_TRACE
+    if(len > 0)
+        yytrace_arrive(&ms->yyt, len);
+#endif
+    return mlt_read(ms->lexer, input, len);
+}
+
+#if YY_PROFILE
+/* The runtime does the scanning, so only the matches are counted */
+void CalcDumpProfile( Calc_state *lexer, FILE *f )
+{
+    yyml_state *ms = lexer;
+    int i;
+
+    if(ms == NULL)
+        return;
+
+    fputs("Calc profile:\n", f);
+    for(i = 1; i <= YY_N_ACTIONS; ++i)
+        if(ms->yyp_hits[i] != 0)
+            fprintf(f, "  action %d: %lu matches\n", i, ms->yyp_hits[i]);
+}
+#endif
+#else
+Calc_state * CalcInit( void * (*alloc)(size_t),
+    void (*unalloc)(void *) )
+{
+    yyml_state *ms;
+#if YY_PROFILE
+    int i;
+#if !YY_LAZY
+    int n_states;
+#endif
+#endif
+
+    if(alloc == NULL || unalloc == NULL)
+        return NULL;
+
+    ms = alloc(sizeof(yyml_state));
+
+    if(ms == NULL)
+        return NULL;
+
+    ms->alloc = alloc;
+    ms->unalloc = unalloc;
+
+#if YY_PROFILE
+    for(i = 0; i <= YY_N_ACTIONS; ++i)
+        ms->yyp_hits[i] = 0;
+    ms->yyp_relexed = ms->yyp_grows = 0;
+#if YY_LAZY
+    ms->yyp_steps = 0;
+#else
+    n_states = sizeof(yy_x) / sizeof(yy_x[0]);
+    if((ms->yyp_visits = alloc(n_states * sizeof(unsigned long))) == NULL) {
+        unalloc(ms);
+        return NULL;
+    }
+    for(i = 0; i < n_states; ++i)
+        ms->yyp_visits[i] = 0;
+#endif
+#endif
+#if YY_TRACE
+    yytrace_init(&ms->yyt, alloc, unalloc);
+#endif
+
+    ms->is_in_error = 0;
+    ms->curr_start_state = YY_INITSTATE;
+    ms->last_done_num = 0;
+    ms->last_done_len = 0;
+
+    ms->string_len = 0;
+    ms->curr_buf_size = 64;
+    ms->buf = ms->start_buf;
+
+#if YY_LAZY
+    if(!yylazy_alloc(ms)) {
+        unalloc(ms);
+        return NULL;
+    }
+    yylazy_start(ms, YY_INITSTATE);
+#else
+    ms->curr_state = yy_init_states[YY_INITSTATE];
+#endif
+
+    return ms;
+}
+
+void CalcDestroy( Calc_state *lexer )
+{
+    yyml_state *ms = lexer;
+
+    if(ms == NULL)
+        return;
+
+    if(ms->buf != NULL && ms->buf != ms->start_buf) {
+        ms->unalloc(ms->buf);
+    }
+
+#if YY_LAZY
+    ms->unalloc(ms->lz_mem);
+#endif
+#if YY_PROFILE && !YY_LAZY
+    ms->unalloc(ms->yyp_visits);
+#endif
+#if YY_TRACE
+    yytrace_free(&ms->yyt);
+#endif
+
+    ms->unalloc(ms);
+}
+
+/* Adds c to the text of the token being scanned */
+static int yyadd_char(yyml_state *ms, char c)
+{
+    char *new_buf;
+    int i;
+
+    if(ms->string_len >= ms->curr_buf_size - 1) {
+        if((new_buf = ms->alloc(ms->curr_buf_size * 2)) == NULL) {
+            ms->is_in_error = 1;
+            return 0;
+        }
+        YY_COUNT(yyp_grows);
+        for(i = 0; i < ms->string_len; ++i)
+            new_buf[i] = ms->buf[i];
+        ms->curr_buf_size *= 2;
+        if(ms->buf != ms->start_buf)
+            ms->unalloc(ms->buf);
+        ms->buf = new_buf;
+    }
+    ms->buf[ms->string_len++] = c;
+    return 1;
+}
+
+#if YY_NO_BACKUP
+/* Takes the DFA's transition on c, if it has one, adding c to the token */
+static int yystep(yyml_state *ms, char c)
+{
+    int curr_trans, end_trans, c_idx, c_mask;
+
+    curr_trans = yy_x[ms->curr_state].trans_start;
+    end_trans = yy_x[ms->curr_state].trans_end;
+
+    c_idx = ((unsigned char) c) >> 3;
+    c_mask = 1 << (c & 7);
+
+    while(curr_trans < end_trans) {
+        if(yy_y[curr_trans].transset[c_idx] & c_mask) {
+            if(!yyadd_char(ms, c))
+                return 0;
+            ms->curr_state = yy_y[curr_trans].dest_state;
+            YY_COUNT(yyp_visits[ms->curr_state]);
+            return 1;
+        }
+        ++curr_trans;
+    }
+
+    return 0;
+}
+#else
+static int yyrun_char(yyml_state *ms, char c, int add_to_buf, int len)
+{
+#if YY_LAZY
+    int done_num;
+#else
+    int curr_trans, end_trans, c_idx, c_mask, next_state;
+#endif
+
+    if(add_to_buf) {
+        if(!yyadd_char(ms, c))
+            return 0;
+    } else
+        YY_COUNT(yyp_relexed);
+
+#if YY_LAZY
+    if((done_num = yylazy_next(ms, (unsigned char) c)) < 0)
+        return 0;
+    YY_COUNT(yyp_steps);
+
+    if(done_num) {
+        ms->last_done_num = done_num;
+        ms->last_done_len = len;
+    }
+    return 1;
+#else
+    curr_trans = yy_x[ms->curr_state].trans_start;
+    end_trans = yy_x[ms->curr_state].trans_end;
+
+    c_idx = ((unsigned char) c) >> 3;
+    c_mask = 1 << (c & 7);
+
+    while(curr_trans < end_trans) {
+        if(yy_y[curr_trans].transset[c_idx] & c_mask) {
+            ms->curr_state = next_state = yy_y[curr_trans].dest_state;
+            YY_COUNT(yyp_visits[next_state]);
+
+            if(yy_x[next_state].done_num) {
+                ms->last_done_num = yy_x[next_state].done_num;
+                ms->last_done_len = len;
+            }
+            return 1;
+        }
+        ++curr_trans;
+    }
+
+    return 0;
+#endif
+}
+#endif
+
+static void yyreset_state(yyml_state *ms)
+{
+    int i;
+
+    for(i = ms->last_done_len; i < ms->string_len; ++i)
+        ms->buf[i - ms->last_done_len] = ms->buf[i];
+    ms->string_len -= ms->last_done_len;
+    ms->last_done_len = ms->last_done_num = 0;
+#if YY_LAZY
+    yylazy_start(ms, ms->curr_start_state);
+#else
+    ms->curr_state = yy_init_states[ms->curr_start_state];
+#endif
+}
+
+/* Runs the code of the longest match found, and starts scanning again just
+ * after it */
+static void yyaccept(yyml_state *ms )
+{
+    int done_num = ms->last_done_num;
+
+#if YY_KEYWORDS
+    done_num = yykeyword(done_num, ms->buf, ms->last_done_len);
+#endif
+    YY_COUNT(yyp_hits[done_num]);
+#if YY_TRACE
+    yytrace_token(&ms->yyt, done_num, ms->last_done_len);
+#endif
+
+    yymoonlime_action(done_num, ms->buf, ms->last_done_len,
+                      &(ms->curr_start_state) );
+    yyreset_state(ms);
+}
+
+#if YY_NO_BACKUP
+/* With no backing up, the longest match is the one the DFA is in when it
+ * has no transition on the next character, and no character is scanned
+ * twice */
+int CalcRead( Calc_state *lexer, char *input, size_t len  )
+{
+    char *end = input + len;
+    yyml_state *ms = lexer;
+
+    if(ms == NULL || ms->is_in_error)
+        return 0;
+
+#if YY_TRACE
+    if(len > 0)
+        yytrace_arrive(&ms->yyt, len);
+#endif
+
+    while(input < end) {
+        if(!yystep(ms, *input)) {
+            if(ms->is_in_error)
+                return 0;
+            if(ms->string_len == 0 || !yy_x[ms->curr_state].done_num) {
+                ms->is_in_error = 1; /* no pattern matches buf */
+                return 0;
+            }
+
+            /* *input starts the next token */
+            ms->last_done_num = yy_x[ms->curr_state].done_num;
+            ms->last_done_len = ms->string_len;
+            yyaccept(ms );
+            continue;
+        }
+        ++input;
+    }
+
+    if(len == 0 && ms->string_len > 0) { /* Signifies EOF */
+        if(!yy_x[ms->curr_state].done_num) {
+            ms->is_in_error = 1;
+            return 0;
+        }
+
+        ms->last_done_num = yy_x[ms->curr_state].done_num;
+        ms->last_done_len = ms->string_len;
+        yyaccept(ms );
+    }
+
+    return 1;
+}
+#else
+int CalcRead( Calc_state *lexer, char *input, size_t len  )
+{
+    int done_relexing, i;
+    char *end = input + len;
+    yyml_state *ms = lexer;
+
+    if(ms == NULL || ms->is_in_error)
+        return 0;
+
+#if YY_TRACE
+    if(len > 0)
+        yytrace_arrive(&ms->yyt, len);
+#endif
+
+    if(len == 0) { /* Signifies EOF */
+        if(ms->string_len == 0)
+            return 1;
+
+        if(ms->last_done_num == 0) {
+            ms->is_in_error = 1;
+            return 0;
+        }
+
+        yyaccept(ms );
+
+        while(ms->string_len > 0) {
+            for(i = 0; i < ms->string_len; ++i) {
+                if(!yyrun_char(ms, ms->buf[i], 0, i+1) ||
+                   i == ms->string_len - 1) {
+                    if(ms->is_in_error || ms->last_done_num == 0) {
+                        ms->is_in_error = 1;
+                        return 0;
+                    }
+
+                    yyaccept(ms );
+                    break;
+                }
+            }
+        }
+
+        return 1;
+    }
+
+    while(input < end) {
+        if(!yyrun_char(ms, *input, 1, ms->string_len + 1)) { /* past pattern */
+            if(ms->is_in_error)
+                return 0;
+            if(ms->last_done_num == 0) { /* no pattern matches buf */
+                ms->is_in_error = 1;
+                return 0;
+            }
+            yyaccept(ms );
+
+            /* Re-lex remaining part of the buffer */
+            done_relexing = 0;
+            while(ms->string_len > 0 && !done_relexing) {
+                i = 0;
+                while(i < ms->string_len) {
+                    if(!yyrun_char(ms, ms->buf[i], 0, i+1)) {
+                        if(!ms->is_in_error && ms->last_done_num == 0)
+                            ms->is_in_error = 1;
+                        if(ms->is_in_error)
+                            return 0;
+
+                        yyaccept(ms );
+                        i = 0;
+                        continue;
+                    }
+                    ++i;
+                }
+
+                if(i == ms->string_len)
+                    done_relexing = 1;
+            }
+        }
+        ++input;
+    }
+
+    return 1;
+}
+#endif
+
+#if YY_PROFILE
+void CalcDumpProfile( Calc_state *lexer, FILE *f )
+{
+    yyml_state *ms = lexer;
+    int i;
+
+    if(ms == NULL)
+        return;
+
+    fputs("Calc profile:\n", f);
+    for(i = 1; i <= YY_N_ACTIONS; ++i)
+        if(ms->yyp_hits[i] != 0)
+            fprintf(f, "  action %d: %lu matches\n", i, ms->yyp_hits[i]);
+
+    fprintf(f, "  characters re-scanned after backing up: %lu\n"
+               "  buffer enlargements: %lu\n", ms->yyp_relexed,
+            ms->yyp_grows);
+
+#if YY_LAZY
+    /* The cache is first flushed when it's set up */
+    fprintf(f, "  transitions: %lu (%d cache flushes)\n", ms->yyp_steps,
+            ms->lz_epoch - 1);
+#else
+    for(i = 0; i < (int) (sizeof(yy_x) / sizeof(yy_x[0])); ++i)
+        if(ms->yyp_visits[i] != 0)
+            fprintf(f, "  DFA state %d: %lu visits\n", i, ms->yyp_visits[i]);
+#endif
+}
+#endif
+#endif
+
+#if YY_TRACE
+unsigned long long CalcLatencyPercentile( Calc_state *lexer,
+    double p )
+{
+    yyml_state *ms = lexer;
+    unsigned long long want, seen = 0, high;
+    int b, e, m;
+
+    if(ms == NULL || ms->yyt.n == 0)
+        return 0;
+
+    want = (unsigned long long) (p * ms->yyt.n + 0.5);
+    if(want < 1)
+        want = 1;
+
+    for(b = 0; b < YY_TRACE_BUCKETS; ++b) {
+        if((seen += ms->yyt.hist[b]) < want)
+            continue;
+
+        /* The longest wait that goes in bucket b (see yytrace_token) */
+        if(b < (2 << YY_TRACE_SUB_BITS))
+            high = b;
+        else {
+            e = (b >> YY_TRACE_SUB_BITS) - 1;
+            m = (b & ((1 << YY_TRACE_SUB_BITS) - 1)) + (1 << YY_TRACE_SUB_BITS);
+            high = ((m + 1ULL) << e) - 1;
+        }
+        return (high < ms->yyt.max) ? high : ms->yyt.max;
+    }
+
+    return ms->yyt.max;
+}
+
+void CalcDumpLatency( Calc_state *lexer, FILE *f )
+{
+    yyml_state *ms = lexer;
+
+    if(ms == NULL)
+        return;
+
+    fprintf(f, "Calc token latency: %llu tokens; p50 %llu ns, "
+               "p99 %llu ns, p99.9 %llu ns, max %llu ns\n", ms->yyt.n,
+            CalcLatencyPercentile(lexer, 0.5),
+            CalcLatencyPercentile(lexer, 0.99),
+            CalcLatencyPercentile(lexer, 0.999), ms->yyt.max);
+}
+#endif
+
+#if YY_KEYWORDS && !YY_MLT
+/* Must be kept in step with phash_fn() in Moonlime's phash.c */
+static unsigned long yykw_hash(int rule, const char *s, size_t len,
+                               unsigned long seed)
+{
+  unsigned long h = (2166136261UL + seed * 2654435761UL +
+                     (unsigned long) rule) & 0xffffffffUL;
+  size_t i;
+
+  for(i = 0; i < len; ++i)
+    h = ((h ^ (0xff & (unsigned long) s[i])) * 16777619UL) & 0xffffffffUL;
+
+  return h;
+}
+
+/* If the text matched by pattern done_num is one of its keywords, returns the
+ * number of the keyword's action; otherwise, returns done_num. */
+static int yykeyword(int done_num, const char *yytext, size_t yylen)
+{
+  unsigned long b;
+  int k;
+  size_t i;
+
+  if(!yy_kw_has[done_num])
+    return done_num;
+
+  b = yykw_hash(done_num, yytext, yylen, 0) % YY_KW_BUCKETS;
+  k = yy_kw_slots[yykw_hash(done_num, yytext, yylen, yy_kw_disp[b]) %
+                  YY_KW_SLOTS];
+
+  if(k < 0 || yy_kw_rules[k] != done_num || yy_kw_lens[k] != (int) yylen)
+    return done_num;
+
+  for(i = 0; i < yylen; ++i)
+    if(yy_kw_words[k][i] != yytext[i])
+      return done_num;
+
+  return YY_KW_FIRST_ACTION + k;
+}
+#endif
+
+#define YYSTART(x) do { *yy_start_state = YY_STATE_ ## x ; } while(0)
+
+static void yymoonlime_action(int done_num, const char *yytext, size_t yylen,
+                              int *yy_start_state )
+{
+    YY_ON_ACTION(done_num);
+
+    switch(done_num) {
+case 1: {
+
+    long n = 0; size_t j;
+    for(j = 0; j < yylen; ++j)
+        n = (n * 10) + (yytext[j] - '0');
+    if(i >= STK_SZ) err("stack overflow\n");
+    stack[i++] = n;
+
+} break;
+case 2: {
+ op(+); 
+} break;
+case 3: {
+ op(-); 
+} break;
+case 4: {
+ op(*); 
+} break;
+case 5: {
+ op(/); 
+} break;
+case 6: {
+ printf("%ld\n", stack[i-1]); 
+} break;
+case 7: {
+ if(i > 0) --i; 
+} break;
+case 8: {
+ ; 
+} break;
+
+    }
+
+    if((*yy_start_state < 0) || (*yy_start_state > YY_MAXSTATE))
+        *yy_start_state = YY_INITSTATE;
+}
@@ -0,0 +1,124 @@
+/*
+ * stats.c: Timing the phases of lexer generation (see --stats).
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#include "stats.h"
+
+#ifndef ML_STDIO_H
+#define ML_STDIO_H
+#include <stdio.h>
+#endif
+
+#ifndef ML_STDLIB_H
+#define ML_STDLIB_H
+#include <stdlib.h>
+#endif
+
+#include <sys/resource.h>
+#include <time.h>
+
+#define MAX_NESTING 8
+
+static const char * const phase_names[N_PHASES] = {
+    "parse", "nfa", "closure", "dfa", "emit"
+};
+
+static int enabled = 0;
+
+/* Each thread times the phases it runs itself (see --batch) */
+static __thread phase_stats_t stats[N_PHASES];
+
+/* The phases running, innermost last, and when each last resumed */
+static __thread ml_phase running[MAX_NESTING];
+static __thread double resumed[MAX_NESTING];
+static __thread int depth = 0;
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static long peak_kb(void)
+{
+    struct rusage ru;
+
+    if(getrusage(RUSAGE_SELF, &ru) != 0)
+        return 0;
+    return ru.ru_maxrss; /* In kilobytes, on Linux */
+}
+
+void stats_enable(void)
+{
+    enabled = 1;
+}
+
+void stats_reset(void)
+{
+    int i;
+
+    for(i = 0; i < N_PHASES; ++i) {
+        stats[i].seconds = 0;
+        stats[i].peak_kb = 0;
+        stats[i].runs = 0;
+    }
+    depth = 0;
+}
+
+void phase_start(ml_phase p)
+{
+    double t;
+
+    if(!enabled)
+        return;
+
+    if(depth >= MAX_NESTING) {
+        fprintf(stderr, __FILE__ ":%d: phases nested too deeply\n", __LINE__);
+        exit(1);
+    }
+
+    /* The phase it interrupts is paused */
+    t = now();
+    if(depth > 0)
+        stats[running[depth-1]].seconds += t - resumed[depth-1];
+
+    running[depth] = p;
+    resumed[depth++] = t;
+}
+
+void phase_end(ml_phase p)
+{
+    double t;
+
+    if(!enabled)
+        return;
+
+    if(depth == 0 || running[depth-1] != p) {
+        fprintf(stderr, __FILE__ ":%d: phase %s ended out of turn\n",
+                __LINE__, phase_names[p]);
+        exit(1);
+    }
+
+    t = now();
+    --depth;
+    stats[p].seconds += t - resumed[depth];
+    stats[p].peak_kb = peak_kb();
+    ++stats[p].runs;
+
+    if(depth > 0)
+        resumed[depth-1] = t;
+}
+
+const phase_stats_t * phase_stats(ml_phase p)
+{
+    return &stats[p];
+}
+
+const char * phase_name(ml_phase p)
+{
+    return phase_names[p];
+}
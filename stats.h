@@ -0,0 +1,47 @@
+/*
+ * stats.h: Timing the phases of lexer generation (see --stats).
+ *
+ * Copyright © 2012 Zachary Catlin. See LICENSE for terms.
+ */
+
+#ifndef ML_STATS_H
+#define ML_STATS_H
+
+typedef enum {
+    PHASE_PARSE,   /* Reading the spec */
+    PHASE_NFA,     /* Building the NFA */
+    PHASE_CLOSURE, /* Computing the NFA's nil-closures */
+    PHASE_DFA,     /* Determinization (and minimization, caching) */
+    PHASE_EMIT,    /* Writing the lexer out */
+    N_PHASES
+} ml_phase;
+
+/* What was spent on a phase: its wall-clock time, and the peak memory use of
+ * the whole process (in kilobytes) when it last ended */
+typedef struct {
+    double seconds;
+    long peak_kb;
+    int runs;
+} phase_stats_t;
+
+/* Turns timing on; until it is, phase_start and phase_end do nothing */
+void stats_enable(void);
+
+/* Forgets the phases the calling thread has timed so far */
+void stats_reset(void);
+
+/*
+ * Marks the start and end of a run of phase p. Phases may nest (up to a few
+ * deep), in which case the time of the inner phase isn't counted in the outer
+ * one. Each thread's phases are timed apart from the others', and
+ * phase_stats gives the calling thread's.
+ */
+void phase_start(ml_phase p);
+void phase_end(ml_phase p);
+
+const phase_stats_t * phase_stats(ml_phase p);
+
+/* The name of p, as used in reports */
+const char * phase_name(ml_phase p);
+
+#endif
@@ -25,19 +25,656 @@
 #include "fa.h"
 #endif
 
+#ifndef ML_PHASH_H
+#include "phash.h"
+#endif
+
 typedef struct {
     FILE *f;
     lexer_lexer_state *st;
-    fa_t *dfa;
+    fa_t *dfa;        /* NULL when the lexer is lazy */
+    fa_t *nfa;        /* The NFA (without nil-transitions) a lazy lexer
+                       * builds its DFA from, or NULL */
+    int lazy_cache;   /* Number of DFA states a lazy lexer caches */
+    const char *mlt;  /* The .mlt file the lexer loads its tables from (with
+                       * dfa NULL), or NULL if they're compiled in */
+    int profile;      /* Whether the lexer counts its work (%option profile) */
+    int no_backup;    /* Whether no state of dfa needs backing up from (see
+                       * fa_backup_states) */
     fa_list_t *patterns;
     fa_list_t *start_states;
 } tmpl_state;
 
+/* Writes what a %NAME% in a template stands for, to t->f */
+typedef void (*tmpl_hook_fn)(tmpl_state *t);
+
+/* One step in writing out a template: copying the len bytes of its literal
+ * text from start on, or (if hook isn't NULL) running hook */
+typedef struct {
+    size_t start, len;
+    tmpl_hook_fn hook;
+} tmpl_op_t;
+
+/* A template, parsed once (by the Template lexer) into the steps to write it
+ * out, so it can be written out for a lexer without being parsed again. The
+ * template's contents are kept mapped, and its literal text copied straight
+ * from them: src should be filled in, and lexed all of a piece, after
+ * init_tmpl_prog. */
+typedef struct {
+    file_map_t src;
+    size_t pos; /* How much of src has been lexed */
+    tmpl_op_t *ops;
+    int n_ops, ops_size;
+} tmpl_prog_t;
+
+void init_tmpl_prog(tmpl_prog_t *p);
+void free_tmpl_prog(tmpl_prog_t *p);
 
+/* Writes out the template p for the lexer described by t, to t->f */
+void run_tmpl_prog(const tmpl_prog_t *p, tmpl_state *t);
 
 
 #include <stdlib.h>
 
+typedef struct yy_Template_state Template_state;
+
+Template_state * TemplateInit( void * (*alloc)(size_t),
+    void (*unalloc)(void *) );
+void TemplateDestroy( Template_state *lexer );
+int TemplateRead( Template_state *lexer, char *input, size_t len ,  tmpl_prog_t *  data );
+#if 0 || YY_PROFILE
+#include <stdio.h>
+void TemplateDumpProfile( Template_state *lexer, FILE *f );
+#endif
+#if YY_TRACE
+#include <stdio.h>
+unsigned long long TemplateLatencyPercentile( Template_state *lexer,
+    double p );
+void TemplateDumpLatency( Template_state *lexer, FILE *f );
+#endif
+
+
+#ifndef ML_STRING_H
+#define ML_STRING_H
+#include <string.h>
+#endif
+
+/* Writes the yyml_fa entries for the states of fa */
+static void write_fa_states(FILE *f, const fa_t *fa)
+{
+    state_t *s;
+    trans_t *t;
+    int i = 0;
+    int is_first = 1;
+
+    for(s = fa->first; s != NULL; s = s->next) {
+        fprintf(f, "%s\n {%d, %d, ", is_first ? "" : ",", s->done_num, i);
+        is_first = 0;
+        for(t = s->trans; t != NULL; t = t->next)
+            ++i;
+        fprintf(f, "%d}", i);
+    }
+    fputs("\n", f);
+}
+
+/* Puts the digits of n (which is at least 0) at p, returning their end */
+static char * put_digits(char *p, int n)
+{
+    char digits[16];
+    int i = 0;
+
+    do {
+        digits[i++] = '0' + n % 10;
+        n /= 10;
+    } while(n > 0);
+
+    while(i > 0)
+        *p++ = digits[--i];
+    return p;
+}
+
+/* Writes the yyml_trans entries for the transitions of fa. There can be a
+ * great many, so each is put together in line and written in one go. */
+static void write_fa_trans(FILE *f, const fa_t *fa)
+{
+    state_t *s;
+    trans_t *t;
+    const unsigned int *cond;
+    char line[256], *p;
+    int is_first = 1, i, j, val;
+
+    for(s = fa->first; s != NULL; s = s->next) {
+        for(t = s->trans; t != NULL; t = t->next) {
+            p = line;
+            if(!is_first)
+                *p++ = ',';
+            is_first = 0;
+            memcpy(p, "\n { {", 5);
+            p += 5;
+
+            cond = fa_cond(fa, t);
+            for(i = 0; i < 256; i += 8) {
+                val = 0;
+                for(j = 0; j < 8; ++j) {
+                    if(cond[(i+j)/ML_UINT_BIT] &
+                       (1 << ((i+j)%ML_UINT_BIT)))
+                    val |= 1 << j;
+                }
+                p = put_digits(p, val);
+                if(i < 248)
+                    *p++ = ',';
+            }
+
+            memcpy(p, "}, ", 3);
+            p = put_digits(p + 3, t->dest->id);
+            memcpy(p, " }", 2);
+            fwrite(line, 1, p + 2 - line, f);
+        }
+    }
+
+    fputs("\n", f);
+}
+
+/* Writes the keyword tables of a lexer with %keywords: the keywords (with
+ * the done_num of their patterns), the perfect hash finding them, and which
+ * patterns have keywords at all */
+static void write_kw_tables(FILE *f, const lexer_lexer_state *st,
+                            const fa_list_t *patterns)
+{
+    const pat_entry_t *p;
+    const fa_list_t *l;
+    const kw_entry_t *kw;
+    int n = 0, n_pats = 0, i, j, *rules;
+    len_string **words;
+    phash_t *ph;
+
+    for(p = st->phead; p != NULL; p = p->next) {
+        ++n_pats;
+        for(kw = p->keywords; kw != NULL; kw = kw->next)
+            ++n;
+    }
+
+    rules = malloc_or_die(n, int);
+    words = malloc_or_die(n, len_string *);
+
+    for(i = 0, p = st->phead, l = patterns; p != NULL;
+        p = p->next, l = l->next) {
+        for(kw = p->keywords; kw != NULL; kw = kw->next) {
+            rules[i] = l->done_num;
+            words[i++] = kw->word;
+        }
+    }
+
+    ph = mk_phash(n, rules, words);
+
+    fprintf(f, "#define YY_KW_BUCKETS %d\n", ph->n_buckets);
+    fprintf(f, "#define YY_KW_SLOTS %d\n", ph->n_slots);
+    fprintf(f, "#define YY_KW_FIRST_ACTION %d\n\n", n_pats + 1);
+
+    fputs("static const char * const yy_kw_words[] = {", f);
+    for(i = 0; i < n; ++i) {
+        fputs((i > 0) ? ",\n \"" : "\n \"", f);
+        for(j = 0; j < words[i]->len; ++j)
+            fprintf(f, "\\%03o", 0xff & words[i]->s[j]);
+        fputc('"', f);
+    }
+    fputs("\n};\n\nstatic const int yy_kw_lens[] = {", f);
+    for(i = 0; i < n; ++i)
+        fprintf(f, "%s%d", (i % 16 == 0) ? ((i > 0) ? ",\n " : "\n ") : ", ",
+                (int) words[i]->len);
+    fputs("\n};\n\nstatic const int yy_kw_rules[] = {", f);
+    for(i = 0; i < n; ++i)
+        fprintf(f, "%s%d", (i % 16 == 0) ? ((i > 0) ? ",\n " : "\n ") : ", ",
+                rules[i]);
+    fputs("\n};\n\nstatic const unsigned long yy_kw_disp[] = {", f);
+    for(i = 0; i < ph->n_buckets; ++i)
+        fprintf(f, "%s%lu", (i % 8 == 0) ? ((i > 0) ? ",\n " : "\n ") : ", ",
+                ph->disp[i]);
+    fputs("\n};\n\nstatic const int yy_kw_slots[] = {", f);
+    for(i = 0; i < ph->n_slots; ++i)
+        fprintf(f, "%s%d", (i % 16 == 0) ? ((i > 0) ? ",\n " : "\n ") : ", ",
+                ph->slot[i]);
+
+    /* Indexed by done_num, so starting with the 0 of "no pattern" */
+    fputs("\n};\n\nstatic const char yy_kw_has[] = {\n 0", f);
+    for(i = 1, p = st->phead; p != NULL; p = p->next, ++i)
+        fprintf(f, ",%s%d", (i % 16 == 0) ? "\n " : " ",
+                p->keywords != NULL);
+    fputs("\n};\n", f);
+
+    destroy_phash(ph);
+    free(rules);
+    free(words);
+}
+
+/* Does the pattern p apply in the start state named name? */
+static int pattern_in_state(const fa_list_t *p, const len_string *name)
+{
+    return p->data2 == NULL ||
+           lstr_in_list(name, (lstr_list_t *) p->data2);
+}
+
+/* The hooks: each writes what its %NAME% in a template stands for */
+
+static void hook_header(tmpl_state *t)
+{
+    if(t->st->header != NULL)
+        lstr_fwrite(t->st->header, t->f);
+}
+
+static void hook_top(tmpl_state *t)
+{
+    if(t->st->top != NULL)
+        lstr_fwrite(t->st->top, t->f);
+}
+
+static void hook_prefix(tmpl_state *t)
+{
+    if(t->st->prefix != NULL)
+        fprintf(t->f, "%.*s", (int) t->st->prefix->len,
+                t->st->prefix->s);
+    else
+        fputs("Lexer", t->f);
+}
+
+static void hook_fastates(tmpl_state *t)
+{
+    if(t->dfa != NULL)
+        write_fa_states(t->f, t->dfa);
+}
+
+static void hook_fatrans(tmpl_state *t)
+{
+    if(t->dfa != NULL)
+        write_fa_trans(t->f, t->dfa);
+}
+
+static void hook_fastarts(tmpl_state *t)
+{
+    fa_list_t *l;
+
+    if(t->dfa == NULL)
+        return;
+
+    for(l = t->start_states; l != NULL; l = l->next)
+        fprintf(t->f, "%s\n %d", (l == t->start_states) ? "" : ",",
+                l->state->id);
+
+    fputs("\n", t->f);
+}
+
+static void hook_lazy(tmpl_state *t)
+{
+    fputs((t->nfa != NULL) ? "1" : "0", t->f);
+}
+
+static void hook_lazy_cache(tmpl_state *t)
+{
+    fprintf(t->f, "%d", t->lazy_cache);
+}
+
+static void hook_nfastates(tmpl_state *t)
+{
+    if(t->nfa != NULL)
+        write_fa_states(t->f, t->nfa);
+}
+
+static void hook_nfatrans(tmpl_state *t)
+{
+    if(t->nfa != NULL)
+        write_fa_trans(t->f, t->nfa);
+}
+
+static void hook_nfainits(tmpl_state *t)
+{
+    fa_list_t *l, *p;
+
+    if(t->nfa == NULL)
+        return;
+
+    for(l = t->start_states; l != NULL; l = l->next) {
+        fputs("\n ", t->f);
+        for(p = t->patterns; p != NULL; p = p->next)
+            if(pattern_in_state(p, (len_string *) l->data1))
+                fprintf(t->f, "%d, ", p->state->id);
+        fprintf(t->f, "-1%s", (l->next != NULL) ? "," : "");
+    }
+
+    fputs("\n", t->f);
+}
+
+static void hook_nfastarts(tmpl_state *t)
+{
+    fa_list_t *l, *p;
+    int i = 0;
+
+    if(t->nfa == NULL)
+        return;
+
+    for(l = t->start_states; l != NULL; l = l->next) {
+        fprintf(t->f, "%s\n %d", (l == t->start_states) ? "" : ",",
+                i);
+        for(p = t->patterns; p != NULL; p = p->next)
+            if(pattern_in_state(p, (len_string *) l->data1))
+                ++i;
+        ++i;
+    }
+
+    fputs("\n", t->f);
+}
+
+static void hook_nfaclasses(tmpl_state *t)
+{
+    int map[256], i;
+
+    if(t->nfa == NULL)
+        return;
+
+    fa_byte_classes(t->nfa, map);
+    for(i = 0; i < 256; ++i)
+        fprintf(t->f, "%s%d%s", (i % 16 == 0) ? "\n " : "", map[i],
+                (i < 255) ? "," : "\n");
+}
+
+static void hook_nfa_nstates(tmpl_state *t)
+{
+    if(t->nfa != NULL)
+        fprintf(t->f, "%d", t->nfa->n_states);
+}
+
+static void hook_nfa_nclasses(tmpl_state *t)
+{
+    int map[256];
+
+    if(t->nfa != NULL)
+        fprintf(t->f, "%d", fa_byte_classes(t->nfa, map));
+}
+
+static void hook_has_keywords(tmpl_state *t)
+{
+    const pat_entry_t *p;
+
+    for(p = t->st->phead; p != NULL && p->keywords == NULL; p = p->next)
+        ;
+    fputs((p != NULL) ? "1" : "0", t->f);
+}
+
+static void hook_keyword_tables(tmpl_state *t)
+{
+    const pat_entry_t *p;
+
+    if(t->mlt != NULL)
+        return;
+
+    for(p = t->st->phead; p != NULL && p->keywords == NULL; p = p->next)
+        ;
+    if(p != NULL)
+        write_kw_tables(t->f, t->st, t->patterns);
+}
+
+static void hook_mlt(tmpl_state *t)
+{
+    fputs((t->mlt != NULL) ? "1" : "0", t->f);
+}
+
+static void hook_mlt_file(tmpl_state *t)
+{
+    const char *c;
+
+    if(t->mlt == NULL)
+        return;
+
+    fputc('"', t->f);
+    for(c = t->mlt; *c != '\0'; ++c)
+        fprintf(t->f, "\\%03o", 0xff & *c);
+    fputc('"', t->f);
+}
+
+static void hook_n_actions(tmpl_state *t)
+{
+    const pat_entry_t *p;
+    const kw_entry_t *kw;
+    int n = 0;
+
+    for(p = t->st->phead; p != NULL; p = p->next) {
+        ++n;
+        for(kw = p->keywords; kw != NULL; kw = kw->next)
+            ++n;
+    }
+    fprintf(t->f, "%d", n);
+}
+
+static void hook_profile(tmpl_state *t)
+{
+    fputs(t->profile ? "1" : "0", t->f);
+}
+
+static void hook_no_backup(tmpl_state *t)
+{
+    fputs(t->no_backup ? "1" : "0", t->f);
+}
+
+static void hook_start_state_defs(tmpl_state *t)
+{
+    fa_list_t *l;
+    int i = 0;
+
+    for(l = t->start_states; l != NULL; l = l->next)
+        fprintf(t->f, "#define YY_STATE_%.*s %d\n",
+                (int) ((len_string *) l->data1)->len,
+                ((len_string *) l->data1)->s, i++);
+
+    fprintf(t->f, "#define YY_MAXSTATE %d\n", i-1);
+    fprintf(t->f, "#define YY_INITSTATE YY_STATE_%.*s\n",
+            (int) t->st->initstate->len, t->st->initstate->s);
+}
+
+static void hook_actions(tmpl_state *t)
+{
+    fa_list_t *l;
+    len_string *code;
+    const pat_entry_t *p;
+    const kw_entry_t *kw;
+    int n = 0;
+
+    for(l = t->patterns; l != NULL; l = l->next) {
+        code = (len_string *) l->data3;
+        fprintf(t->f, "case %d: {\n%.*s\n} break;\n", l->done_num,
+                (int) code->len, code->s);
+        ++n;
+    }
+
+    /* Keywords' code is numbered on from the patterns' */
+    for(p = t->st->phead; p != NULL; p = p->next) {
+        for(kw = p->keywords; kw != NULL; kw = kw->next)
+            fprintf(t->f, "case %d: {\n%.*s\n} break;\n", ++n,
+                    (int) kw->code->len, kw->code->s);
+    }
+}
+
+static void hook_uparam(tmpl_state *t)
+{
+    len_string *p = t->st->ustate_type;
+    if(p != NULL)
+        fprintf(t->f, ", %.*s data", (int) p->len, p->s);
+}
+
+static void hook_udata(tmpl_state *t)
+{
+    if(t->st->ustate_type != NULL)
+        fputs(", data", t->f);
+}
+
+static void hook_has_udata(tmpl_state *t)
+{
+    fputs((t->st->ustate_type != NULL) ? "1" : "0", t->f);
+}
+
+static void hook_utype(tmpl_state *t)
+{
+    len_string *p = t->st->ustate_type;
+    if(p != NULL)
+        fprintf(t->f, "%.*s", (int) p->len, p->s);
+}
+
+static void hook_yyuparam(tmpl_state *t)
+{
+    len_string *p = t->st->ustate_type;
+    if(p != NULL)
+        fprintf(t->f, ", %.*s yydata", (int) p->len, p->s);
+}
+
+/* Returns a new step at the end of p */
+static tmpl_op_t * add_op(tmpl_prog_t *p)
+{
+    tmpl_op_t *ops;
+    int i;
+
+    if(p->n_ops == p->ops_size) {
+        p->ops_size = (p->ops_size > 0) ? 2 * p->ops_size : 64;
+        ops = malloc_or_die(p->ops_size, tmpl_op_t);
+        for(i = 0; i < p->n_ops; ++i)
+            ops[i] = p->ops[i];
+        free(p->ops);
+        p->ops = ops;
+    }
+
+    return &p->ops[p->n_ops++];
+}
+
+/* Adds the next len bytes of p->src, as literal text, to p */
+static void add_text(tmpl_prog_t *p, size_t len)
+{
+    size_t start = p->pos;
+    tmpl_op_t *op = (p->n_ops > 0) ? &p->ops[p->n_ops - 1] : NULL;
+
+    p->pos += len;
+
+    /* Text right after text is copied out in one go */
+    if(op != NULL && op->hook == NULL) {
+        op->len += len;
+        return;
+    }
+
+    op = add_op(p);
+    op->start = start;
+    op->len = len;
+    op->hook = NULL;
+}
+
+/* Adds the running of hook, in place of the next len bytes of p->src, to p */
+static void add_hook(tmpl_prog_t *p, size_t len, tmpl_hook_fn hook)
+{
+    tmpl_op_t *op = add_op(p);
+
+    p->pos += len;
+
+    op->start = op->len = 0;
+    op->hook = hook;
+}
+
+void init_tmpl_prog(tmpl_prog_t *p)
+{
+    p->src.data = NULL;
+    p->src.len = 0;
+    p->src.mapped = 0;
+    p->pos = 0;
+    p->ops = NULL;
+    p->n_ops = p->ops_size = 0;
+}
+
+void free_tmpl_prog(tmpl_prog_t *p)
+{
+    unmap_file(&p->src);
+    free(p->ops);
+    init_tmpl_prog(p);
+}
+
+void run_tmpl_prog(const tmpl_prog_t *p, tmpl_state *t)
+{
+    int i;
+
+    for(i = 0; i < p->n_ops; ++i) {
+        if(p->ops[i].hook != NULL)
+            p->ops[i].hook(t);
+        else
+            fwrite(p->src.data + p->ops[i].start, 1, p->ops[i].len, t->f);
+    }
+}
+
+
+/* Whether the DFA is built bit by bit while scanning, from an embedded NFA,
+ * instead of ahead of time (see %option lazy) */
+#define YY_LAZY 0
+
+/* Whether some pattern has keywords, looked up in a perfect hash after the
+ * pattern matches (see %keywords) */
+#define YY_KEYWORDS 0
+
+/* Whether the DFA tables are loaded at run time from a .mlt file (see
+ * moonlime -b) by the runtime in mltrt.c, instead of compiled in */
+#define YY_MLT 0
+
+#define YY_HAS_UDATA 1
+
+/* Whether no DFA state without a match can be reached after one with, so that
+ * the lexer never has to back up to an earlier match (see moonlime --backup);
+ * define it as 0 when compiling the lexer to use the general scanner anyway */
+#ifndef YY_NO_BACKUP
+#define YY_NO_BACKUP 0
+#endif
+
+/* Run just before the code of each pattern (or keyword) matched, with its
+ * number; define it when compiling the lexer to count or trace tokens */
+#ifndef YY_ON_ACTION
+#define YY_ON_ACTION(done_num)
+#endif
+
+/* The number of patterns and keywords, whose actions are numbered from 1 */
+#define YY_N_ACTIONS 30
+
+/* Whether each lexer counts the matches of each pattern and keyword, and the
+ * work done to find them (see %option profile); the counts are written out
+ * by TemplateDumpProfile */
+#ifndef YY_PROFILE
+#define YY_PROFILE 0
+#endif
+
+#if YY_PROFILE
+#define YY_COUNT(counter) (++ms->counter)
+#else
+#define YY_COUNT(counter)
+#endif
+
+/* Whether each lexer notes when the bytes it's handed arrive, and keeps a
+ * histogram of how long each token waits, from its first byte's arrival to
+ * its code being run; read it with TemplateLatencyPercentile */
+#ifndef YY_TRACE
+#define YY_TRACE 0
+#endif
+
+#if YY_TRACE
+/* Run just before the code of each token, with its pattern (or keyword)
+ * number, the offsets in the input of its first byte and of the byte after
+ * it, and the time its first byte arrived */
+#ifndef YY_TRACE_TOKEN
+#define YY_TRACE_TOKEN(rule, start_offset, end_offset, ts)
+#endif
+
+/* Each power of two of nanoseconds is split into 1 << YY_TRACE_SUB_BITS
+ * buckets, so waits are known to within 1 part in 16 */
+#define YY_TRACE_SUB_BITS 4
+#define YY_TRACE_BUCKETS ((65 - YY_TRACE_SUB_BITS) << YY_TRACE_SUB_BITS)
+#endif
+
+#if YY_MLT
+#include "mltrt.h"
+
+#ifndef YY_MLT_FILE
+#define YY_MLT_FILE 
+#endif
+#endif
+
 typedef struct {
   int done_num;
   int trans_start;
@@ -49,6 +686,40 @@ typedef struct {
   int dest_state;
 } yyml_trans;
 
+#if YY_TRACE
+typedef struct {
+  unsigned long long offset; /* Of the first byte handed over by a Read */
+  unsigned long long ts;     /* When it was */
+} yytrace_arrival;
+
+typedef struct {
+  void * (*alloc)(size_t);
+  void (*unalloc)(void *);
+  unsigned long long offset;   /* Of the next token's first byte */
+  unsigned long long received; /* Bytes handed over so far */
+  /* The Reads whose bytes may not all be in tokens yet, oldest first, in a
+   * ring starting at q[q_head] */
+  yytrace_arrival *q;
+  int q_head, q_n, q_size;
+  unsigned long long n, max; /* Tokens traced, and their longest wait */
+  unsigned long hist[YY_TRACE_BUCKETS];
+} yytrace;
+#endif
+
+#if YY_MLT
+typedef struct yy_Template_state {
+  mlt_tables *tables;
+  mlt_lexer *lexer;
+  void (*unalloc)(void *);
+  void *udata; /* The user data passed to the Read in progress */
+#if YY_PROFILE
+  unsigned long yyp_hits[YY_N_ACTIONS + 1]; /* Matches of each action */
+#endif
+#if YY_TRACE
+  yytrace yyt;
+#endif
+} yyml_state;
+#else
 typedef struct yy_Template_state {
   int is_in_error;
   int curr_state; /* state of the DFA */
@@ -61,56 +732,72 @@ typedef struct yy_Template_state {
   void (*unalloc)(void *);
   char *buf;
   char start_buf[64];
+#if YY_LAZY
+  /* The cache of DFA states built so far (in one block, lz_mem) */
+  unsigned long *lz_sets; /* The NFA states in each (YY_SET_WORDS words) */
+  int *lz_next;           /* Next state on each character class, or
+                           * YY_LAZY_UNKNOWN or YY_LAZY_DEAD */
+  int *lz_done;           /* done_num of each state */
+  int *lz_chain;          /* Next state in the same hash bucket */
+  int *lz_hash;           /* First state in each hash bucket, or -1 */
+  int *lz_starts;         /* Initial state of each start state, or -1 */
+  int lz_n;               /* Number of states in the cache */
+  int lz_epoch;           /* Number of times the cache has been flushed */
+  unsigned long lz_bytes; /* Characters scanned since the last flush */
+  int lz_thrash;          /* Flushes in a row that came too soon */
+  int lz_nfa_mode;        /* Given up on the cache; simulate the NFA */
+  unsigned long *lz_cur;  /* The NFA states we're in, when simulating */
+  unsigned long *lz_work; /* Scratch set */
+  void *lz_mem;
+#endif
+#if YY_PROFILE
+  unsigned long yyp_hits[YY_N_ACTIONS + 1]; /* Matches of each action */
+  unsigned long yyp_relexed; /* Characters scanned again after backing up */
+  unsigned long yyp_grows;   /* Times buf was enlarged */
+#if YY_LAZY
+  unsigned long yyp_steps;   /* Transitions taken */
+#else
+  unsigned long *yyp_visits; /* Times each DFA state was entered */
+#endif
+#endif
+#if YY_TRACE
+  yytrace yyt;
+#endif
 } yyml_state;
+#endif
 
-typedef struct yy_Template_state Template_state;
-
+#if YY_MLT
+#elif !YY_LAZY
 static yyml_fa yy_x[] = {
 
  {0, 0, 2},
- {12, 2, 2},
- {12, 2, 10},
- {0, 10, 11},
- {0, 11, 12},
- {0, 12, 13},
- {0, 13, 14},
- {0, 14, 15},
+ {30, 2, 3},
+ {30, 3, 15},
  {0, 15, 16},
  {0, 16, 17},
- {8, 17, 17},
- {0, 17, 18},
- {0, 18, 20},
+ {0, 17, 19},
+ {0, 19, 20},
  {0, 20, 21},
  {0, 21, 22},
- {0, 22, 24},
- {0, 24, 25},
+ {0, 22, 25},
  {0, 25, 26},
  {0, 26, 27},
- {6, 27, 27},
  {0, 27, 28},
- {0, 28, 29},
- {0, 29, 30},
- {4, 30, 30},
- {0, 30, 31},
+ {0, 28, 31},
  {0, 31, 32},
  {0, 32, 33},
- {0, 33, 34},
- {0, 34, 35},
- {5, 35, 35},
+ {0, 33, 35},
  {0, 35, 36},
  {0, 36, 37},
  {0, 37, 38},
  {0, 38, 39},
  {0, 39, 40},
  {0, 40, 41},
- {1, 41, 41},
  {0, 41, 42},
  {0, 42, 43},
- {0, 43, 44},
- {0, 44, 45},
+ {0, 43, 45},
  {0, 45, 46},
  {0, 46, 47},
- {3, 47, 47},
  {0, 47, 48},
  {0, 48, 49},
  {0, 49, 50},
@@ -122,145 +809,920 @@ static yyml_fa yy_x[] = {
  {0, 55, 56},
  {0, 56, 57},
  {0, 57, 58},
- {0, 58, 59},
- {0, 59, 60},
- {0, 60, 61},
- {0, 61, 62},
- {0, 62, 63},
- {7, 63, 63},
- {0, 63, 64},
- {0, 64, 65},
+ {0, 58, 60},
+ {0, 60, 65},
  {0, 65, 66},
- {2, 66, 66},
- {0, 66, 68},
+ {0, 66, 67},
+ {0, 67, 68},
  {0, 68, 69},
  {0, 69, 70},
  {0, 70, 71},
  {0, 71, 72},
- {10, 72, 72},
  {0, 72, 73},
  {0, 73, 74},
  {0, 74, 75},
  {0, 75, 76},
  {0, 76, 77},
- {9, 77, 77},
  {0, 77, 78},
- {0, 78, 79},
- {0, 79, 80},
+ {0, 78, 80},
  {0, 80, 81},
  {0, 81, 82},
- {0, 82, 83},
- {0, 83, 84},
+ {0, 82, 84},
+ {18, 84, 84},
  {0, 84, 85},
- {11, 85, 85}
+ {0, 85, 86},
+ {0, 86, 87},
+ {0, 87, 88},
+ {0, 88, 89},
+ {0, 89, 90},
+ {0, 90, 91},
+ {0, 91, 92},
+ {0, 92, 93},
+ {0, 93, 94},
+ {0, 94, 95},
+ {2, 95, 95},
+ {0, 95, 96},
+ {0, 96, 97},
+ {0, 97, 98},
+ {0, 98, 99},
+ {0, 99, 100},
+ {0, 100, 102},
+ {0, 102, 103},
+ {0, 103, 104},
+ {0, 104, 105},
+ {0, 105, 106},
+ {0, 106, 107},
+ {7, 107, 107},
+ {0, 107, 108},
+ {0, 108, 109},
+ {0, 109, 110},
+ {0, 110, 111},
+ {0, 111, 112},
+ {0, 112, 113},
+ {0, 113, 115},
+ {0, 115, 116},
+ {0, 116, 117},
+ {0, 117, 118},
+ {0, 118, 119},
+ {0, 119, 120},
+ {0, 120, 121},
+ {0, 121, 122},
+ {0, 122, 123},
+ {0, 123, 124},
+ {0, 124, 125},
+ {0, 125, 126},
+ {0, 126, 127},
+ {0, 127, 128},
+ {0, 128, 129},
+ {0, 129, 130},
+ {0, 130, 131},
+ {0, 131, 132},
+ {0, 132, 133},
+ {0, 133, 134},
+ {0, 134, 135},
+ {0, 135, 136},
+ {0, 136, 138},
+ {0, 138, 139},
+ {0, 139, 140},
+ {0, 140, 141},
+ {0, 141, 142},
+ {0, 142, 143},
+ {0, 143, 144},
+ {0, 144, 145},
+ {0, 145, 146},
+ {26, 146, 146},
+ {0, 146, 147},
+ {28, 147, 147},
+ {0, 147, 148},
+ {0, 148, 149},
+ {0, 149, 150},
+ {0, 150, 151},
+ {0, 151, 152},
+ {0, 152, 153},
+ {0, 153, 154},
+ {1, 154, 154},
+ {0, 154, 155},
+ {0, 155, 156},
+ {0, 156, 157},
+ {0, 157, 158},
+ {0, 158, 159},
+ {0, 159, 160},
+ {0, 160, 161},
+ {0, 161, 162},
+ {0, 162, 163},
+ {0, 163, 164},
+ {0, 164, 165},
+ {0, 165, 166},
+ {3, 166, 166},
+ {0, 166, 167},
+ {0, 167, 168},
+ {25, 168, 168},
+ {0, 168, 169},
+ {24, 169, 169},
+ {0, 169, 170},
+ {0, 170, 171},
+ {5, 171, 171},
+ {0, 171, 172},
+ {0, 172, 173},
+ {0, 173, 174},
+ {0, 174, 175},
+ {0, 175, 176},
+ {0, 176, 177},
+ {0, 177, 178},
+ {0, 178, 179},
+ {0, 179, 180},
+ {0, 180, 181},
+ {0, 181, 182},
+ {0, 182, 183},
+ {0, 183, 184},
+ {0, 184, 185},
+ {21, 185, 185},
+ {0, 185, 186},
+ {0, 186, 187},
+ {6, 187, 187},
+ {4, 187, 187},
+ {0, 187, 188},
+ {0, 188, 189},
+ {0, 189, 190},
+ {0, 190, 191},
+ {19, 191, 191},
+ {0, 191, 192},
+ {11, 192, 192},
+ {0, 192, 193},
+ {0, 193, 194},
+ {10, 194, 194},
+ {0, 194, 195},
+ {0, 195, 196},
+ {0, 196, 197},
+ {0, 197, 198},
+ {0, 198, 199},
+ {29, 199, 199},
+ {0, 199, 200},
+ {27, 200, 200},
+ {0, 200, 201},
+ {0, 201, 202},
+ {0, 202, 203},
+ {12, 203, 203},
+ {9, 203, 203},
+ {0, 203, 204},
+ {0, 204, 205},
+ {22, 205, 205},
+ {20, 205, 205},
+ {0, 205, 206},
+ {0, 206, 207},
+ {0, 207, 208},
+ {8, 208, 208},
+ {13, 208, 208},
+ {0, 208, 209},
+ {0, 209, 210},
+ {0, 210, 211},
+ {0, 211, 212},
+ {0, 212, 213},
+ {0, 213, 214},
+ {14, 214, 214},
+ {0, 214, 215},
+ {16, 215, 215},
+ {0, 215, 216},
+ {15, 216, 216},
+ {0, 216, 217},
+ {0, 217, 218},
+ {0, 218, 219},
+ {17, 219, 219},
+ {0, 219, 220},
+ {0, 220, 221},
+ {23, 221, 221}
 
 };
 
 static yyml_trans yy_y[] = {
 
- { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 2 },
- { {255,255,255,255,223,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 1 },
- { {0,0,0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 77 },
- { {0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 65 },
- { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 61 },
- { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 44 },
- { {0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 37 },
- { {0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 30 },
- { {0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 11 },
- { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 3 },
- { {0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 4 },
- { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 5 },
- { {0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 6 },
- { {0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 7 },
- { {0,0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 8 },
- { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 9 },
- { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 10 },
- { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 12 },
- { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 24 },
- { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 13 },
- { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 14 },
- { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 15 },
- { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 20 },
- { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 16 },
- { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 17 },
- { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 18 },
- { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 19 },
- { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 21 },
- { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 22 },
- { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 23 },
- { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 25 },
- { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 26 },
- { {0,0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 27 },
- { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 28 },
- { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 29 },
- { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 31 },
- { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 32 },
- { {0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 33 },
- { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 34 },
- { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 35 },
- { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 36 },
- { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 38 },
- { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 39 },
- { {0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 40 },
- { {0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 41 },
- { {0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 42 },
- { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 43 },
- { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 45 },
- { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 46 },
- { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 47 },
- { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 48 },
- { {0,0,0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 49 },
- { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 50 },
- { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 51 },
- { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 52 },
- { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 53 },
- { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 54 },
- { {0,0,0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 55 },
- { {0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 56 },
- { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 57 },
- { {0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 58 },
- { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 59 },
- { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 60 },
- { {0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 62 },
- { {0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 63 },
- { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 64 },
- { {0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 71 },
- { {0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 66 },
- { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 67 },
- { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 68 },
- { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 69 },
- { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 70 },
- { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 72 },
- { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 73 },
- { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 74 },
- { {0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 75 },
- { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 76 },
- { {0,0,0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 78 },
- { {0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 79 },
- { {0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 80 },
- { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 81 },
- { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 82 },
- { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 83 },
- { {0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 84 },
- { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 85 }
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 2 },
+ { {255,255,255,255,223,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 1 },
+ { {255,255,255,255,223,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255}, 1 },
+ { {0,0,0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 14 },
+ { {0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 13 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 12 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 11 },
+ { {0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 10 },
+ { {0,0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 9 },
+ { {0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 8 },
+ { {0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 7 },
+ { {0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 6 },
+ { {0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 5 },
+ { {0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 4 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 3 },
+ { {0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 15 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 16 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 18 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 17 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 19 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 20 },
+ { {0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 21 },
+ { {0,0,0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 24 },
+ { {0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 23 },
+ { {0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 22 },
+ { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 25 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 26 },
+ { {0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 27 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 30 },
+ { {0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 29 },
+ { {0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 28 },
+ { {0,0,0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 31 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 32 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 34 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 33 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 35 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 36 },
+ { {0,0,0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 37 },
+ { {0,0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 38 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 39 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 40 },
+ { {0,0,0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 41 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 42 },
+ { {0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 44 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 43 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 45 },
+ { {0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 46 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 47 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 48 },
+ { {0,0,0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 49 },
+ { {0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 50 },
+ { {0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 51 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 52 },
+ { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 53 },
+ { {0,0,0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 54 },
+ { {0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 55 },
+ { {0,0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 56 },
+ { {0,0,0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 57 },
+ { {0,0,0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 59 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 58 },
+ { {0,0,0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 64 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 63 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 62 },
+ { {0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 61 },
+ { {0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 60 },
+ { {0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 65 },
+ { {0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 66 },
+ { {0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 67 },
+ { {0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 68 },
+ { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 69 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 70 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 71 },
+ { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 72 },
+ { {0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 73 },
+ { {0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 74 },
+ { {0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 75 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 76 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 77 },
+ { {0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 79 },
+ { {0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 78 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 80 },
+ { {0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 81 },
+ { {0,0,0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 83 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 82 },
+ { {0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 84 },
+ { {0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 85 },
+ { {0,0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 86 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 87 },
+ { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 88 },
+ { {0,0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 89 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 90 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 91 },
+ { {0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 92 },
+ { {0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 93 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 94 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 95 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 96 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 97 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 98 },
+ { {0,0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 99 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 101 },
+ { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 100 },
+ { {0,0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 102 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 103 },
+ { {0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 104 },
+ { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 105 },
+ { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 106 },
+ { {0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 107 },
+ { {0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 108 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 109 },
+ { {0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 110 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 111 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 112 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 114 },
+ { {0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 113 },
+ { {0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 115 },
+ { {0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 116 },
+ { {0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 117 },
+ { {0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 118 },
+ { {0,0,0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 119 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 120 },
+ { {0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 121 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 122 },
+ { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 123 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 124 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 125 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 126 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 127 },
+ { {0,0,0,0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 128 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 129 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 130 },
+ { {0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 131 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 132 },
+ { {0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 133 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 134 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 135 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 137 },
+ { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 136 },
+ { {0,0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 138 },
+ { {0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 139 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 140 },
+ { {0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 141 },
+ { {0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 142 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 143 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 144 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 145 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 146 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 147 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 148 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 149 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 150 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 151 },
+ { {0,0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 152 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 153 },
+ { {0,0,0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 154 },
+ { {0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 155 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 156 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 157 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 158 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 159 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 160 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 161 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 162 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 163 },
+ { {0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 164 },
+ { {0,0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 165 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 166 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 167 },
+ { {0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 168 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 169 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 170 },
+ { {0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 171 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 172 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 173 },
+ { {0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 174 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 175 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 176 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 177 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 178 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 179 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 180 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 181 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 182 },
+ { {0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 183 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 184 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 185 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 186 },
+ { {0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 187 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 188 },
+ { {0,0,0,0,0,0,0,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 189 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 190 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 191 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 192 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 193 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 194 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 195 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 196 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 197 },
+ { {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 198 },
+ { {0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 199 },
+ { {0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 200 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 201 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 202 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 203 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 204 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 205 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 206 },
+ { {0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 207 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 208 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 209 },
+ { {0,0,0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 210 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 211 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 212 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 213 },
+ { {0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 214 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 215 },
+ { {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 216 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 217 },
+ { {0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 218 },
+ { {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 219 },
+ { {0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, 220 }
+
+};
+
+static int yy_init_states[] = {
+
+ 0
+
+};
+#else
+static yyml_fa yy_nx[] = {
+
+};
+
+static yyml_trans yy_ny[] = {
+
+};
+
+/* The NFA states each start state begins in, as -1-terminated lists */
+static int yy_nfa_inits[] = {
+
+};
+
+/* Where each start state's list starts in yy_nfa_inits */
+static int yy_nfa_starts[] = {
+
+};
+
+/* The class of each character; no transition tells those in a class apart */
+static unsigned char yy_classes[256] = {
+
+};
+
+#define YY_NFA_STATES 
+#define YY_NCLASSES 
+#define YY_SET_WORDS ((YY_NFA_STATES + 31) / 32)
+
+#ifndef YY_LAZY_CACHE
+#define YY_LAZY_CACHE 1024
+#endif
+/* A flush after fewer than YY_LAZY_MIN_BYTES characters per cached state
+ * counts as thrashing; after YY_LAZY_MAX_THRASH of those in a row, the lexer
+ * stops caching and simulates the NFA directly. */
+#ifndef YY_LAZY_MIN_BYTES
+#define YY_LAZY_MIN_BYTES 10
+#endif
+#ifndef YY_LAZY_MAX_THRASH
+#define YY_LAZY_MAX_THRASH 3
+#endif
+#define YY_LAZY_HASH (2 * YY_LAZY_CACHE)
+#define YY_LAZY_UNKNOWN (-1)
+#define YY_LAZY_DEAD (-2)
+#endif
+
+#if YY_KEYWORDS && !YY_MLT
+
+#endif
+
+#if YY_TRACE
+#ifndef YY_TRACE_NOW
+#include <time.h>
+
+static unsigned long long yytrace_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* The time now, in nanoseconds */
+#define YY_TRACE_NOW() yytrace_now()
+#endif
+
+static void yytrace_init(yytrace *tr, void * (*alloc)(size_t),
+                         void (*unalloc)(void *))
+{
+    int i;
+
+    tr->alloc = alloc;
+    tr->unalloc = unalloc;
+    tr->offset = tr->received = 0;
+    tr->q = NULL;
+    tr->q_head = tr->q_n = tr->q_size = 0;
+    tr->n = tr->max = 0;
+    for(i = 0; i < YY_TRACE_BUCKETS; ++i)
+        tr->hist[i] = 0;
+}
+
+static void yytrace_free(yytrace *tr)
+{
+    if(tr->q != NULL)
+        tr->unalloc(tr->q);
+}
+
+/* Forgets the Reads all of whose bytes are in tokens already */
+static void yytrace_drop(yytrace *tr)
+{
+    while(tr->q_n > 1 &&
+          tr->q[(tr->q_head + 1) % tr->q_size].offset <= tr->offset) {
+        tr->q_head = (tr->q_head + 1) % tr->q_size;
+        --tr->q_n;
+    }
+}
+
+/* Notes the arrival of len more bytes */
+static void yytrace_arrive(yytrace *tr, size_t len)
+{
+    yytrace_arrival *q;
+    int i;
+
+    yytrace_drop(tr);
+
+    if(tr->q_n == tr->q_size) {
+        /* With no room to be had, the bytes are taken to have come with the
+         * last Read's, making their tokens seem to wait longer */
+        if((q = tr->alloc((tr->q_size ? 2 * tr->q_size : 8) *
+                          sizeof(yytrace_arrival))) == NULL) {
+            tr->received += len;
+            return;
+        }
+        for(i = 0; i < tr->q_n; ++i)
+            q[i] = tr->q[(tr->q_head + i) % tr->q_size];
+        yytrace_free(tr);
+        tr->q = q;
+        tr->q_head = 0;
+        tr->q_size = tr->q_size ? 2 * tr->q_size : 8;
+    }
+
+    q = &tr->q[(tr->q_head + tr->q_n++) % tr->q_size];
+    q->offset = tr->received;
+    q->ts = YY_TRACE_NOW();
+    tr->received += len;
+}
+
+/* Records the wait of the next token, len bytes long, matched by rule */
+static void yytrace_token(yytrace *tr, int rule, size_t len)
+{
+    unsigned long long now = YY_TRACE_NOW(), arrived, wait;
+    int e, b;
+
+    yytrace_drop(tr);
+    arrived = (tr->q_n > 0) ? tr->q[tr->q_head].ts : now;
+    wait = (now > arrived) ? now - arrived : 0;
+
+    /* Small waits have a bucket each; bigger ones share with those having
+     * the same highest YY_TRACE_SUB_BITS + 1 bits */
+    if(wait < (2ULL << YY_TRACE_SUB_BITS))
+        b = (int) wait;
+    else {
+        for(e = YY_TRACE_SUB_BITS + 1; (wait >> e) > 1; ++e)
+            ;
+        b = ((e - YY_TRACE_SUB_BITS) << YY_TRACE_SUB_BITS) +
+            (int) (wait >> (e - YY_TRACE_SUB_BITS));
+    }
+    ++tr->hist[b];
+    ++tr->n;
+    if(wait > tr->max)
+        tr->max = wait;
+
+    YY_TRACE_TOKEN(rule, tr->offset, tr->offset + len, arrived);
+    tr->offset += len;
+}
+#endif
+
+#define YY_STATE_A 0
+#define YY_MAXSTATE 0
+#define YY_INITSTATE YY_STATE_A
+
+
+#if YY_LAZY && !YY_MLT
+static void yylazy_flush(yyml_state *ms)
+{
+    int i;
+
+    for(i = 0; i < YY_LAZY_HASH; ++i)
+        ms->lz_hash[i] = -1;
+    for(i = 0; i <= YY_MAXSTATE; ++i)
+        ms->lz_starts[i] = -1;
+
+    ms->lz_n = 0;
+    ++ms->lz_epoch;
+}
+
+static int yylazy_alloc(yyml_state *ms)
+{
+    size_t n_words = (size_t) (YY_LAZY_CACHE + 2) * YY_SET_WORDS;
+    size_t n_ints = (size_t) YY_LAZY_CACHE * (YY_NCLASSES + 2) +
+                    YY_LAZY_HASH + YY_MAXSTATE + 1;
+    char *mem = ms->alloc(n_words * sizeof(unsigned long) +
+                          n_ints * sizeof(int));
+
+    if(mem == NULL)
+        return 0;
+
+    ms->lz_mem = mem;
+    ms->lz_sets = (unsigned long *) mem;
+    ms->lz_cur = ms->lz_sets + YY_LAZY_CACHE * YY_SET_WORDS;
+    ms->lz_work = ms->lz_cur + YY_SET_WORDS;
+    ms->lz_next = (int *) (ms->lz_work + YY_SET_WORDS);
+    ms->lz_done = ms->lz_next + YY_LAZY_CACHE * YY_NCLASSES;
+    ms->lz_chain = ms->lz_done + YY_LAZY_CACHE;
+    ms->lz_hash = ms->lz_chain + YY_LAZY_CACHE;
+    ms->lz_starts = ms->lz_hash + YY_LAZY_HASH;
+
+    ms->lz_epoch = 0;
+    ms->lz_bytes = 0;
+    ms->lz_thrash = 0;
+    ms->lz_nfa_mode = 0;
+    yylazy_flush(ms);
+
+    return 1;
+}
+
+/* Sets out to the NFA states reached from those in set on the character c;
+ * returns the least done_num among them (0 if none), or -1 if there are no
+ * such states at all */
+static int yylazy_step(const unsigned long *set, unsigned char c,
+                       unsigned long *out)
+{
+    int i, j, s, t, d, done_num = 0, found = 0;
+
+    for(i = 0; i < YY_SET_WORDS; ++i)
+        out[i] = 0;
+
+    for(i = 0; i < YY_SET_WORDS; ++i) {
+        if(set[i] == 0)
+            continue;
+
+        for(j = 0; j < 32; ++j) {
+            if(!(set[i] & (1UL << j)))
+                continue;
+
+            s = i * 32 + j;
+            for(t = yy_nx[s].trans_start; t < yy_nx[s].trans_end; ++t) {
+                if(!(yy_ny[t].transset[c >> 3] & (1 << (c & 7))))
+                    continue;
+
+                d = yy_ny[t].dest_state;
+                out[d / 32] |= 1UL << (d % 32);
+                found = 1;
+                if(yy_nx[d].done_num &&
+                   (done_num == 0 || yy_nx[d].done_num < done_num))
+                    done_num = yy_nx[d].done_num;
+            }
+        }
+    }
+
+    return found ? done_num : -1;
+}
+
+/* Returns the cache index of the DFA state for the NFA states in set, adding
+ * it if need be (flushing the cache first if it's full), or -1 if the cache
+ * is thrashing and the lexer has switched to simulating the NFA */
+static int yylazy_state(yyml_state *ms, const unsigned long *set,
+                        int done_num)
+{
+    unsigned long h = 2166136261UL;
+    int i, k;
+
+    for(i = 0; i < YY_SET_WORDS; ++i)
+        h = (h ^ set[i]) * 16777619UL;
+    h %= YY_LAZY_HASH;
+
+    for(k = ms->lz_hash[h]; k >= 0; k = ms->lz_chain[k]) {
+        for(i = 0; i < YY_SET_WORDS; ++i)
+            if(ms->lz_sets[k * YY_SET_WORDS + i] != set[i])
+                break;
+        if(i == YY_SET_WORDS)
+            return k;
+    }
+
+    if(ms->lz_n >= YY_LAZY_CACHE) {
+        if(ms->lz_bytes < (unsigned long) YY_LAZY_MIN_BYTES * YY_LAZY_CACHE) {
+            if(++ms->lz_thrash >= YY_LAZY_MAX_THRASH) {
+                ms->lz_nfa_mode = 1;
+                return -1;
+            }
+        } else
+            ms->lz_thrash = 0;
+
+        ms->lz_bytes = 0;
+        yylazy_flush(ms);
+    }
+
+    k = ms->lz_n++;
+    for(i = 0; i < YY_SET_WORDS; ++i)
+        ms->lz_sets[k * YY_SET_WORDS + i] = set[i];
+    for(i = 0; i < YY_NCLASSES; ++i)
+        ms->lz_next[k * YY_NCLASSES + i] = YY_LAZY_UNKNOWN;
+    ms->lz_done[k] = done_num;
+    ms->lz_chain[k] = ms->lz_hash[h];
+    ms->lz_hash[h] = k;
+
+    return k;
+}
+
+static void yylazy_swap_sets(yyml_state *ms)
+{
+    unsigned long *tmp = ms->lz_cur;
+
+    ms->lz_cur = ms->lz_work;
+    ms->lz_work = tmp;
+}
+
+/* Puts the lexer in the initial state of the start state start_state */
+static void yylazy_start(yyml_state *ms, int start_state)
+{
+    int i, k, d, done_num = 0;
+
+    if(!ms->lz_nfa_mode && ms->lz_starts[start_state] >= 0) {
+        ms->curr_state = ms->lz_starts[start_state];
+        return;
+    }
+
+    for(i = 0; i < YY_SET_WORDS; ++i)
+        ms->lz_work[i] = 0;
+
+    for(i = yy_nfa_starts[start_state]; (d = yy_nfa_inits[i]) >= 0; ++i) {
+        ms->lz_work[d / 32] |= 1UL << (d % 32);
+        if(yy_nx[d].done_num &&
+           (done_num == 0 || yy_nx[d].done_num < done_num))
+            done_num = yy_nx[d].done_num;
+    }
+
+    if(!ms->lz_nfa_mode &&
+       (k = yylazy_state(ms, ms->lz_work, done_num)) >= 0) {
+        ms->curr_state = ms->lz_starts[start_state] = k;
+        return;
+    }
+
+    yylazy_swap_sets(ms);
+}
+
+/* Moves the lexer on by the character c, building the DFA state it goes to
+ * if it isn't in the cache; returns that state's done_num, or -1 (leaving
+ * the lexer where it was) if there's no transition on c */
+static int yylazy_next(yyml_state *ms, unsigned char c)
+{
+    int from = ms->curr_state, cls = yy_classes[c], next, done_num, epoch;
+
+    ++ms->lz_bytes;
+
+    if(ms->lz_nfa_mode) {
+        if((done_num = yylazy_step(ms->lz_cur, c, ms->lz_work)) < 0)
+            return -1;
+        yylazy_swap_sets(ms);
+        return done_num;
+    }
+
+    next = ms->lz_next[from * YY_NCLASSES + cls];
+
+    if(next == YY_LAZY_UNKNOWN) {
+        done_num = yylazy_step(ms->lz_sets + from * YY_SET_WORDS, c,
+                               ms->lz_work);
+
+        if(done_num < 0)
+            next = YY_LAZY_DEAD;
+        else {
+            epoch = ms->lz_epoch;
+
+            if((next = yylazy_state(ms, ms->lz_work, done_num)) < 0) {
+                yylazy_swap_sets(ms);
+                return done_num;
+            }
+
+            if(epoch != ms->lz_epoch) { /* from was flushed */
+                ms->curr_state = next;
+                return done_num;
+            }
+        }
+
+        ms->lz_next[from * YY_NCLASSES + cls] = next;
+    }
+
+    if(next == YY_LAZY_DEAD)
+        return -1;
+
+    ms->curr_state = next;
+    return ms->lz_done[next];
+}
+#endif
+
+static void yymoonlime_action(int done_num, const char *yytext, size_t yylen,
+                              int *yy_start_state ,  tmpl_prog_t *  yydata);
+
+#if YY_KEYWORDS && !YY_MLT
+static int yykeyword(int done_num, const char *yytext, size_t yylen);
+#endif
+
+#if YY_MLT
+static void yymlt_action(int rule, const char *yytext, size_t yylen,
+                         int *start_state, void *data)
+{
+    yyml_state *ms = data;
+
+    YY_COUNT(yyp_hits[rule]);
+#if YY_TRACE
+    yytrace_token(&ms->yyt, rule, yylen);
+#endif
+#if YY_HAS_UDATA
+    yymoonlime_action(rule, yytext, yylen, start_state,
+                      *( tmpl_prog_t *  *) ms->udata);
+#else
+    (void) ms;
+    yymoonlime_action(rule, yytext, yylen, start_state);
+#endif
+}
+
+Template_state * TemplateInit( void * (*alloc)(size_t),
+    void (*unalloc)(void *) )
+{
+    yyml_state *ms;
+#if YY_PROFILE
+    int i;
+#endif
+
+    if(alloc == NULL || unalloc == NULL)
+        return NULL;
+
+    if((ms = alloc(sizeof(yyml_state))) == NULL)
+        return NULL;
+
+    ms->unalloc = unalloc;
+    ms->udata = NULL;
+    ms->lexer = NULL;
+#if YY_PROFILE
+    for(i = 0; i <= YY_N_ACTIONS; ++i)
+        ms->yyp_hits[i] = 0;
+#endif
+#if YY_TRACE
+    yytrace_init(&ms->yyt, alloc, unalloc);
+#endif
+
+    /* Tables for a different set of actions can't be used */
+    if((ms->tables = mlt_open(YY_MLT_FILE)) == NULL ||
+       mlt_n_actions(ms->tables) != YY_N_ACTIONS ||
+       mlt_n_starts(ms->tables) != YY_MAXSTATE + 1 ||
+       (ms->lexer = mlt_init(ms->tables, yymlt_action, ms, alloc,
+                             unalloc)) == NULL) {
+        mlt_close(ms->tables);
+        unalloc(ms);
+        return NULL;
+    }
+
+    return ms;
+}
+
+void TemplateDestroy( Template_state *lexer )
+{
+    yyml_state *ms = lexer;
+
+    if(ms == NULL)
+        return;
 
-};
+    mlt_destroy(ms->lexer);
+    mlt_close(ms->tables);
+#if YY_TRACE
+    yytrace_free(&ms->yyt);
+#endif
+    ms->unalloc(ms);
+}
 
-static int yy_init_states[] = {
+int TemplateRead( Template_state *lexer, char *input, size_t len ,  tmpl_prog_t *  data )
+{
+    yyml_state *ms = lexer;
 
- 0
+    if(ms == NULL)
+        return 0;
 
-};
+#if YY_HAS_UDATA
+    ms->udata = &data;
+#endif
+#if YY_TRACE
+    if(len > 0)
+        yytrace_arrive(&ms->yyt, len);
+#endif
+    return mlt_read(ms->lexer, input, len);
+}
 
-#define YY_STATE_A 0
-#define YY_MAXSTATE 0
-#define YY_INITSTATE YY_STATE_A
+#if YY_PROFILE
+/* The runtime does the scanning, so only the matches are counted */
+void TemplateDumpProfile( Template_state *lexer, FILE *f )
+{
+    yyml_state *ms = lexer;
+    int i;
 
+    if(ms == NULL)
+        return;
 
+    fputs("Template profile:\n", f);
+    for(i = 1; i <= YY_N_ACTIONS; ++i)
+        if(ms->yyp_hits[i] != 0)
+            fprintf(f, "  action %d: %lu matches\n", i, ms->yyp_hits[i]);
+}
+#endif
+#else
 Template_state * TemplateInit( void * (*alloc)(size_t),
     void (*unalloc)(void *) )
 {
     yyml_state *ms;
+#if YY_PROFILE
+    int i;
+#if !YY_LAZY
+    int n_states;
+#endif
+#endif
 
     if(alloc == NULL || unalloc == NULL)
         return NULL;
@@ -270,8 +1732,30 @@ Template_state * TemplateInit( void * (*alloc)(size_t),
     if(ms == NULL)
         return NULL;
 
+    ms->alloc = alloc;
+    ms->unalloc = unalloc;
+
+#if YY_PROFILE
+    for(i = 0; i <= YY_N_ACTIONS; ++i)
+        ms->yyp_hits[i] = 0;
+    ms->yyp_relexed = ms->yyp_grows = 0;
+#if YY_LAZY
+    ms->yyp_steps = 0;
+#else
+    n_states = sizeof(yy_x) / sizeof(yy_x[0]);
+    if((ms->yyp_visits = alloc(n_states * sizeof(unsigned long))) == NULL) {
+        unalloc(ms);
+        return NULL;
+    }
+    for(i = 0; i < n_states; ++i)
+        ms->yyp_visits[i] = 0;
+#endif
+#endif
+#if YY_TRACE
+    yytrace_init(&ms->yyt, alloc, unalloc);
+#endif
+
     ms->is_in_error = 0;
-    ms->curr_state = yy_init_states[YY_INITSTATE];
     ms->curr_start_state = YY_INITSTATE;
     ms->last_done_num = 0;
     ms->last_done_len = 0;
@@ -280,8 +1764,15 @@ Template_state * TemplateInit( void * (*alloc)(size_t),
     ms->curr_buf_size = 64;
     ms->buf = ms->start_buf;
 
-    ms->alloc = alloc;
-    ms->unalloc = unalloc;
+#if YY_LAZY
+    if(!yylazy_alloc(ms)) {
+        unalloc(ms);
+        return NULL;
+    }
+    yylazy_start(ms, YY_INITSTATE);
+#else
+    ms->curr_state = yy_init_states[YY_INITSTATE];
+#endif
 
     return ms;
 }
@@ -297,16 +1788,47 @@ void TemplateDestroy( Template_state *lexer )
         ms->unalloc(ms->buf);
     }
 
+#if YY_LAZY
+    ms->unalloc(ms->lz_mem);
+#endif
+#if YY_PROFILE && !YY_LAZY
+    ms->unalloc(ms->yyp_visits);
+#endif
+#if YY_TRACE
+    yytrace_free(&ms->yyt);
+#endif
+
     ms->unalloc(ms);
 }
 
-static void yymoonlime_action(int done_num, const char *yytext, size_t yylen,
-                              int *yy_start_state ,  tmpl_state *  yydata);
-
-static int yyrun_char(yyml_state *ms, char c, int add_to_buf, int len)
+/* Adds c to the text of the token being scanned */
+static int yyadd_char(yyml_state *ms, char c)
 {
-    int curr_trans, end_trans, c_idx, c_mask, next_state, i;
     char *new_buf;
+    int i;
+
+    if(ms->string_len >= ms->curr_buf_size - 1) {
+        if((new_buf = ms->alloc(ms->curr_buf_size * 2)) == NULL) {
+            ms->is_in_error = 1;
+            return 0;
+        }
+        YY_COUNT(yyp_grows);
+        for(i = 0; i < ms->string_len; ++i)
+            new_buf[i] = ms->buf[i];
+        ms->curr_buf_size *= 2;
+        if(ms->buf != ms->start_buf)
+            ms->unalloc(ms->buf);
+        ms->buf = new_buf;
+    }
+    ms->buf[ms->string_len++] = c;
+    return 1;
+}
+
+#if YY_NO_BACKUP
+/* Takes the DFA's transition on c, if it has one, adding c to the token */
+static int yystep(yyml_state *ms, char c)
+{
+    int curr_trans, end_trans, c_idx, c_mask;
 
     curr_trans = yy_x[ms->curr_state].trans_start;
     end_trans = yy_x[ms->curr_state].trans_end;
@@ -314,25 +1836,55 @@ static int yyrun_char(yyml_state *ms, char c, int add_to_buf, int len)
     c_idx = ((unsigned char) c) >> 3;
     c_mask = 1 << (c & 7);
 
-    if(add_to_buf) {
-        if(ms->string_len >= ms->curr_buf_size - 1) {
-                if((new_buf = ms->alloc(ms->curr_buf_size * 2)) == NULL) {
-                    ms->is_in_error = 1;
+    while(curr_trans < end_trans) {
+        if(yy_y[curr_trans].transset[c_idx] & c_mask) {
+            if(!yyadd_char(ms, c))
                 return 0;
-            }
-            for(i = 0; i < ms->string_len; ++i)
-                new_buf[i] = ms->buf[i];
-            ms->curr_buf_size *= 2;
-            if(ms->buf != ms->start_buf)
-                ms->unalloc(ms->buf);
-            ms->buf = new_buf;
+            ms->curr_state = yy_y[curr_trans].dest_state;
+            YY_COUNT(yyp_visits[ms->curr_state]);
+            return 1;
         }
-        ms->buf[ms->string_len++] = c;
+        ++curr_trans;
+    }
+
+    return 0;
+}
+#else
+static int yyrun_char(yyml_state *ms, char c, int add_to_buf, int len)
+{
+#if YY_LAZY
+    int done_num;
+#else
+    int curr_trans, end_trans, c_idx, c_mask, next_state;
+#endif
+
+    if(add_to_buf) {
+        if(!yyadd_char(ms, c))
+            return 0;
+    } else
+        YY_COUNT(yyp_relexed);
+
+#if YY_LAZY
+    if((done_num = yylazy_next(ms, (unsigned char) c)) < 0)
+        return 0;
+    YY_COUNT(yyp_steps);
+
+    if(done_num) {
+        ms->last_done_num = done_num;
+        ms->last_done_len = len;
     }
+    return 1;
+#else
+    curr_trans = yy_x[ms->curr_state].trans_start;
+    end_trans = yy_x[ms->curr_state].trans_end;
+
+    c_idx = ((unsigned char) c) >> 3;
+    c_mask = 1 << (c & 7);
 
     while(curr_trans < end_trans) {
         if(yy_y[curr_trans].transset[c_idx] & c_mask) {
             ms->curr_state = next_state = yy_y[curr_trans].dest_state;
+            YY_COUNT(yyp_visits[next_state]);
 
             if(yy_x[next_state].done_num) {
                 ms->last_done_num = yy_x[next_state].done_num;
@@ -344,7 +1896,9 @@ static int yyrun_char(yyml_state *ms, char c, int add_to_buf, int len)
     }
 
     return 0;
+#endif
 }
+#endif
 
 static void yyreset_state(yyml_state *ms)
 {
@@ -354,10 +1908,82 @@ static void yyreset_state(yyml_state *ms)
         ms->buf[i - ms->last_done_len] = ms->buf[i];
     ms->string_len -= ms->last_done_len;
     ms->last_done_len = ms->last_done_num = 0;
+#if YY_LAZY
+    yylazy_start(ms, ms->curr_start_state);
+#else
     ms->curr_state = yy_init_states[ms->curr_start_state];
+#endif
+}
+
+/* Runs the code of the longest match found, and starts scanning again just
+ * after it */
+static void yyaccept(yyml_state *ms ,  tmpl_prog_t *  data)
+{
+    int done_num = ms->last_done_num;
+
+#if YY_KEYWORDS
+    done_num = yykeyword(done_num, ms->buf, ms->last_done_len);
+#endif
+    YY_COUNT(yyp_hits[done_num]);
+#if YY_TRACE
+    yytrace_token(&ms->yyt, done_num, ms->last_done_len);
+#endif
+
+    yymoonlime_action(done_num, ms->buf, ms->last_done_len,
+                      &(ms->curr_start_state) , data);
+    yyreset_state(ms);
 }
 
-int TemplateRead( Template_state *lexer, char *input, size_t len ,  tmpl_state *  data )
+#if YY_NO_BACKUP
+/* With no backing up, the longest match is the one the DFA is in when it
+ * has no transition on the next character, and no character is scanned
+ * twice */
+int TemplateRead( Template_state *lexer, char *input, size_t len ,  tmpl_prog_t *  data )
+{
+    char *end = input + len;
+    yyml_state *ms = lexer;
+
+    if(ms == NULL || ms->is_in_error)
+        return 0;
+
+#if YY_TRACE
+    if(len > 0)
+        yytrace_arrive(&ms->yyt, len);
+#endif
+
+    while(input < end) {
+        if(!yystep(ms, *input)) {
+            if(ms->is_in_error)
+                return 0;
+            if(ms->string_len == 0 || !yy_x[ms->curr_state].done_num) {
+                ms->is_in_error = 1; /* no pattern matches buf */
+                return 0;
+            }
+
+            /* *input starts the next token */
+            ms->last_done_num = yy_x[ms->curr_state].done_num;
+            ms->last_done_len = ms->string_len;
+            yyaccept(ms , data);
+            continue;
+        }
+        ++input;
+    }
+
+    if(len == 0 && ms->string_len > 0) { /* Signifies EOF */
+        if(!yy_x[ms->curr_state].done_num) {
+            ms->is_in_error = 1;
+            return 0;
+        }
+
+        ms->last_done_num = yy_x[ms->curr_state].done_num;
+        ms->last_done_len = ms->string_len;
+        yyaccept(ms , data);
+    }
+
+    return 1;
+}
+#else
+int TemplateRead( Template_state *lexer, char *input, size_t len ,  tmpl_prog_t *  data )
 {
     int done_relexing, i;
     char *end = input + len;
@@ -366,6 +1992,11 @@ int TemplateRead( Template_state *lexer, char *input, size_t len ,  tmpl_state *
     if(ms == NULL || ms->is_in_error)
         return 0;
 
+#if YY_TRACE
+    if(len > 0)
+        yytrace_arrive(&ms->yyt, len);
+#endif
+
     if(len == 0) { /* Signifies EOF */
         if(ms->string_len == 0)
             return 1;
@@ -375,9 +2006,7 @@ int TemplateRead( Template_state *lexer, char *input, size_t len ,  tmpl_state *
             return 0;
         }
 
-        yymoonlime_action(ms->last_done_num, ms->buf, ms->last_done_len,
-                          &(ms->curr_start_state) , data);
-        yyreset_state(ms);
+        yyaccept(ms , data);
 
         while(ms->string_len > 0) {
             for(i = 0; i < ms->string_len; ++i) {
@@ -388,10 +2017,7 @@ int TemplateRead( Template_state *lexer, char *input, size_t len ,  tmpl_state *
                         return 0;
                     }
 
-                    yymoonlime_action(ms->last_done_num, ms->buf,
-                                      ms->last_done_len,
-                                      &(ms->curr_start_state) , data);
-                    yyreset_state(ms);
+                    yyaccept(ms , data);
                     break;
                 }
             }
@@ -408,9 +2034,7 @@ int TemplateRead( Template_state *lexer, char *input, size_t len ,  tmpl_state *
                 ms->is_in_error = 1;
                 return 0;
             }
-            yymoonlime_action(ms->last_done_num, ms->buf, ms->last_done_len,
-                              &(ms->curr_start_state) , data);
-            yyreset_state(ms);
+            yyaccept(ms , data);
 
             /* Re-lex remaining part of the buffer */
             done_relexing = 0;
@@ -423,10 +2047,7 @@ int TemplateRead( Template_state *lexer, char *input, size_t len ,  tmpl_state *
                         if(ms->is_in_error)
                             return 0;
 
-                        yymoonlime_action(ms->last_done_num, ms->buf,
-                                          ms->last_done_len,
-                                          &(ms->curr_start_state) , data);
-                        yyreset_state(ms);
+                        yyaccept(ms , data);
                         i = 0;
                         continue;
                     }
@@ -442,141 +2063,226 @@ int TemplateRead( Template_state *lexer, char *input, size_t len ,  tmpl_state *
 
     return 1;
 }
+#endif
 
-#define YYSTART(x) do { *yy_start_state = YY_STATE_ ## x ; } while(0)
-
-static void yymoonlime_action(int done_num, const char *yytext, size_t yylen,
-                              int *yy_start_state ,  tmpl_state *  yydata)
+#if YY_PROFILE
+void TemplateDumpProfile( Template_state *lexer, FILE *f )
 {
-    switch(done_num) {
-case 1: {
+    yyml_state *ms = lexer;
+    int i;
 
-    if(yydata->st->header != NULL)
-        fprintf(yydata->f, "%.*s", (int) yydata->st->header->len,
-                yydata->st->header->s);
+    if(ms == NULL)
+        return;
 
-} break;
-case 2: {
+    fputs("Template profile:\n", f);
+    for(i = 1; i <= YY_N_ACTIONS; ++i)
+        if(ms->yyp_hits[i] != 0)
+            fprintf(f, "  action %d: %lu matches\n", i, ms->yyp_hits[i]);
+
+    fprintf(f, "  characters re-scanned after backing up: %lu\n"
+               "  buffer enlargements: %lu\n", ms->yyp_relexed,
+            ms->yyp_grows);
+
+#if YY_LAZY
+    /* The cache is first flushed when it's set up */
+    fprintf(f, "  transitions: %lu (%d cache flushes)\n", ms->yyp_steps,
+            ms->lz_epoch - 1);
+#else
+    for(i = 0; i < (int) (sizeof(yy_x) / sizeof(yy_x[0])); ++i)
+        if(ms->yyp_visits[i] != 0)
+            fprintf(f, "  DFA state %d: %lu visits\n", i, ms->yyp_visits[i]);
+#endif
+}
+#endif
+#endif
 
-    if(yydata->st->top != NULL)
-        fprintf(yydata->f, "%.*s", (int) yydata->st->top->len,
-                yydata->st->top->s);
+#if YY_TRACE
+unsigned long long TemplateLatencyPercentile( Template_state *lexer,
+    double p )
+{
+    yyml_state *ms = lexer;
+    unsigned long long want, seen = 0, high;
+    int b, e, m;
 
-} break;
-case 3: {
+    if(ms == NULL || ms->yyt.n == 0)
+        return 0;
 
-    if(yydata->st->prefix != NULL)
-        fprintf(yydata->f, "%.*s", (int) yydata->st->prefix->len,
-                yydata->st->prefix->s);
-    else
-        fputs("Lexer", yydata->f);
+    want = (unsigned long long) (p * ms->yyt.n + 0.5);
+    if(want < 1)
+        want = 1;
+
+    for(b = 0; b < YY_TRACE_BUCKETS; ++b) {
+        if((seen += ms->yyt.hist[b]) < want)
+            continue;
+
+        /* The longest wait that goes in bucket b (see yytrace_token) */
+        if(b < (2 << YY_TRACE_SUB_BITS))
+            high = b;
+        else {
+            e = (b >> YY_TRACE_SUB_BITS) - 1;
+            m = (b & ((1 << YY_TRACE_SUB_BITS) - 1)) + (1 << YY_TRACE_SUB_BITS);
+            high = ((m + 1ULL) << e) - 1;
+        }
+        return (high < ms->yyt.max) ? high : ms->yyt.max;
+    }
 
-} break;
-case 4: {
+    return ms->yyt.max;
+}
 
-    state_t *s;
-    trans_t *t;
-    int i = 0;
-    int is_first = 1;
+void TemplateDumpLatency( Template_state *lexer, FILE *f )
+{
+    yyml_state *ms = lexer;
 
-    for(s = yydata->dfa->first; s != NULL; s = s->next) {
-        fprintf(yydata->f, "%s\n {%d, %d, ", is_first ? "" : ",",
-                s->done_num, i);
-        is_first = 0;
-        for(t = s->trans; t != NULL; t = t->next)
-            ++i;
-        fprintf(yydata->f, "%d}", i);
-    }
-    fputs("\n", yydata->f);
+    if(ms == NULL)
+        return;
 
-} break;
-case 5: {
+    fprintf(f, "Template token latency: %llu tokens; p50 %llu ns, "
+               "p99 %llu ns, p99.9 %llu ns, max %llu ns\n", ms->yyt.n,
+            TemplateLatencyPercentile(lexer, 0.5),
+            TemplateLatencyPercentile(lexer, 0.99),
+            TemplateLatencyPercentile(lexer, 0.999), ms->yyt.max);
+}
+#endif
 
-    state_t *s;
-    trans_t *t;
-    int is_first = 1, i, j, val;
+#if YY_KEYWORDS && !YY_MLT
+/* Must be kept in step with phash_fn() in Moonlime's phash.c */
+static unsigned long yykw_hash(int rule, const char *s, size_t len,
+                               unsigned long seed)
+{
+  unsigned long h = (2166136261UL + seed * 2654435761UL +
+                     (unsigned long) rule) & 0xffffffffUL;
+  size_t i;
 
-    for(s = yydata->dfa->first; s != NULL; s = s->next) {
-        for(t = s->trans; t != NULL; t = t->next) {
-            fprintf(yydata->f, "%s\n { {", is_first ? "" : ",");
-            is_first = 0;
-            for(i = 0; i < 256; i += 8) {
-                val = 0;
-                for(j = 0; j < 8; ++j) {
-                    if(t->cond[(i+j)/ML_UINT_BIT] &
-                       (1 << ((i+j)%ML_UINT_BIT)))
-                    val |= 1 << j;
-                }
-                fprintf(yydata->f, "%d%s", val, (i < 248) ? "," : "");
-            }
-            fprintf(yydata->f, "}, %d }", t->dest->id);
-        }
-    }
+  for(i = 0; i < len; ++i)
+    h = ((h ^ (0xff & (unsigned long) s[i])) * 16777619UL) & 0xffffffffUL;
 
-    fputs("\n", yydata->f);
+  return h;
+}
 
-} break;
-case 6: {
+/* If the text matched by pattern done_num is one of its keywords, returns the
+ * number of the keyword's action; otherwise, returns done_num. */
+static int yykeyword(int done_num, const char *yytext, size_t yylen)
+{
+  unsigned long b;
+  int k;
+  size_t i;
 
-    fa_list_t *l;
+  if(!yy_kw_has[done_num])
+    return done_num;
 
-    for(l = yydata->start_states; l != NULL; l = l->next)
-        fprintf(yydata->f, "%s\n %d", (l == yydata->start_states) ? "" : ",",
-                l->state->id);
+  b = yykw_hash(done_num, yytext, yylen, 0) % YY_KW_BUCKETS;
+  k = yy_kw_slots[yykw_hash(done_num, yytext, yylen, yy_kw_disp[b]) %
+                  YY_KW_SLOTS];
 
-    fputs("\n", yydata->f);
+  if(k < 0 || yy_kw_rules[k] != done_num || yy_kw_lens[k] != (int) yylen)
+    return done_num;
 
-} break;
-case 7: {
+  for(i = 0; i < yylen; ++i)
+    if(yy_kw_words[k][i] != yytext[i])
+      return done_num;
 
-    fa_list_t *l;
-    int i = 0;
+  return YY_KW_FIRST_ACTION + k;
+}
+#endif
 
-    for(l = yydata->start_states; l != NULL; l = l->next)
-        fprintf(yydata->f, "#define YY_STATE_%.*s %d\n",
-                (int) ((len_string *) l->data1)->len,
-                ((len_string *) l->data1)->s, i++);
+#define YYSTART(x) do { *yy_start_state = YY_STATE_ ## x ; } while(0)
 
-    fprintf(yydata->f, "#define YY_MAXSTATE %d\n", i-1);
-    fprintf(yydata->f, "#define YY_INITSTATE YY_STATE_%.*s\n",
-            (int) yydata->st->initstate->len, yydata->st->initstate->s);
+static void yymoonlime_action(int done_num, const char *yytext, size_t yylen,
+                              int *yy_start_state ,  tmpl_prog_t *  yydata)
+{
+    YY_ON_ACTION(done_num);
 
+    switch(done_num) {
+case 1: {
+ add_hook(yydata, yylen, hook_header); 
+} break;
+case 2: {
+ add_hook(yydata, yylen, hook_top); 
+} break;
+case 3: {
+ add_hook(yydata, yylen, hook_prefix); 
+} break;
+case 4: {
+ add_hook(yydata, yylen, hook_fastates); 
+} break;
+case 5: {
+ add_hook(yydata, yylen, hook_fatrans); 
+} break;
+case 6: {
+ add_hook(yydata, yylen, hook_fastarts); 
+} break;
+case 7: {
+ add_hook(yydata, yylen, hook_lazy); 
 } break;
 case 8: {
-
-    fa_list_t *l;
-    len_string *code;
-
-    for(l = yydata->patterns; l != NULL; l = l->next) {
-        code = (len_string *) l->data3;
-        fprintf(yydata->f, "case %d: {\n%.*s\n} break;\n", l->done_num,
-                (int) code->len, code->s);
-    }
-
+ add_hook(yydata, yylen, hook_lazy_cache); 
 } break;
 case 9: {
-
-    len_string *p = yydata->st->ustate_type;
-    if(p != NULL)
-        fprintf(yydata->f, ", %.*s data", (int) p->len, p->s);
-
+ add_hook(yydata, yylen, hook_nfastates); 
 } break;
 case 10: {
-
-    if(yydata->st->ustate_type != NULL)
-        fputs(", data", yydata->f);
-
+ add_hook(yydata, yylen, hook_nfatrans); 
 } break;
 case 11: {
-
-    len_string *p = yydata->st->ustate_type;
-    if(p != NULL)
-        fprintf(yydata->f, ", %.*s yydata", (int) p->len, p->s);
-
+ add_hook(yydata, yylen, hook_nfainits); 
 } break;
 case 12: {
+ add_hook(yydata, yylen, hook_nfastarts); 
+} break;
+case 13: {
+ add_hook(yydata, yylen, hook_nfaclasses); 
+} break;
+case 14: {
+ add_hook(yydata, yylen, hook_nfa_nstates); 
+} break;
+case 15: {
+ add_hook(yydata, yylen, hook_nfa_nclasses); 
+} break;
+case 16: {
+ add_hook(yydata, yylen, hook_has_keywords); 
+} break;
+case 17: {
+ add_hook(yydata, yylen, hook_keyword_tables); 
+} break;
+case 18: {
+ add_hook(yydata, yylen, hook_mlt); 
+} break;
+case 19: {
+ add_hook(yydata, yylen, hook_mlt_file); 
+} break;
+case 20: {
+ add_hook(yydata, yylen, hook_n_actions); 
+} break;
+case 21: {
+ add_hook(yydata, yylen, hook_profile); 
+} break;
+case 22: {
+ add_hook(yydata, yylen, hook_no_backup); 
+} break;
+case 23: {
+ add_hook(yydata, yylen, hook_start_state_defs); 
+} break;
+case 24: {
+ add_hook(yydata, yylen, hook_actions); 
+} break;
+case 25: {
+ add_hook(yydata, yylen, hook_uparam); 
+} break;
+case 26: {
+ add_hook(yydata, yylen, hook_udata); 
+} break;
+case 27: {
+ add_hook(yydata, yylen, hook_has_udata); 
+} break;
+case 28: {
+ add_hook(yydata, yylen, hook_utype); 
+} break;
+case 29: {
+ add_hook(yydata, yylen, hook_yyuparam); 
+} break;
+case 30: {
 
-    fputc(yytext[0], yydata->f);
+    add_text(yydata, yylen);
 
 } break;
 
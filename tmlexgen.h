@@ -28,20 +28,72 @@
 #include "fa.h"
 #endif
 
+#ifndef ML_PHASH_H
+#include "phash.h"
+#endif
+
 typedef struct {
     FILE *f;
     lexer_lexer_state *st;
-    fa_t *dfa;
+    fa_t *dfa;        /* NULL when the lexer is lazy */
+    fa_t *nfa;        /* The NFA (without nil-transitions) a lazy lexer
+                       * builds its DFA from, or NULL */
+    int lazy_cache;   /* Number of DFA states a lazy lexer caches */
+    const char *mlt;  /* The .mlt file the lexer loads its tables from (with
+                       * dfa NULL), or NULL if they're compiled in */
+    int profile;      /* Whether the lexer counts its work (%option profile) */
+    int no_backup;    /* Whether no state of dfa needs backing up from (see
+                       * fa_backup_states) */
     fa_list_t *patterns;
     fa_list_t *start_states;
 } tmpl_state;
 
+/* Writes what a %NAME% in a template stands for, to t->f */
+typedef void (*tmpl_hook_fn)(tmpl_state *t);
+
+/* One step in writing out a template: copying the len bytes of its literal
+ * text from start on, or (if hook isn't NULL) running hook */
+typedef struct {
+    size_t start, len;
+    tmpl_hook_fn hook;
+} tmpl_op_t;
+
+/* A template, parsed once (by the Template lexer) into the steps to write it
+ * out, so it can be written out for a lexer without being parsed again. The
+ * template's contents are kept mapped, and its literal text copied straight
+ * from them: src should be filled in, and lexed all of a piece, after
+ * init_tmpl_prog. */
+typedef struct {
+    file_map_t src;
+    size_t pos; /* How much of src has been lexed */
+    tmpl_op_t *ops;
+    int n_ops, ops_size;
+} tmpl_prog_t;
+
+void init_tmpl_prog(tmpl_prog_t *p);
+void free_tmpl_prog(tmpl_prog_t *p);
+
+/* Writes out the template p for the lexer described by t, to t->f */
+void run_tmpl_prog(const tmpl_prog_t *p, tmpl_state *t);
+
+
+#include <stdlib.h>
 
 typedef struct yy_Template_state Template_state;
 
 Template_state * TemplateInit( void * (*alloc)(size_t),
     void (*unalloc)(void *) );
 void TemplateDestroy( Template_state *lexer );
-int TemplateRead( Template_state *lexer, char *input, size_t len ,  tmpl_state *  data );
+int TemplateRead( Template_state *lexer, char *input, size_t len ,  tmpl_prog_t *  data );
+#if 0 || YY_PROFILE
+#include <stdio.h>
+void TemplateDumpProfile( Template_state *lexer, FILE *f );
+#endif
+#if YY_TRACE
+#include <stdio.h>
+unsigned long long TemplateLatencyPercentile( Template_state *lexer,
+    double p );
+void TemplateDumpLatency( Template_state *lexer, FILE *f );
+#endif
 
 #endif
@@ -15,5 +15,15 @@ typedef struct yy_%PREFIX%_state %PREFIX%_state;
     void (*unalloc)(void *) );
 void %PREFIX%Destroy( %PREFIX%_state *lexer );
 int %PREFIX%Read( %PREFIX%_state *lexer, char *input, size_t len %UPARAM% );
+#if %PROFILE% || YY_PROFILE
+#include <stdio.h>
+void %PREFIX%DumpProfile( %PREFIX%_state *lexer, FILE *f );
+#endif
+#if YY_TRACE
+#include <stdio.h>
+unsigned long long %PREFIX%LatencyPercentile( %PREFIX%_state *lexer,
+    double p );
+void %PREFIX%DumpLatency( %PREFIX%_state *lexer, FILE *f );
+#endif
 
 #endif
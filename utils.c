@@ -11,6 +11,11 @@
 #include <string.h>
 #endif
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 /* Allocate memory or die trying */
 void * malloc_or_die_impl(size_t len, const char *type,
                           const char *fname, int line)
@@ -128,6 +133,106 @@ len_string * lstrcat_buf_impl(const len_string *a, size_t len, const char *buf,
     return ptr;
 }
 
+void strbuf_init(strbuf_t *b)
+{
+    b->str = NULL;
+    b->size = 0;
+}
+
+void strbuf_add_impl(strbuf_t *b, size_t len, const char *buf,
+                     const char *fname, int line)
+{
+    len_string *ptr;
+    size_t used = (b->str != NULL) ? b->str->len : 0, size;
+
+    if(used + len > b->size) {
+        for(size = (b->size > 0) ? 2 * b->size : 64; size < used + len;
+            size *= 2)
+            ;
+
+        ptr = mk_lstring(size, fname, line);
+        if(b->str != NULL) {
+            memcpy(ptr->s, b->str->s, used);
+            free(b->str);
+        }
+        ptr->len = used;
+
+        b->str = ptr;
+        b->size = size;
+    }
+
+    memcpy(b->str->s + used, buf, len);
+    b->str->len += len;
+}
+
+len_string * strbuf_finish_impl(strbuf_t *b, const char *fname, int line)
+{
+    len_string *ptr = (b->str != NULL) ? b->str : mk_lstring(0, fname, line);
+
+    strbuf_init(b);
+    return ptr;
+}
+
+int map_file(file_map_t *m, const char *name)
+{
+    struct stat st;
+    size_t size = 65536;
+    ssize_t n;
+    int fd;
+
+    m->data = NULL;
+    m->len = 0;
+    m->mapped = 0;
+
+    if((fd = open(name, O_RDONLY)) < 0)
+        return 0;
+
+    if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        m->data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(m->data != MAP_FAILED) {
+            m->len = st.st_size;
+            m->mapped = 1;
+            close(fd);
+            return 1;
+        }
+        size = st.st_size + 1;
+    }
+
+    /* Not something that can be mapped; read it in instead */
+    m->data = malloc_or_die(size, char);
+    while((n = read(fd, m->data + m->len, size - m->len)) != 0) {
+        if(n < 0) {
+            free(m->data);
+            m->data = NULL;
+            close(fd);
+            return 0;
+        }
+
+        if((m->len += n) == size) {
+            if((m->data = realloc(m->data, size *= 2)) == NULL) {
+                fputs(__FILE__ ": Can\'t allocate memory to read a file\n",
+                      stderr);
+                exit(1);
+            }
+        }
+    }
+
+    close(fd);
+    return 1;
+}
+
+void unmap_file(file_map_t *m)
+{
+    if(m->mapped)
+        munmap(m->data, m->len);
+    else
+        free(m->data);
+
+    m->data = NULL;
+    m->len = 0;
+    m->mapped = 0;
+}
+
 int lstr_eq(const len_string *a, const len_string *b)
 {
     if(a == NULL || b == NULL)
@@ -172,6 +277,74 @@ int lstr_in_list(const len_string *s, const lstr_list_t *l)
     return 0;
 }
 
+void free_lstr_list(lstr_list_t *l)
+{
+    lstr_list_t *next;
+
+    while(l != NULL) {
+        next = l->next;
+        free(l->s);
+        free(l);
+        l = next;
+    }
+}
+
+/* Alignment of objects allocated from an arena, and the space taken up at
+ * the start of each chunk by its header */
+#define ARENA_ALIGN 16
+#define ARENA_HDR ((sizeof(arena_chunk_t) + ARENA_ALIGN - 1) & \
+                   ~((size_t) ARENA_ALIGN - 1))
+
+arena_t * mk_arena_impl(size_t chunk_size, const char *fname, int line)
+{
+    arena_t *a = mod_2(1, arena_t, fname, line);
+
+    a->chunks = NULL;
+    a->chunk_size = chunk_size;
+    a->total = 0;
+
+    return a;
+}
+
+void * arena_alloc_impl(arena_t *a, size_t len, const char *fname, int line)
+{
+    arena_chunk_t *c = a->chunks;
+    size_t sz;
+    void *ptr;
+
+    len = (len + ARENA_ALIGN - 1) & ~((size_t) ARENA_ALIGN - 1);
+
+    if(c == NULL || c->size - c->used < len) {
+        sz = (len > a->chunk_size) ? len : a->chunk_size;
+
+        /* The chunk header and its memory share one allocation */
+        c = malloc_or_die_impl(ARENA_HDR + sz, "arena_chunk_t", fname, line);
+        c->mem = ((char *) c) + ARENA_HDR;
+        c->size = sz;
+        c->used = 0;
+        c->next = a->chunks;
+        a->chunks = c;
+        a->total += ARENA_HDR + sz;
+    }
+
+    ptr = c->mem + c->used;
+    c->used += len;
+
+    return ptr;
+}
+
+void destroy_arena(arena_t *a)
+{
+    arena_chunk_t *c, *next;
+
+    for(c = a->chunks; c != NULL; c = next) {
+        next = c->next;
+        free(c);
+    }
+
+    free(a);
+}
+
 const char hex_digits[256] = {
     ['0'] = 0, ['1'] = 1, ['2'] = 2, ['3'] = 3, ['4'] = 4,
     ['5'] = 5, ['6'] = 6, ['7'] = 7, ['8'] = 8, ['9'] = 9,
@@ -26,10 +26,10 @@ void * malloc_or_die_impl(size_t len, const char *type,
                           const char *fname, int line);
 
 #define malloc_or_die(n, type) \
-    ((type *) malloc_or_die_impl(n * sizeof(type), #type, __FILE__, __LINE__))
+    ((type *) malloc_or_die_impl((n) * sizeof(type), #type, __FILE__, __LINE__))
 
 #define mod_2(n, type, fname, line) \
-    ((type *) malloc_or_die_impl(n * sizeof(type), #type, fname, line))
+    ((type *) malloc_or_die_impl((n) * sizeof(type), #type, fname, line))
 
 /* A length-prefixed, 8-bit clean string */
 typedef struct {
@@ -82,6 +82,76 @@ void lstr_fwrite(const len_string *lstr, FILE *f);
 /* Returns whether or not s is contained in the list starting with l */
 int lstr_in_list(const len_string *s, const lstr_list_t *l);
 
+/* Frees the list starting with l, and its strings */
+void free_lstr_list(lstr_list_t *l);
+
+/* A len_string being built up by adding text to its end; the room for it
+ * doubles as needed, so building a string of n bytes takes O(n) time
+ * however many pieces it comes in */
+typedef struct {
+    len_string *str; /* The string so far (NULL if nothing's been added) */
+    size_t size;     /* The room in str->s */
+} strbuf_t;
+
+/* Makes b empty */
+void strbuf_init(strbuf_t *b);
+
+/* Adds the len bytes starting with buf to the end of b */
+void strbuf_add_impl(strbuf_t *b, size_t len, const char *buf,
+                     const char *fname, int line);
+
+/* Returns the string built up in b (which can be deallocated by a simple
+ * free()), leaving b empty */
+len_string * strbuf_finish_impl(strbuf_t *b, const char *fname, int line);
+
+#define strbuf_add(b, len, buf) strbuf_add_impl((b), (len), (buf), \
+    __FILE__, __LINE__)
+#define strbuf_finish(b) strbuf_finish_impl((b), __FILE__, __LINE__)
+
+/* The contents of a file, mapped into memory (or, where it can't be, such as
+ * for a pipe, read into it) */
+typedef struct {
+    char *data;
+    size_t len;
+    int mapped; /* Whether data was mapped, rather than malloc'ed */
+} file_map_t;
+
+/* Fills m with the contents of the file name, returning 1, or 0 (with errno
+ * set) if it can't be opened or read. data should not be written to. */
+int map_file(file_map_t *m, const char *name);
+
+/* Frees (or unmaps) the contents m holds */
+void unmap_file(file_map_t *m);
+
+/* An arena: a pool of memory from which many small objects can be allocated
+ * cheaply and then all freed at once */
+typedef struct arena_chunk {
+    struct arena_chunk *next; /* The previously filled chunk */
+    size_t size;              /* Number of bytes available in mem */
+    size_t used;              /* Number of bytes of mem handed out */
+    char *mem;
+} arena_chunk_t;
+
+typedef struct {
+    arena_chunk_t *chunks;  /* The current chunk, followed by older ones */
+    size_t chunk_size;      /* Default size of a new chunk */
+    size_t total;           /* Total bytes allocated from malloc */
+} arena_t;
+
+/* Makes an empty arena that allocates from malloc chunk_size bytes at a time */
+arena_t * mk_arena_impl(size_t chunk_size, const char *fname, int line);
+
+/* Returns len bytes of memory (suitably aligned for any object) from arena a,
+ * or quits the program if it can't */
+void * arena_alloc_impl(arena_t *a, size_t len, const char *fname, int line);
+
+/* Frees arena a and everything allocated from it */
+void destroy_arena(arena_t *a);
+
+#define mk_arena(sz) mk_arena_impl((sz), __FILE__, __LINE__)
+#define arena_alloc(a, n, type) \
+    ((type *) arena_alloc_impl((a), (n) * sizeof(type), __FILE__, __LINE__))
+
 /* A character-to-hexadecimal digit table */
 extern const char hex_digits[256];
 